@@ -0,0 +1,135 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Allocator Microbenchmarks
+ * ============================================================================
+ *
+ * Measures a 64-byte malloc()/free() pair called directly and through
+ * mem_alloc()/mem_free() with no allocator installed, then complete
+ * init/run/free cycles of the sample program and of a 1000-statement
+ * script on a default interpreter and on one given a pass-through
+ * Allocator that forwards to libc. The overhead of each indirection is
+ * printed after them.
+ *
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "interpreter.h"
+#include "allocator.h"
+
+#define ALLOCATOR_BENCH_STATEMENTS 1000
+#define ALLOCATOR_BENCH_BLOCK 64
+
+typedef struct {
+    char* source;
+    const Allocator* allocator;
+} ScriptContext;
+
+static void* forward_alloc(void* context, size_t size);
+static void* forward_realloc(void* context, void* pointer, size_t size);
+static void forward_free(void* context, void* pointer);
+static void run_libc(void* context, size_t operations);
+static void run_mem(void* context, size_t operations);
+static char* build_script(void);
+static void run_script(void* context, size_t operations);
+static void report(const char* name, bool ran, const BenchResult* direct, const BenchResult* routed);
+
+static void* forward_alloc(void* context, size_t size) {
+    (void)context;
+    return malloc(size);
+}
+
+static void* forward_realloc(void* context, void* pointer, size_t size) {
+    (void)context;
+    return realloc(pointer, size);
+}
+
+static void forward_free(void* context, void* pointer) {
+    (void)context;
+    free(pointer);
+}
+
+static void run_libc(void* context, size_t operations) {
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        void* block = malloc(ALLOCATOR_BENCH_BLOCK);
+        bench_keep(block);
+        free(block);
+    }
+}
+
+static void run_mem(void* context, size_t operations) {
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        void* block = mem_alloc(ALLOCATOR_BENCH_BLOCK);
+        bench_keep(block);
+        mem_free(block);
+    }
+}
+
+static char* build_script(void) {
+    char* text = malloc(ALLOCATOR_BENCH_STATEMENTS * 48);
+    if (!text) {
+        return NULL;
+    }
+    size_t used = 0;
+    for (int i = 0; i < ALLOCATOR_BENCH_STATEMENTS / 2; i++) {
+        used += (size_t)sprintf(text + used, i % 2 ? "int v%d = %d;\n" : "string v%d = \"%d\";\n",
+                                i, i);
+    }
+    for (int i = 0; i < ALLOCATOR_BENCH_STATEMENTS / 2; i++) {
+        used += (size_t)sprintf(text + used, i % 2 ? "v%d = %d;\n" : "v%d = \"x%d\";\n", i, i);
+    }
+    return text;
+}
+
+static void run_script(void* context, size_t operations) {
+    ScriptContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter_with_allocator(ctx->allocator);
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, ctx->source);
+        free_interpreter(interp);
+    }
+}
+
+static void report(const char* name, bool ran, const BenchResult* direct, const BenchResult* routed) {
+    if (ran) {
+        printf("allocator: %-16s %+6.2f%% through the indirection\n", name,
+               (routed->ns_per_op / direct->ns_per_op - 1.0) * 100.0);
+    }
+}
+
+void bench_allocator(void) {
+    Allocator forward = {forward_alloc, forward_realloc, forward_free, NULL};
+    BenchResult libc;
+    BenchResult mem;
+    bool ran_libc = bench_run("allocator/alloc_free/libc", run_libc, NULL, &libc);
+    bool ran_mem = bench_run("allocator/alloc_free/mem", run_mem, NULL, &mem);
+    report("alloc+free", ran_libc && ran_mem, &libc, &mem);
+
+    ScriptContext sample = {(char*)bench_sample_program, NULL};
+    BenchResult sample_default;
+    BenchResult sample_vtable;
+    bool ran_default = bench_run("allocator/run/sample_program/default", run_script, &sample,
+                                 &sample_default);
+    sample.allocator = &forward;
+    bool ran_vtable = bench_run("allocator/run/sample_program/vtable", run_script, &sample,
+                                &sample_vtable);
+    report("sample_program", ran_default && ran_vtable, &sample_default, &sample_vtable);
+
+    ScriptContext script = {build_script(), NULL};
+    if (script.source) {
+        BenchResult script_default;
+        BenchResult script_vtable;
+        ran_default = bench_run("allocator/run/1000_statements/default", run_script, &script,
+                                &script_default);
+        script.allocator = &forward;
+        ran_vtable = bench_run("allocator/run/1000_statements/vtable", run_script, &script,
+                               &script_vtable);
+        report("1000_statements", ran_default && ran_vtable, &script_default, &script_vtable);
+    }
+    free(script.source);
+}
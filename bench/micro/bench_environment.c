@@ -0,0 +1,80 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Environment Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures get_variable() and set_variable() (overwrite of an existing
+ * variable) against environments of 16, 256 and 4096 variables, and
+ * get_variable() through a child of a frozen base of the same size.
+ * Lookups cycle through all names so every position in the list is hit.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "environment.h"
+
+typedef struct {
+    Environment* env;
+    char (*names)[32];
+    size_t size;
+    Value* value;
+} EnvironmentContext;
+
+static void run_get_variable(void* context, size_t operations);
+static void run_set_variable(void* context, size_t operations);
+
+static void run_get_variable(void* context, size_t operations) {
+    EnvironmentContext* ctx = context;
+    size_t index = 0;
+    for (size_t i = 0; i < operations; i++) {
+        bench_keep(get_variable(ctx->env, ctx->names[index]));
+        if (++index == ctx->size) {
+            index = 0;
+        }
+    }
+}
+
+static void run_set_variable(void* context, size_t operations) {
+    EnvironmentContext* ctx = context;
+    size_t index = 0;
+    for (size_t i = 0; i < operations; i++) {
+        ctx->value->data.int_val = (int)i;
+        set_variable(ctx->env, ctx->names[index], ctx->value);
+        if (++index == ctx->size) {
+            index = 0;
+        }
+    }
+}
+
+void bench_environment(void) {
+    size_t sizes[] = {16, 256, 4096};
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        EnvironmentContext ctx;
+        ctx.size = sizes[s];
+        ctx.names = malloc(ctx.size * sizeof(*ctx.names));
+        ctx.env = create_env();
+        ctx.value = init_value(TYPE_INT);
+        for (size_t i = 0; i < ctx.size; i++) {
+            snprintf(ctx.names[i], sizeof(ctx.names[i]), "var%zu", i);
+            set_variable(ctx.env, ctx.names[i], ctx.value);
+        }
+        char name[64];
+        snprintf(name, sizeof(name), "environment/get_variable/%zu", ctx.size);
+        bench_run(name, run_get_variable, &ctx, NULL);
+        snprintf(name, sizeof(name), "environment/set_variable/%zu", ctx.size);
+        bench_run(name, run_set_variable, &ctx, NULL);
+
+        Environment* base = ctx.env;
+        freeze_env(base);
+        ctx.env = create_child_env(base);
+        snprintf(name, sizeof(name), "environment/get_variable_frozen/%zu", ctx.size);
+        bench_run(name, run_get_variable, &ctx, NULL);
+        free_env(ctx.env);
+        free_env(base);
+        free_value(ctx.value);
+        free(ctx.names);
+    }
+}
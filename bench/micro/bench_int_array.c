@@ -0,0 +1,158 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Int Array Microbenchmarks
+ * ============================================================================
+ *
+ * Measures a script that keeps 4096 ints, written the way workloads did
+ * before int[N] existed (4096 separately named variables, each declared
+ * and then set) and with one array (declared, then filled), each run on a
+ * fresh interpreter; then the bulk operations alone on a 1 Mi-element
+ * array. The script speedup and the kernel throughputs in GB/s are
+ * printed after them.
+ *
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "interpreter.h"
+#include "int_array.h"
+
+#define ARRAY_BENCH_VARIABLES 4096
+#define ARRAY_BENCH_ELEMENTS (1024 * 1024)
+
+typedef struct {
+    char* separate;
+    char* array;
+    IntArray* items;
+    IntArray* target;
+} ArrayContext;
+
+static char* build_separate(void);
+static char* build_array(void);
+static void run_script(char* source, size_t operations);
+static void run_separate(void* context, size_t operations);
+static void run_array(void* context, size_t operations);
+static void run_fill(void* context, size_t operations);
+static void run_copy(void* context, size_t operations);
+static void run_sum(void* context, size_t operations);
+static void run_min_max(void* context, size_t operations);
+static void report(const char* name, bool ran, const BenchResult* result, size_t bytes);
+
+static char* build_separate(void) {
+    char* text = malloc(ARRAY_BENCH_VARIABLES * 32);
+    if (!text) {
+        return NULL;
+    }
+    size_t used = 0;
+    for (int i = 0; i < ARRAY_BENCH_VARIABLES; i++) {
+        used += (size_t)sprintf(text + used, "int v%d = 0;\n", i);
+    }
+    for (int i = 0; i < ARRAY_BENCH_VARIABLES; i++) {
+        used += (size_t)sprintf(text + used, "v%d = 1;\n", i);
+    }
+    return text;
+}
+
+static char* build_array(void) {
+    char* text = malloc(64);
+    if (text) {
+        sprintf(text, "int[%d] v = 0;\nfill(v, 1);\n", ARRAY_BENCH_VARIABLES);
+    }
+    return text;
+}
+
+static void run_script(char* source, size_t operations) {
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, source);
+        bench_keep(get_variable(interp->global_env, "v"));
+        free_interpreter(interp);
+    }
+}
+
+static void run_separate(void* context, size_t operations) {
+    run_script(((ArrayContext*)context)->separate, operations);
+}
+
+static void run_array(void* context, size_t operations) {
+    run_script(((ArrayContext*)context)->array, operations);
+}
+
+static void run_fill(void* context, size_t operations) {
+    ArrayContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        int_array_fill(ctx->items, (int)i);
+        bench_keep(ctx->items->items);
+    }
+}
+
+static void run_copy(void* context, size_t operations) {
+    ArrayContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        int_array_copy(ctx->target, ctx->items);
+        bench_keep(ctx->target->items);
+    }
+}
+
+static void run_sum(void* context, size_t operations) {
+    ArrayContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        int total = int_array_sum(ctx->items);
+        bench_keep(&total);
+    }
+}
+
+static void run_min_max(void* context, size_t operations) {
+    ArrayContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        int bounds[2] = {int_array_min(ctx->items), int_array_max(ctx->items)};
+        bench_keep(bounds);
+    }
+}
+
+static void report(const char* name, bool ran, const BenchResult* result, size_t bytes) {
+    if (ran) {
+        printf("int_array: %-10s %8.1f GB/s\n", name, bytes / result->ns_per_op);
+    }
+}
+
+void bench_int_array(void) {
+    ArrayContext ctx;
+    ctx.separate = build_separate();
+    ctx.array = build_array();
+    ctx.items = create_int_array(ARRAY_BENCH_ELEMENTS, 0);
+    ctx.target = create_int_array(ARRAY_BENCH_ELEMENTS, 0);
+    if (ctx.separate && ctx.array && ctx.items && ctx.target) {
+        for (size_t i = 0; i < ctx.items->length; i++) {
+            ctx.items->items[i] = (int)((i * 2654435761u) >> 8);
+        }
+        size_t bytes = ARRAY_BENCH_ELEMENTS * sizeof(int);
+        BenchResult separate;
+        BenchResult array;
+        BenchResult fill;
+        BenchResult copy;
+        BenchResult sum;
+        BenchResult min_max;
+        bool ran_separate = bench_run("int_array/run/separate_4096", run_separate, &ctx, &separate);
+        bool ran_array = bench_run("int_array/run/array_4096", run_array, &ctx, &array);
+        bool ran_fill = bench_run("int_array/fill/1Mi", run_fill, &ctx, &fill);
+        bool ran_copy = bench_run("int_array/copy/1Mi", run_copy, &ctx, &copy);
+        bool ran_sum = bench_run("int_array/sum/1Mi", run_sum, &ctx, &sum);
+        bool ran_min_max = bench_run("int_array/min_max/1Mi", run_min_max, &ctx, &min_max);
+        if (ran_separate && ran_array) {
+            printf("int_array: one int[4096] runs %.0fx faster than 4096 variables\n",
+                   separate.ns_per_op / array.ns_per_op);
+        }
+        report("fill", ran_fill, &fill, bytes);
+        report("copy", ran_copy, &copy, 2 * bytes);
+        report("sum", ran_sum, &sum, bytes);
+        report("min+max", ran_min_max, &min_max, 2 * bytes);
+    }
+    free(ctx.separate);
+    free(ctx.array);
+    free_int_array(ctx.items);
+    free_int_array(ctx.target);
+}
@@ -0,0 +1,116 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Interpreter Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures execute_statement() for pre-parsed int and string assignments
+ * (including the echo line, written to /dev/null), a block with two local
+ * variables, and a complete init/run/free cycle of the sample program.
+ * 
+ * The loop cases run 10000 int stores written as `repeat 10000 { ... }`
+ * and unrolled into 10000 statements; both print the same 10000 lines.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suites.h"
+#include "interpreter.h"
+
+#define LOOP_BENCH_ITERATIONS 10000
+
+typedef struct {
+    Interpreter* interp;
+    Statement* stmt;
+} ExecuteContext;
+
+static Statement* parse_one(Interpreter* interp, char* source);
+static void run_execute_statement(void* context, size_t operations);
+static void run_whole_program(void* context, size_t operations);
+static char* build_unrolled(void);
+static void run_script(void* context, size_t operations);
+
+static Statement* parse_one(Interpreter* interp, char* source) {
+    Lexer* lexer = init_lexer(source);
+    Parser* parser = init_parser(lexer, interp->global_env);
+    Statement* stmt = parse_statement(parser);
+    free_parser(parser);
+    free_lexer(lexer);
+    return stmt;
+}
+
+static void run_execute_statement(void* context, size_t operations) {
+    ExecuteContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        execute_statement(ctx->interp, ctx->stmt);
+    }
+}
+
+static void run_whole_program(void* context, size_t operations) {
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, (char*)bench_sample_program);
+        free_interpreter(interp);
+    }
+}
+
+static char* build_unrolled(void) {
+    const char* line = "count = 1;\n";
+    size_t length = strlen(line);
+    char* source = malloc(LOOP_BENCH_ITERATIONS * length + 1);
+    if (!source) {
+        return NULL;
+    }
+    for (size_t i = 0; i < LOOP_BENCH_ITERATIONS; i++) {
+        memcpy(source + i * length, line, length);
+    }
+    source[LOOP_BENCH_ITERATIONS * length] = '\0';
+    return source;
+}
+
+static void run_script(void* context, size_t operations) {
+    char* source = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, (char*)"int count = 0;");
+        run(interp, source);
+        free_interpreter(interp);
+    }
+}
+
+void bench_interpreter(void) {
+    ExecuteContext ctx;
+    ctx.interp = init_interpreter();
+    set_interpreter_output(ctx.interp, bench_null_stream());
+    run(ctx.interp, (char*)bench_sample_program);
+
+    ctx.stmt = parse_one(ctx.interp, "count = 99;");
+    bench_run("interpreter/execute_statement/int", run_execute_statement, &ctx, NULL);
+    free_statement(ctx.stmt);
+    ctx.stmt = parse_one(ctx.interp, "message = \"replacement text\";");
+    bench_run("interpreter/execute_statement/string", run_execute_statement, &ctx, NULL);
+    free_statement(ctx.stmt);
+    ctx.stmt = parse_one(ctx.interp, "{ int a = 1; string b = \"b\"; a = 2; }");
+    bench_run("interpreter/execute_statement/block", run_execute_statement, &ctx, NULL);
+    free_statement(ctx.stmt);
+    free_interpreter(ctx.interp);
+
+    bench_run("interpreter/run/sample_program", run_whole_program, NULL, NULL);
+
+    char loop[64];
+    snprintf(loop, sizeof(loop), "repeat %d { count = 1; }", LOOP_BENCH_ITERATIONS);
+    char* unrolled = build_unrolled();
+    BenchResult looped;
+    BenchResult flat;
+    bool ran = bench_run("interpreter/run/repeat_10000", run_script, loop, &looped);
+    if (unrolled && bench_run("interpreter/run/unrolled_10000", run_script, unrolled, &flat) && ran) {
+        printf("interpreter: repeat %.1f ns per iteration, unrolled %.1f ns per statement\n",
+               looped.ns_per_op / LOOP_BENCH_ITERATIONS, flat.ns_per_op / LOOP_BENCH_ITERATIONS);
+    }
+    free(unrolled);
+}
@@ -0,0 +1,110 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - JIT Engine Microbenchmarks
+ * ============================================================================
+ *
+ * Measures a batch of pre-parsed global int and char assignments run as
+ * compiled code against the same batch dispatched through
+ * execute_statement() (echo lines written to /dev/null), and compiling
+ * the batch. One operation is the whole batch; the statements per second
+ * of both engines are printed after them.
+ *
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "jit.h"
+
+#define JIT_BENCH_STATEMENTS 1024
+
+typedef struct {
+    Interpreter* interp;
+    Statement* statements[JIT_BENCH_STATEMENTS];
+    JitProgram* program;
+} JitContext;
+
+static bool parse_batch(JitContext* ctx);
+static void run_jit_batch(void* context, size_t operations);
+static void run_interpreted_batch(void* context, size_t operations);
+static void run_jit_compile(void* context, size_t operations);
+
+static bool parse_batch(JitContext* ctx) {
+    char source[JIT_BENCH_STATEMENTS * 24];
+    size_t length = 0;
+    for (int i = 0; i < JIT_BENCH_STATEMENTS; i++) {
+        length += (size_t)(i % 4 == 3
+            ? snprintf(source + length, sizeof(source) - length, "letter = '%c';\n", 'a' + i % 26)
+            : snprintf(source + length, sizeof(source) - length, "count = %d;\n", i));
+    }
+    Lexer* lexer = init_lexer(source);
+    Parser* parser = init_parser(lexer, ctx->interp->global_env);
+    bool ok = parser != NULL;
+    for (int i = 0; ok && i < JIT_BENCH_STATEMENTS; i++) {
+        ctx->statements[i] = parse_statement(parser);
+        ok = ctx->statements[i] != NULL;
+    }
+    free_parser(parser);
+    free_lexer(lexer);
+    return ok;
+}
+
+static void run_jit_batch(void* context, size_t operations) {
+    JitContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        jit_execute(ctx->program);
+    }
+}
+
+static void run_interpreted_batch(void* context, size_t operations) {
+    JitContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        for (int j = 0; j < JIT_BENCH_STATEMENTS; j++) {
+            execute_statement(ctx->interp, ctx->statements[j]);
+        }
+    }
+}
+
+static void run_jit_compile(void* context, size_t operations) {
+    JitContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        JitProgram* program = jit_compile(ctx->interp, ctx->statements, JIT_BENCH_STATEMENTS);
+        bench_keep(program);
+        free_jit_program(program);
+    }
+}
+
+void bench_jit(void) {
+    char reason[128];
+    if (!jit_available(NULL, reason, sizeof(reason))) {
+        printf("jit: skipped (%s)\n", reason);
+        return;
+    }
+    JitContext* ctx = calloc(1, sizeof(JitContext));
+    if (!ctx) {
+        return;
+    }
+    ctx->interp = init_interpreter();
+    set_interpreter_output(ctx->interp, bench_null_stream());
+    run(ctx->interp, (char*)"int count = 0; char letter = 'a';");
+    if (parse_batch(ctx) && (ctx->program = jit_compile(ctx->interp, ctx->statements, JIT_BENCH_STATEMENTS))) {
+        BenchResult jit;
+        BenchResult interpreted;
+        bool ran_jit = bench_run("jit/execute/assignments_1024", run_jit_batch, ctx, &jit);
+        bool ran_interpreted = bench_run("jit/interpreter/assignments_1024", run_interpreted_batch,
+                                         ctx, &interpreted);
+        bench_run("jit/compile/assignments_1024", run_jit_compile, ctx, NULL);
+        if (ran_jit && ran_interpreted) {
+            printf("jit: %.1fM statements/s compiled, %.1fM statements/s interpreted\n",
+                   JIT_BENCH_STATEMENTS * 1e3 / jit.ns_per_op,
+                   JIT_BENCH_STATEMENTS * 1e3 / interpreted.ns_per_op);
+        }
+    }
+    free_jit_program(ctx->program);
+    for (int i = 0; i < JIT_BENCH_STATEMENTS; i++) {
+        free_statement(ctx->statements[i]);
+    }
+    free_interpreter(ctx->interp);
+    free(ctx);
+}
@@ -0,0 +1,83 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Lexer Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures next_token() (heap Token per call), the allocation-free
+ * scan_lexeme() core, and read_string() for short and long literals.
+ * Token streams restart from the beginning of the sample at EOF.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suites.h"
+#include "lexer.h"
+
+static void rewind_lexer(Lexer* lexer);
+static void run_next_token(void* context, size_t operations);
+static void run_scan_lexeme(void* context, size_t operations);
+static void run_read_string(void* context, size_t operations);
+
+static void rewind_lexer(Lexer* lexer) {
+    lexer->position = 0;
+}
+
+static void run_next_token(void* context, size_t operations) {
+    Lexer* lexer = context;
+    for (size_t i = 0; i < operations; i++) {
+        Token* token = next_token(lexer);
+        if (token->type == TOKEN_EOF) {
+            rewind_lexer(lexer);
+        }
+        bench_keep(token);
+        free_token(token);
+    }
+}
+
+static void run_scan_lexeme(void* context, size_t operations) {
+    Lexer* lexer = context;
+    Lexeme lexeme;
+    for (size_t i = 0; i < operations; i++) {
+        scan_lexeme(lexer, &lexeme);
+        if (lexeme.type == TOKEN_EOF) {
+            rewind_lexer(lexer);
+        }
+        bench_keep(&lexeme);
+    }
+}
+
+static void run_read_string(void* context, size_t operations) {
+    Lexer* lexer = context;
+    for (size_t i = 0; i < operations; i++) {
+        rewind_lexer(lexer);
+        char* value = read_string(lexer);
+        bench_keep(value);
+        free(value);
+    }
+}
+
+void bench_lexer(void) {
+    Lexer* lexer = init_lexer((char*)bench_sample_program);
+    bench_run("lexer/next_token", run_next_token, lexer, NULL);
+    rewind_lexer(lexer);
+    bench_run("lexer/scan_lexeme", run_scan_lexeme, lexer, NULL);
+    free_lexer(lexer);
+
+    size_t lengths[] = {16, 256, 1000};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        char* literal = malloc(lengths[i] + 3);
+        literal[0] = '"';
+        memset(literal + 1, 'x', lengths[i]);
+        literal[lengths[i] + 1] = '"';
+        literal[lengths[i] + 2] = '\0';
+        char name[64];
+        snprintf(name, sizeof(name), "lexer/read_string/%zuB", lengths[i]);
+        lexer = init_lexer(literal);
+        bench_run(name, run_read_string, lexer, NULL);
+        free_lexer(lexer);
+        free(literal);
+    }
+}
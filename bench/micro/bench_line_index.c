@@ -0,0 +1,65 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Line Index Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures the newline scan that builds a LineIndex (reported per source
+ * byte) and offset-to-position lookups on an index already built.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suites.h"
+#include "line_index.h"
+
+typedef struct {
+    char* source;
+    size_t length;
+    LineIndex* index;
+} LineIndexContext;
+
+static void run_build(void* context, size_t operations);
+static void run_position(void* context, size_t operations);
+
+static void run_build(void* context, size_t operations) {
+    LineIndexContext* ctx = context;
+    size_t bytes = 0;
+    while (bytes < operations) {
+        LineIndex* index = create_line_index(ctx->source);
+        int line = line_index_line(index, ctx->length);
+        bench_keep(&line);
+        free_line_index(index);
+        bytes += ctx->length;
+    }
+}
+
+static void run_position(void* context, size_t operations) {
+    LineIndexContext* ctx = context;
+    int line;
+    int column;
+    for (size_t i = 0; i < operations; i++) {
+        line_index_position(ctx->index, (i * 7919) % ctx->length, &line, &column);
+        bench_keep(&line);
+    }
+}
+
+void bench_line_index(void) {
+    LineIndexContext ctx;
+    size_t sample_length = strlen(bench_sample_program);
+    size_t copies = 64;
+    ctx.length = sample_length * copies;
+    ctx.source = malloc(ctx.length + 1);
+    for (size_t i = 0; i < copies; i++) {
+        memcpy(ctx.source + i * sample_length, bench_sample_program, sample_length);
+    }
+    ctx.source[ctx.length] = '\0';
+    ctx.index = create_line_index(ctx.source);
+    line_index_line(ctx.index, ctx.length);
+    bench_run("line_index/build/per_byte", run_build, &ctx, NULL);
+    bench_run("line_index/position/binary_search", run_position, &ctx, NULL);
+    free_line_index(ctx.index);
+    free(ctx.source);
+}
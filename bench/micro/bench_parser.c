@@ -0,0 +1,85 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Parser Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures parse_statement() plus free_statement() per statement, both on
+ * the streaming lexer path and on a pre-tokenized TokenBuffer, so the two
+ * front ends can be compared. Assignments resolve against an environment
+ * in which the sample program has already run.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suites.h"
+#include "interpreter.h"
+
+#define SAMPLE_REPEATS 64
+
+typedef struct {
+    char* source;
+    Lexer* lexer;
+    Parser* parser;
+    TokenBuffer* tokens;
+    Environment* env;
+} ParserContext;
+
+static void restart_parser(ParserContext* ctx);
+static void run_parse_statement(void* context, size_t operations);
+
+static void restart_parser(ParserContext* ctx) {
+    if (ctx->tokens) {
+        ctx->parser->token_index = 0;
+        token_buffer_fill(ctx->tokens, 0, &ctx->parser->buffered_token);
+        return;
+    }
+    free_parser(ctx->parser);
+    free_lexer(ctx->lexer);
+    ctx->lexer = init_lexer(ctx->source);
+    ctx->parser = init_parser(ctx->lexer, ctx->env);
+}
+
+static void run_parse_statement(void* context, size_t operations) {
+    ParserContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        if (ctx->parser->current_token->type == TOKEN_EOF) {
+            restart_parser(ctx);
+        }
+        Statement* stmt = parse_statement(ctx->parser);
+        bench_keep(stmt);
+        free_statement(stmt);
+    }
+}
+
+void bench_parser(void) {
+    size_t sample_length = strlen(bench_sample_program);
+    ParserContext ctx;
+    ctx.source = malloc(sample_length * SAMPLE_REPEATS + 1);
+    for (size_t i = 0; i < SAMPLE_REPEATS; i++) {
+        memcpy(ctx.source + i * sample_length, bench_sample_program, sample_length);
+    }
+    ctx.source[sample_length * SAMPLE_REPEATS] = '\0';
+    Interpreter* interp = init_interpreter();
+    set_interpreter_output(interp, bench_null_stream());
+    run(interp, (char*)bench_sample_program);
+    ctx.env = interp->global_env;
+
+    ctx.tokens = NULL;
+    ctx.lexer = init_lexer(ctx.source);
+    ctx.parser = init_parser(ctx.lexer, ctx.env);
+    bench_run("parser/parse_statement/streaming", run_parse_statement, &ctx, NULL);
+    free_parser(ctx.parser);
+
+    ctx.tokens = tokenize_source(ctx.lexer);
+    ctx.parser = init_parser_buffered(ctx.tokens, ctx.env);
+    bench_run("parser/parse_statement/token_buffer", run_parse_statement, &ctx, NULL);
+    free_parser(ctx.parser);
+    free_token_buffer(ctx.tokens);
+    free_lexer(ctx.lexer);
+
+    free_interpreter(interp);
+    free(ctx.source);
+}
@@ -0,0 +1,112 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Query Microbenchmarks
+ * ============================================================================
+ *
+ * Measures answering the final values of two variables of a generated
+ * 1 MiB script of int and string assignments with occasional blocks:
+ * executing it with run(), and run_query() both from the statement index
+ * and forced onto its full-execution fallback (by an interpreter that
+ * already holds a variable). One operation is one answer on a fresh
+ * interpreter. The speedup of the index over run() is printed after them.
+ *
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "query.h"
+
+#define QUERY_BENCH_BYTES (1024 * 1024)
+#define QUERY_BENCH_VARIABLES 64
+
+typedef struct {
+    char* source;
+    Query* query;
+} QueryContext;
+
+static char* build_script(void);
+static void run_full(void* context, size_t operations);
+static void run_indexed(void* context, size_t operations);
+static void run_fallback(void* context, size_t operations);
+
+static char* build_script(void) {
+    char* text = malloc(QUERY_BENCH_BYTES + 128);
+    if (!text) {
+        return NULL;
+    }
+    size_t used = 0;
+    for (int i = 0; i < QUERY_BENCH_VARIABLES; i++) {
+        used += (size_t)sprintf(text + used, "int v%d = %d;\n", i, i);
+    }
+    used += (size_t)sprintf(text + used, "string label = \"start\";\n");
+    unsigned seed = 12345;
+    for (int i = 0; used < QUERY_BENCH_BYTES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned variable = (seed >> 8) % QUERY_BENCH_VARIABLES;
+        if (i % 64 == 63) {
+            used += (size_t)sprintf(text + used, "{ int v%u = 1; v%u = %u; label = \"block %u\"; }\n",
+                                    variable, variable, seed >> 16, seed >> 16);
+        } else if (i % 8 == 7) {
+            used += (size_t)sprintf(text + used, "label = \"item %u\";\n", seed >> 16);
+        } else {
+            used += (size_t)sprintf(text + used, "v%u = %u;\n", variable, seed >> 16);
+        }
+    }
+    return text;
+}
+
+static void run_full(void* context, size_t operations) {
+    QueryContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, ctx->source);
+        bench_keep(get_variable(interp->global_env, "v7"));
+        free_interpreter(interp);
+    }
+}
+
+static void run_indexed(void* context, size_t operations) {
+    QueryContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        run_query(interp, ctx->query, ctx->source);
+        bench_keep(get_variable(interp->global_env, "v7"));
+        free_interpreter(interp);
+    }
+}
+
+static void run_fallback(void* context, size_t operations) {
+    QueryContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, (char*)"int unrelated = 0;");
+        run_query(interp, ctx->query, ctx->source);
+        bench_keep(get_variable(interp->global_env, "v7"));
+        free_interpreter(interp);
+    }
+}
+
+void bench_query(void) {
+    QueryContext ctx;
+    ctx.source = build_script();
+    ctx.query = create_query("v7,label");
+    if (!ctx.source || !ctx.query) {
+        free(ctx.source);
+        free_query(ctx.query);
+        return;
+    }
+    BenchResult full;
+    BenchResult indexed;
+    bool ran_full = bench_run("query/run/1MiB", run_full, &ctx, &full);
+    bool ran_indexed = bench_run("query/indexed/1MiB", run_indexed, &ctx, &indexed);
+    bench_run("query/fallback/1MiB", run_fallback, &ctx, NULL);
+    if (ran_full && ran_indexed) {
+        printf("query: index answers %.1fx faster than run()\n", full.ns_per_op / indexed.ns_per_op);
+    }
+    free_query(ctx.query);
+    free(ctx.source);
+}
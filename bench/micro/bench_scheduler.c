@@ -0,0 +1,207 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Scheduler Microbenchmarks
+ * ============================================================================
+ *
+ * Measures eight scripts of 2048 assignments run one after the other with
+ * run() against the same scripts interleaved by the round-robin scheduler
+ * with slices of 64 statements, 1 statement and 50 microseconds. One
+ * operation is all eight scripts.
+ *
+ * After them, one timed pass per policy reports latency and fairness: the
+ * longest slice, the longest any script waited between two of its slices
+ * (or before its first one), and Jain's fairness index of the statements
+ * each script had executed when the first one finished (1.0 is perfectly
+ * even progress, 1/8 is one script at a time).
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "suites.h"
+#include "scheduler.h"
+
+#define SCHEDULER_BENCH_SCRIPTS 8
+#define SCHEDULER_BENCH_STATEMENTS 2048
+
+typedef struct {
+    Interpreter* interps[SCHEDULER_BENCH_SCRIPTS];
+    char* source;
+    StepBudget slice;
+} SchedulerContext;
+
+typedef struct {
+    double longest_slice;
+    double longest_wait;
+    double fairness;
+} SchedulerReport;
+
+static double now_us(void);
+static char* build_script(void);
+static void run_serial(void* context, size_t operations);
+static void run_round_robin(void* context, size_t operations);
+static double jain_index(SchedulerContext* ctx, const int* before);
+static void measure_serial(SchedulerContext* ctx, SchedulerReport* report);
+static void measure_round_robin(SchedulerContext* ctx, SchedulerReport* report);
+static void print_report(const char* policy, const SchedulerReport* report);
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e6 + (double)ts.tv_nsec / 1e3;
+}
+
+static char* build_script(void) {
+    size_t size = SCHEDULER_BENCH_STATEMENTS * 16;
+    char* source = malloc(size);
+    if (!source) {
+        return NULL;
+    }
+    size_t length = 0;
+    for (int i = 0; i < SCHEDULER_BENCH_STATEMENTS; i++) {
+        length += (size_t)snprintf(source + length, size - length, "count = %d;\n", i);
+    }
+    return source;
+}
+
+static void run_serial(void* context, size_t operations) {
+    SchedulerContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        for (int j = 0; j < SCHEDULER_BENCH_SCRIPTS; j++) {
+            run(ctx->interps[j], ctx->source);
+        }
+    }
+}
+
+static void run_round_robin(void* context, size_t operations) {
+    SchedulerContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Scheduler* scheduler = create_scheduler(ctx->slice);
+        for (int j = 0; j < SCHEDULER_BENCH_SCRIPTS; j++) {
+            scheduler_add(scheduler, ctx->interps[j], ctx->source);
+        }
+        scheduler_run(scheduler);
+        free_scheduler(scheduler);
+    }
+}
+
+static double jain_index(SchedulerContext* ctx, const int* before) {
+    double sum = 0.0;
+    double squares = 0.0;
+    for (int i = 0; i < SCHEDULER_BENCH_SCRIPTS; i++) {
+        double progress = ctx->interps[i]->executed_statements - before[i];
+        sum += progress;
+        squares += progress * progress;
+    }
+    return squares > 0.0 ? sum * sum / (SCHEDULER_BENCH_SCRIPTS * squares) : 0.0;
+}
+
+static void measure_serial(SchedulerContext* ctx, SchedulerReport* report) {
+    int before[SCHEDULER_BENCH_SCRIPTS];
+    for (int i = 0; i < SCHEDULER_BENCH_SCRIPTS; i++) {
+        before[i] = ctx->interps[i]->executed_statements;
+    }
+    report->longest_slice = 0.0;
+    report->fairness = 0.0;
+    double origin = now_us();
+    double started = origin;
+    for (int i = 0; i < SCHEDULER_BENCH_SCRIPTS; i++) {
+        started = now_us();
+        run(ctx->interps[i], ctx->source);
+        double elapsed = now_us() - started;
+        if (elapsed > report->longest_slice) {
+            report->longest_slice = elapsed;
+        }
+        if (i == 0) {
+            report->fairness = jain_index(ctx, before);
+        }
+    }
+    report->longest_wait = started - origin;
+}
+
+static void measure_round_robin(SchedulerContext* ctx, SchedulerReport* report) {
+    int before[SCHEDULER_BENCH_SCRIPTS];
+    double last[SCHEDULER_BENCH_SCRIPTS];
+    Scheduler* scheduler = create_scheduler(ctx->slice);
+    double origin = now_us();
+    for (int i = 0; i < SCHEDULER_BENCH_SCRIPTS; i++) {
+        before[i] = ctx->interps[i]->executed_statements;
+        last[i] = origin;
+        scheduler_add(scheduler, ctx->interps[i], ctx->source);
+    }
+    report->longest_slice = 0.0;
+    report->longest_wait = 0.0;
+    report->fairness = 0.0;
+    for (;;) {
+        double started = now_us();
+        Interpreter* interp = scheduler_tick(scheduler);
+        double finished = now_us();
+        if (!interp) {
+            break;
+        }
+        int index = 0;
+        while (ctx->interps[index] != interp) {
+            index++;
+        }
+        if (finished - started > report->longest_slice) {
+            report->longest_slice = finished - started;
+        }
+        if (started - last[index] > report->longest_wait) {
+            report->longest_wait = started - last[index];
+        }
+        last[index] = finished;
+        if (report->fairness == 0.0 && scheduler_pending(scheduler) < SCHEDULER_BENCH_SCRIPTS) {
+            report->fairness = jain_index(ctx, before);
+        }
+    }
+    free_scheduler(scheduler);
+}
+
+static void print_report(const char* policy, const SchedulerReport* report) {
+    printf("scheduler: %-22s longest slice %9.1f us, longest wait %9.1f us, fairness %.3f\n",
+           policy, report->longest_slice, report->longest_wait, report->fairness);
+}
+
+void bench_scheduler(void) {
+    SchedulerContext ctx;
+    ctx.source = build_script();
+    if (!ctx.source) {
+        return;
+    }
+    for (int i = 0; i < SCHEDULER_BENCH_SCRIPTS; i++) {
+        ctx.interps[i] = init_interpreter();
+        set_interpreter_output(ctx.interps[i], bench_null_stream());
+        run(ctx.interps[i], (char*)"int count = 0;");
+    }
+
+    bool ran = bench_run("scheduler/serial/8x2048", run_serial, &ctx, NULL);
+    ctx.slice = (StepBudget){64, 0};
+    ran = bench_run("scheduler/round_robin/8x2048/64_statements", run_round_robin, &ctx, NULL) || ran;
+    ctx.slice = (StepBudget){1, 0};
+    ran = bench_run("scheduler/round_robin/8x2048/1_statement", run_round_robin, &ctx, NULL) || ran;
+    ctx.slice = (StepBudget){0, 50};
+    ran = bench_run("scheduler/round_robin/8x2048/50_us", run_round_robin, &ctx, NULL) || ran;
+
+    if (ran) {
+        SchedulerReport report;
+        measure_serial(&ctx, &report);
+        print_report("serial", &report);
+        ctx.slice = (StepBudget){64, 0};
+        measure_round_robin(&ctx, &report);
+        print_report("64 statements", &report);
+        ctx.slice = (StepBudget){1, 0};
+        measure_round_robin(&ctx, &report);
+        print_report("1 statement", &report);
+        ctx.slice = (StepBudget){0, 50};
+        measure_round_robin(&ctx, &report);
+        print_report("50 us", &report);
+    }
+
+    for (int i = 0; i < SCHEDULER_BENCH_SCRIPTS; i++) {
+        free_interpreter(ctx.interps[i]);
+    }
+    free(ctx.source);
+}
@@ -0,0 +1,52 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Block Scope Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures entering and leaving a block frame on the value stack and
+ * parse-time resolution of a name through a nested scope table.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "scope.h"
+
+static void run_push_pop(void* context, size_t operations);
+static void run_resolve(void* context, size_t operations);
+
+static void run_push_pop(void* context, size_t operations) {
+    ValueStack* stack = context;
+    for (size_t i = 0; i < operations; i++) {
+        push_frame(stack, 8);
+        frame_slot(stack, stack->depth, 3)->data.int_val = (int)i;
+        pop_frame(stack);
+    }
+}
+
+static void run_resolve(void* context, size_t operations) {
+    ScopeTable* table = context;
+    for (size_t i = 0; i < operations; i++) {
+        bench_keep(scope_resolve(table, "local0"));
+    }
+}
+
+void bench_scope(void) {
+    ValueStack* stack = create_value_stack();
+    bench_run("scope/push_pop_frame/8", run_push_pop, stack, NULL);
+    free_value_stack(stack);
+
+    ScopeTable* table = create_scope_table();
+    char name[32];
+    for (int depth = 0; depth < 4; depth++) {
+        scope_enter(table);
+        for (int i = 0; i < 8; i++) {
+            snprintf(name, sizeof(name), "local%d", depth * 8 + i);
+            scope_declare(table, name, TYPE_INT);
+        }
+    }
+    bench_run("scope/scope_resolve/32", run_resolve, table, NULL);
+    free_scope_table(table);
+}
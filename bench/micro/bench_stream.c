@@ -0,0 +1,238 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Streaming Input Microbenchmarks
+ * ============================================================================
+ *
+ * Measures a generated 1 MiB script of int and string assignments executed
+ * from disk: read whole with read_file() then run(), streamed from the
+ * plain file, and streamed from its gzip and zstd archives (each when the
+ * build supports it), plus decompression alone. One operation is the whole
+ * script on a fresh interpreter; the throughput of each variant in MB/s of
+ * decompressed text and the compression ratios are printed after them.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "suites.h"
+#include "stream.h"
+#include "utils.h"
+
+#if defined(HAVE_ZLIB)
+    #include <zlib.h>
+#endif
+#if defined(HAVE_ZSTD)
+    #include <zstd.h>
+#endif
+
+#define STREAM_BENCH_BYTES (1024 * 1024)
+#define STREAM_BENCH_VARIABLES 64
+
+typedef struct {
+    char plain[48];
+    char gzip[48];
+    char zstd[48];
+    char* text;
+    size_t length;
+    const char* path;
+} StreamContext;
+
+static char* build_script(size_t* length);
+static bool write_file(char* path, const char* suffix, const void* data, size_t size);
+static bool write_gzip(StreamContext* ctx);
+static bool write_zstd(StreamContext* ctx);
+static void run_read_file(void* context, size_t operations);
+static void run_streamed_file(void* context, size_t operations);
+static void run_decompress(void* context, size_t operations);
+static long file_size(const char* path);
+static void report(const char* name, bool ran, const BenchResult* result, size_t length);
+
+static char* build_script(size_t* length) {
+    char* text = malloc(STREAM_BENCH_BYTES + 64);
+    if (!text) {
+        return NULL;
+    }
+    size_t used = 0;
+    for (int i = 0; i < STREAM_BENCH_VARIABLES; i++) {
+        used += (size_t)sprintf(text + used, "int v%d = %d;\n", i, i);
+    }
+    used += (size_t)sprintf(text + used, "string label = \"start\";\n");
+    unsigned seed = 12345;
+    for (int i = 0; used < STREAM_BENCH_BYTES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        if (i % 8 == 7) {
+            used += (size_t)sprintf(text + used, "label = \"item %u\";\n", seed >> 16);
+        } else {
+            used += (size_t)sprintf(text + used, "v%u = %u;\n", (seed >> 8) % STREAM_BENCH_VARIABLES,
+                                    seed >> 16);
+        }
+    }
+    *length = used;
+    return text;
+}
+
+static bool write_file(char* path, const char* suffix, const void* data, size_t size) {
+    snprintf(path, 48, "/tmp/pong-bench-XXXXXX%s", suffix);
+    int fd = mkstemps(path, (int)strlen(suffix));
+    if (fd < 0) {
+        path[0] = '\0';
+        return false;
+    }
+    bool written = write(fd, data, size) == (ssize_t)size;
+    close(fd);
+    return written;
+}
+
+static bool write_gzip(StreamContext* ctx) {
+#if defined(HAVE_ZLIB)
+    uLongf size = compressBound((uLong)ctx->length) + 32;
+    unsigned char* packed = malloc(size);
+    z_stream zlib;
+    memset(&zlib, 0, sizeof(zlib));
+    bool ok = packed && deflateInit2(&zlib, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8,
+                                     Z_DEFAULT_STRATEGY) == Z_OK;
+    if (ok) {
+        zlib.next_in = (Bytef*)ctx->text;
+        zlib.avail_in = (uInt)ctx->length;
+        zlib.next_out = packed;
+        zlib.avail_out = (uInt)size;
+        ok = deflate(&zlib, Z_FINISH) == Z_STREAM_END &&
+             write_file(ctx->gzip, ".pong.gz", packed, zlib.total_out);
+        deflateEnd(&zlib);
+    }
+    free(packed);
+    return ok;
+#else
+    (void)ctx;
+    return false;
+#endif
+}
+
+static bool write_zstd(StreamContext* ctx) {
+#if defined(HAVE_ZSTD)
+    size_t size = ZSTD_compressBound(ctx->length);
+    void* packed = malloc(size);
+    size_t packed_size = packed ? ZSTD_compress(packed, size, ctx->text, ctx->length, 3) : 0;
+    bool ok = packed && !ZSTD_isError(packed_size) &&
+              write_file(ctx->zstd, ".pong.zst", packed, packed_size);
+    free(packed);
+    return ok;
+#else
+    (void)ctx;
+    return false;
+#endif
+}
+
+static void run_read_file(void* context, size_t operations) {
+    StreamContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        char* source = read_file(ctx->plain);
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, source);
+        free_interpreter(interp);
+        free(source);
+    }
+}
+
+static void run_streamed_file(void* context, size_t operations) {
+    StreamContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run_streamed(interp, ctx->path);
+        free_interpreter(interp);
+    }
+}
+
+static void run_decompress(void* context, size_t operations) {
+    StreamContext* ctx = context;
+    static char buffer[STREAM_WINDOW];
+    for (size_t i = 0; i < operations; i++) {
+        SourceStream* stream = open_source_stream(ctx->path);
+        size_t produced = 1;
+        while (produced > 0 && read_source_stream(stream, buffer, sizeof(buffer), &produced)) {
+            bench_keep(buffer);
+        }
+        close_source_stream(stream);
+    }
+}
+
+static long file_size(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fclose(file);
+    return size;
+}
+
+static void report(const char* name, bool ran, const BenchResult* result, size_t length) {
+    if (ran) {
+        printf("stream: %-28s %8.1f MB/s\n", name, length / result->ns_per_op * 1e3);
+    }
+}
+
+void bench_stream(void) {
+    StreamContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.text = build_script(&ctx.length);
+    if (!ctx.text || !write_file(ctx.plain, ".pong", ctx.text, ctx.length)) {
+        free(ctx.text);
+        return;
+    }
+    bool has_gzip = write_gzip(&ctx);
+    bool has_zstd = write_zstd(&ctx);
+
+    BenchResult read_whole;
+    BenchResult plain;
+    BenchResult gzip;
+    BenchResult zstd;
+    BenchResult gzip_only;
+    BenchResult zstd_only;
+    bool ran_read_whole = bench_run("stream/read_file_run/plain_1MiB", run_read_file, &ctx, &read_whole);
+    ctx.path = ctx.plain;
+    bool ran_plain = bench_run("stream/run_streamed/plain_1MiB", run_streamed_file, &ctx, &plain);
+    bool ran_gzip = false;
+    bool ran_gzip_only = false;
+    if (has_gzip) {
+        ctx.path = ctx.gzip;
+        ran_gzip = bench_run("stream/run_streamed/gzip_1MiB", run_streamed_file, &ctx, &gzip);
+        ran_gzip_only = bench_run("stream/decompress/gzip_1MiB", run_decompress, &ctx, &gzip_only);
+    }
+    bool ran_zstd = false;
+    bool ran_zstd_only = false;
+    if (has_zstd) {
+        ctx.path = ctx.zstd;
+        ran_zstd = bench_run("stream/run_streamed/zstd_1MiB", run_streamed_file, &ctx, &zstd);
+        ran_zstd_only = bench_run("stream/decompress/zstd_1MiB", run_decompress, &ctx, &zstd_only);
+    }
+
+    report("read_file + run", ran_read_whole, &read_whole, ctx.length);
+    report("streamed plain", ran_plain, &plain, ctx.length);
+    report("streamed gzip", ran_gzip, &gzip, ctx.length);
+    report("decompress gzip", ran_gzip_only, &gzip_only, ctx.length);
+    report("streamed zstd", ran_zstd, &zstd, ctx.length);
+    report("decompress zstd", ran_zstd_only, &zstd_only, ctx.length);
+    if (has_gzip && (ran_gzip || ran_gzip_only)) {
+        printf("stream: gzip ratio %.1fx\n", (double)ctx.length / (double)file_size(ctx.gzip));
+    }
+    if (has_zstd && (ran_zstd || ran_zstd_only)) {
+        printf("stream: zstd ratio %.1fx\n", (double)ctx.length / (double)file_size(ctx.zstd));
+    }
+
+    remove(ctx.plain);
+    if (has_gzip) {
+        remove(ctx.gzip);
+    }
+    if (has_zstd) {
+        remove(ctx.zstd);
+    }
+    free(ctx.text);
+}
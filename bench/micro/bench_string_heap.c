@@ -0,0 +1,190 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - String Heap Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures allocate/release pairs on the string heap against strdup/free
+ * for a short and a long string, and in-place reassignment of a string of
+ * the same size class, which is the common path of string assignments.
+ *
+ * Then builds one string from 100-byte pieces: 1 MiB by appending and by
+ * rebuilding the whole string for every piece (what `s = s + "..."` cost
+ * before appends grew in place), then 100 MiB by appending, directly on
+ * the heap and through a `repeat` loop run by a fresh interpreter. The
+ * speedup at 1 MiB and the 100 MiB throughputs are printed after them.
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suites.h"
+#include "string_heap.h"
+#include "interpreter.h"
+
+#define CONCAT_PIECE 100
+#define CONCAT_SMALL_PIECES (1024 * 1024 / CONCAT_PIECE)
+#define CONCAT_LARGE_PIECES (100 * 1024 * 1024 / CONCAT_PIECE)
+
+typedef struct {
+    StringHeap* heap;
+    const char* text;
+    size_t length;
+} StringHeapContext;
+
+typedef struct {
+    StringHeap* heap;
+    char piece[CONCAT_PIECE + 1];
+    char* script;
+} ConcatContext;
+
+static void run_heap_alloc(void* context, size_t operations);
+static void run_malloc_alloc(void* context, size_t operations);
+static void run_heap_assign(void* context, size_t operations);
+static void build_by_append(ConcatContext* ctx, size_t pieces);
+static void run_append_small(void* context, size_t operations);
+static void run_rebuild_small(void* context, size_t operations);
+static void run_append_large(void* context, size_t operations);
+static void run_concat_script(void* context, size_t operations);
+static void bench_concat(void);
+
+static void run_heap_alloc(void* context, size_t operations) {
+    StringHeapContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        char* string = string_heap_alloc(ctx->heap, ctx->text, ctx->length);
+        bench_keep(string);
+        string_heap_release(string);
+    }
+}
+
+static void run_malloc_alloc(void* context, size_t operations) {
+    StringHeapContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        char* string = strndup(ctx->text, ctx->length);
+        bench_keep(string);
+        free(string);
+    }
+}
+
+static void run_heap_assign(void* context, size_t operations) {
+    StringHeapContext* ctx = context;
+    char* string = string_heap_alloc(ctx->heap, ctx->text, ctx->length);
+    for (size_t i = 0; i < operations; i++) {
+        size_t length = ctx->length - (i & 3);
+        string = string_heap_assign(ctx->heap, string, ctx->text, length);
+        bench_keep(string);
+    }
+    string_heap_release(string);
+}
+
+static void build_by_append(ConcatContext* ctx, size_t pieces) {
+    char* string = string_heap_alloc(ctx->heap, "", 0);
+    for (size_t i = 0; i < pieces && string; i++) {
+        string = string_heap_append(ctx->heap, string, ctx->piece, CONCAT_PIECE);
+    }
+    bench_keep(string);
+    string_heap_release(string);
+}
+
+static void run_append_small(void* context, size_t operations) {
+    for (size_t i = 0; i < operations; i++) {
+        build_by_append(context, CONCAT_SMALL_PIECES);
+    }
+}
+
+/*
+ * Every piece copies the whole string into a new one, as assigning the
+ * joined text did.
+ */
+static void run_rebuild_small(void* context, size_t operations) {
+    ConcatContext* ctx = context;
+    char* joined = malloc(CONCAT_SMALL_PIECES * CONCAT_PIECE + 1);
+    if (!joined) {
+        return;
+    }
+    for (size_t i = 0; i < operations; i++) {
+        char* string = string_heap_alloc(ctx->heap, "", 0);
+        for (size_t piece = 0; piece < CONCAT_SMALL_PIECES && string; piece++) {
+            size_t length = string_heap_length(string);
+            memcpy(joined, string, length);
+            memcpy(joined + length, ctx->piece, CONCAT_PIECE);
+            string = string_heap_assign(ctx->heap, string, joined, length + CONCAT_PIECE);
+        }
+        bench_keep(string);
+        string_heap_release(string);
+    }
+    free(joined);
+}
+
+static void run_append_large(void* context, size_t operations) {
+    for (size_t i = 0; i < operations; i++) {
+        build_by_append(context, CONCAT_LARGE_PIECES);
+    }
+}
+
+static void run_concat_script(void* context, size_t operations) {
+    ConcatContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        Interpreter* interp = init_interpreter();
+        set_interpreter_output(interp, bench_null_stream());
+        run(interp, ctx->script);
+        bench_keep(get_variable(interp->global_env, "s"));
+        free_interpreter(interp);
+    }
+}
+
+static void bench_concat(void) {
+    ConcatContext ctx;
+    ctx.heap = create_string_heap();
+    memset(ctx.piece, 'x', CONCAT_PIECE);
+    ctx.piece[CONCAT_PIECE] = '\0';
+    ctx.script = malloc(CONCAT_PIECE + 96);
+    if (ctx.heap && ctx.script) {
+        sprintf(ctx.script, "string s = \"\";\nrepeat %d {\n    s = s + \"%s\";\n}\n",
+                CONCAT_LARGE_PIECES, ctx.piece);
+        BenchResult append_small;
+        BenchResult rebuild_small;
+        BenchResult append_large;
+        BenchResult script;
+        bool ran_append_small = bench_run("string_heap/concat/append_1MiB", run_append_small,
+                                          &ctx, &append_small);
+        bool ran_rebuild_small = bench_run("string_heap/concat/rebuild_1MiB", run_rebuild_small,
+                                           &ctx, &rebuild_small);
+        bool ran_append_large = bench_run("string_heap/concat/append_100MiB", run_append_large,
+                                          &ctx, &append_large);
+        bool ran_script = bench_run("string_heap/concat/script_100MiB", run_concat_script,
+                                    &ctx, &script);
+        double bytes = (double)CONCAT_LARGE_PIECES * CONCAT_PIECE;
+        if (ran_append_small && ran_rebuild_small) {
+            printf("string_heap: appending builds 1 MiB %.0fx faster than rebuilding\n",
+                   rebuild_small.ns_per_op / append_small.ns_per_op);
+        }
+        if (ran_append_large) {
+            printf("string_heap: append 100 MiB at %.2f GB/s\n", bytes / append_large.ns_per_op);
+        }
+        if (ran_script) {
+            printf("string_heap: s = s + \"...\" builds 100 MiB in %.0f ms\n",
+                   script.ns_per_op / 1e6);
+        }
+    }
+    free(ctx.script);
+    free_string_heap(ctx.heap);
+}
+
+void bench_string_heap(void) {
+    char long_text[1001];
+    memset(long_text, 'x', sizeof(long_text) - 1);
+    long_text[sizeof(long_text) - 1] = '\0';
+    StringHeapContext short_ctx = {create_string_heap(), "hello, world", 12};
+    StringHeapContext long_ctx = {create_string_heap(), long_text, sizeof(long_text) - 1};
+    bench_run("string_heap/alloc_release/short", run_heap_alloc, &short_ctx, NULL);
+    bench_run("string_heap/strdup_free/short", run_malloc_alloc, &short_ctx, NULL);
+    bench_run("string_heap/alloc_release/long", run_heap_alloc, &long_ctx, NULL);
+    bench_run("string_heap/strdup_free/long", run_malloc_alloc, &long_ctx, NULL);
+    bench_run("string_heap/assign/same_class", run_heap_assign, &short_ctx, NULL);
+    free_string_heap(short_ctx.heap);
+    free_string_heap(long_ctx.heap);
+    bench_concat();
+}
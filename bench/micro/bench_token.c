@@ -0,0 +1,50 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Token Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures the create_token()/free_token() pair for a number token and an
+ * identifier token (which copies its text), and is_keyword().
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "token.h"
+
+static void run_number_token(void* context, size_t operations);
+static void run_identifier_token(void* context, size_t operations);
+static void run_is_keyword(void* context, size_t operations);
+
+static void run_number_token(void* context, size_t operations) {
+    int value = 42;
+    (void)context;
+    for (size_t i = 0; i < operations; i++) {
+        Token* token = create_token(TOKEN_NUMBER, &value, 0);
+        bench_keep(token);
+        free_token(token);
+    }
+}
+
+static void run_identifier_token(void* context, size_t operations) {
+    for (size_t i = 0; i < operations; i++) {
+        Token* token = create_token(TOKEN_IDENTIFIER, context, 0);
+        bench_keep(token);
+        free_token(token);
+    }
+}
+
+static void run_is_keyword(void* context, size_t operations) {
+    for (size_t i = 0; i < operations; i++) {
+        bench_keep((void*)(size_t)is_keyword(context));
+    }
+}
+
+void bench_token(void) {
+    char identifier[] = "another_counter";
+    bench_run("token/create_free/number", run_number_token, NULL, NULL);
+    bench_run("token/create_free/identifier", run_identifier_token, identifier, NULL);
+    bench_run("token/is_keyword", run_is_keyword, identifier, NULL);
+}
@@ -0,0 +1,34 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Token Buffer Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures whole-source tokenization into a TokenBuffer, reported per
+ * token.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "token_buffer.h"
+
+static void run_tokenize(void* context, size_t operations);
+
+static void run_tokenize(void* context, size_t operations) {
+    Lexer* lexer = context;
+    size_t tokens = 0;
+    while (tokens < operations) {
+        lexer->position = 0;
+        TokenBuffer* buffer = tokenize_source(lexer);
+        tokens += buffer->count;
+        free_token_buffer(buffer);
+    }
+}
+
+void bench_token_buffer(void) {
+    Lexer* lexer = init_lexer((char*)bench_sample_program);
+    bench_run("token_buffer/tokenize_source/per_token", run_tokenize, lexer, NULL);
+    free_lexer(lexer);
+}
@@ -0,0 +1,65 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Value Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures copy_value() plus the matching free_value() for int and string
+ * values of several lengths, and fprint_value() into /dev/null.
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "suites.h"
+#include "types.h"
+
+static void run_copy_value(void* context, size_t operations);
+static void run_print_value(void* context, size_t operations);
+static Value* make_string_value(size_t length);
+
+static void run_copy_value(void* context, size_t operations) {
+    Value* value = context;
+    for (size_t i = 0; i < operations; i++) {
+        Value* copy = copy_value(value);
+        bench_keep(copy);
+        free_value(copy);
+    }
+}
+
+static void run_print_value(void* context, size_t operations) {
+    Value* value = context;
+    FILE* stream = bench_null_stream();
+    for (size_t i = 0; i < operations; i++) {
+        fprint_value(stream, value);
+    }
+}
+
+static Value* make_string_value(size_t length) {
+    Value* value = init_value(TYPE_STRING);
+    value->data.string_val = malloc(length + 1);
+    memset(value->data.string_val, 's', length);
+    value->data.string_val[length] = '\0';
+    return value;
+}
+
+void bench_types(void) {
+    Value* int_value = init_value(TYPE_INT);
+    int_value->data.int_val = 123456;
+    bench_run("types/copy_value/int", run_copy_value, int_value, NULL);
+    bench_run("types/print_value/int", run_print_value, int_value, NULL);
+    free_value(int_value);
+
+    size_t lengths[] = {16, 256, 1000};
+    for (size_t i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+        Value* string_value = make_string_value(lengths[i]);
+        char name[64];
+        snprintf(name, sizeof(name), "types/copy_value/string/%zuB", lengths[i]);
+        bench_run(name, run_copy_value, string_value, NULL);
+        snprintf(name, sizeof(name), "types/print_value/string/%zuB", lengths[i]);
+        bench_run(name, run_print_value, string_value, NULL);
+        free_value(string_value);
+    }
+}
@@ -0,0 +1,63 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Undo Log Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures the cost of logging one write, with a commit every 1024 writes,
+ * and set_variable() overwrites with an undo log attached.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "undo_log.h"
+
+typedef struct {
+    Environment* env;
+    UndoLog* log;
+    Value* value;
+} UndoContext;
+
+static void run_record(void* context, size_t operations);
+static void run_logged_set(void* context, size_t operations);
+
+static void run_record(void* context, size_t operations) {
+    UndoContext* ctx = context;
+    Variable* variable = ctx->env->variables->variable;
+    for (size_t i = 0; i < operations; i++) {
+        undo_log_record(ctx->log, UNDO_CREATED, variable, NULL);
+        if (ctx->log->count == 1024) {
+            undo_log_commit(ctx->log);
+        }
+    }
+    undo_log_commit(ctx->log);
+}
+
+static void run_logged_set(void* context, size_t operations) {
+    UndoContext* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        ctx->value->data.int_val = (int)i;
+        set_variable(ctx->env, "counter", ctx->value);
+        if (ctx->log->count == 1024) {
+            undo_log_commit(ctx->log);
+        }
+    }
+    undo_log_commit(ctx->log);
+}
+
+void bench_undo_log(void) {
+    UndoContext ctx;
+    ctx.env = create_env();
+    ctx.log = create_undo_log();
+    ctx.value = init_value(TYPE_INT);
+    set_variable(ctx.env, "counter", ctx.value);
+    bench_run("undo_log/record", run_record, &ctx, NULL);
+    ctx.env->undo_log = ctx.log;
+    bench_run("undo_log/set_variable_logged", run_logged_set, &ctx, NULL);
+    ctx.env->undo_log = NULL;
+    free_undo_log(ctx.log);
+    free_value(ctx.value);
+    free_env(ctx.env);
+}
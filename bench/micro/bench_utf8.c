@@ -0,0 +1,63 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - UTF-8 Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures utf8_validate() over 1 KiB of ASCII, of French text (one
+ * two-byte sequence every few words) and of CJK text (three-byte sequences
+ * only), with memcpy() of the same kilobyte as the reference point.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include "suites.h"
+#include "utf8.h"
+
+#define UTF8_BENCH_BYTES 1024
+
+typedef struct {
+    char text[UTF8_BENCH_BYTES];
+    char copy[UTF8_BENCH_BYTES];
+    size_t length;
+} Utf8Context;
+
+static void fill_text(Utf8Context* ctx, const char* pattern);
+static void run_validate(void* context, size_t operations);
+static void run_memcpy(void* context, size_t operations);
+
+static void fill_text(Utf8Context* ctx, const char* pattern) {
+    size_t pattern_length = strlen(pattern);
+    ctx->length = 0;
+    while (ctx->length + pattern_length <= UTF8_BENCH_BYTES) {
+        memcpy(ctx->text + ctx->length, pattern, pattern_length);
+        ctx->length += pattern_length;
+    }
+}
+
+static void run_validate(void* context, size_t operations) {
+    Utf8Context* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        bench_keep(ctx->text + utf8_validate(ctx->text, ctx->length));
+    }
+}
+
+static void run_memcpy(void* context, size_t operations) {
+    Utf8Context* ctx = context;
+    for (size_t i = 0; i < operations; i++) {
+        memcpy(ctx->copy, ctx->text, ctx->length);
+        bench_keep(ctx->copy);
+    }
+}
+
+void bench_utf8(void) {
+    static Utf8Context ctx;
+    fill_text(&ctx, "The quick brown fox jumps over the lazy dog. ");
+    bench_run("utf8/memcpy/1KiB", run_memcpy, &ctx, NULL);
+    bench_run("utf8/validate/ascii_1KiB", run_validate, &ctx, NULL);
+    fill_text(&ctx, "Le cœur déçu mais l'âme plutôt naïve, Louÿs rêva de crapaüter. ");
+    bench_run("utf8/validate/french_1KiB", run_validate, &ctx, NULL);
+    fill_text(&ctx, "\xe6\x97\xa5\xe6\x9c\xac\xe8\xaa\x9e\xe3\x81\xae\xe6\x96\x87\xe7\xab\xa0");
+    bench_run("utf8/validate/cjk_1KiB", run_validate, &ctx, NULL);
+}
@@ -0,0 +1,39 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Utility Microbenchmarks
+ * ============================================================================
+ * 
+ * Measures safe_strdup() with its matching free and report_error() into
+ * /dev/null.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+#include "utils.h"
+
+static void run_safe_strdup(void* context, size_t operations);
+static void run_report_error(void* context, size_t operations);
+
+static void run_safe_strdup(void* context, size_t operations) {
+    for (size_t i = 0; i < operations; i++) {
+        char* copy = safe_strdup(context);
+        bench_keep(copy);
+        free(copy);
+    }
+}
+
+static void run_report_error(void* context, size_t operations) {
+    FILE* stream = bench_null_stream();
+    for (size_t i = 0; i < operations; i++) {
+        report_error(stream, context, 12, 34);
+    }
+}
+
+void bench_utils(void) {
+    char text[] = "a thirty-two byte long string..";
+    bench_run("utils/safe_strdup/32B", run_safe_strdup, text, NULL);
+    bench_run("utils/report_error", run_report_error, text, NULL);
+}
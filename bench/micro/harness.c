@@ -0,0 +1,169 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Microbenchmark Harness Implementation
+ * ============================================================================
+ * 
+ * Implementation of the microbenchmark harness. The process is pinned to
+ * one CPU (BENCH_CPU, or the CPU it starts on) so samples do not migrate
+ * between caches. Each benchmark is calibrated until one sample lasts
+ * about 10 ms, warmed up for 100 ms, then sampled until the half-width of
+ * the 95% confidence interval of the mean falls under 1% of the mean, or
+ * the sample and time budgets run out, in which case it is flagged.
+ * 
+ * Options: bench-micro [filter] [--target=percent] [--max-samples=n]
+ * Only benchmarks whose name contains the filter are run.
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <sched.h>
+#include <time.h>
+#include "harness.h"
+
+#define SAMPLE_TARGET_NS 10000000.0
+#define WARMUP_NS 100000000.0
+#define TIME_BUDGET_NS 3000000000.0
+#define MIN_SAMPLES 10
+
+static const char* filter = NULL;
+static double target_ratio = 0.01;
+static size_t max_samples = 200;
+static FILE* null_stream = NULL;
+
+static double now_ns(void);
+static double time_operations(BenchFunction function, void* context, size_t operations);
+static double student_t95(size_t samples);
+static void pin_to_cpu(void);
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+static double time_operations(BenchFunction function, void* context, size_t operations) {
+    double start = now_ns();
+    function(context, operations);
+    return now_ns() - start;
+}
+
+static double student_t95(size_t samples) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    size_t freedom = samples > 1 ? samples - 1 : 1;
+    if (freedom <= sizeof(table) / sizeof(table[0])) {
+        return table[freedom - 1];
+    }
+    return 1.960;
+}
+
+static void pin_to_cpu(void) {
+    const char* requested = getenv("BENCH_CPU");
+    int cpu = requested ? atoi(requested) : sched_getcpu();
+    if (cpu < 0) {
+        return;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) == 0) {
+        printf("Pinned to CPU %d\n", cpu);
+    } else {
+        printf("Could not pin to CPU %d, results may be noisier\n", cpu);
+    }
+}
+
+void bench_setup(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--target=", 9) == 0) {
+            target_ratio = atof(argv[i] + 9) / 100.0;
+        } else if (strncmp(argv[i], "--max-samples=", 14) == 0) {
+            max_samples = (size_t)atol(argv[i] + 14);
+        } else {
+            filter = argv[i];
+        }
+    }
+    if (max_samples < MIN_SAMPLES) {
+        max_samples = MIN_SAMPLES;
+    }
+    pin_to_cpu();
+    printf("%-44s %12s %12s %8s %6s\n", "benchmark", "ns/op", "+/- 95% CI", "samples", "");
+}
+
+bool bench_run(const char* name, BenchFunction function, void* context, BenchResult* result) {
+    if (filter && !strstr(name, filter)) {
+        return false;
+    }
+    size_t operations = 1;
+    while (time_operations(function, context, operations) < SAMPLE_TARGET_NS &&
+           operations < ((size_t)1 << 40)) {
+        operations *= 2;
+    }
+    double warmup_start = now_ns();
+    while (now_ns() - warmup_start < WARMUP_NS) {
+        function(context, operations);
+    }
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    double mean = 0.0;
+    double ci95 = 0.0;
+    size_t samples = 0;
+    double budget_start = now_ns();
+    bool stable = false;
+    while (samples < max_samples) {
+        double per_op = time_operations(function, context, operations) / (double)operations;
+        sum += per_op;
+        sum_squares += per_op * per_op;
+        samples++;
+        mean = sum / (double)samples;
+        if (samples < MIN_SAMPLES) {
+            continue;
+        }
+        double variance = (sum_squares - sum * mean) / (double)(samples - 1);
+        ci95 = student_t95(samples) * sqrt(variance > 0.0 ? variance : 0.0) / sqrt((double)samples);
+        if (ci95 <= mean * target_ratio) {
+            stable = true;
+            break;
+        }
+        if (now_ns() - budget_start > TIME_BUDGET_NS) {
+            break;
+        }
+    }
+    printf("%-44s %12.2f %12.2f %8zu %6s\n", name, mean, ci95, samples,
+           stable ? "" : "noisy");
+    fflush(stdout);
+    if (result) {
+        result->ns_per_op = mean;
+        result->ci95 = ci95;
+        result->samples = samples;
+        result->ops_per_sample = operations;
+        result->stable = stable;
+    }
+    return true;
+}
+
+void bench_keep(void* pointer) {
+    __asm__ __volatile__("" : : "g"(pointer) : "memory");
+}
+
+FILE* bench_null_stream(void) {
+    if (!null_stream) {
+        null_stream = fopen("/dev/null", "w");
+    }
+    return null_stream;
+}
+
+void bench_teardown(void) {
+    if (null_stream) {
+        fclose(null_stream);
+        null_stream = NULL;
+    }
+}
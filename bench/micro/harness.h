@@ -0,0 +1,46 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Microbenchmark Harness
+ * ============================================================================
+ * 
+ * This header declares the harness used by the per-module microbenchmarks
+ * in bench/micro. A benchmark is a function that performs a requested
+ * number of operations; the harness takes care of measuring it.
+ * 
+ * Core Functionality:
+ * - Pinning of the benchmark process to a single CPU
+ * - Calibration of the operations per sample to a fixed sample duration
+ * - Warm-up before any sample is recorded
+ * - Sampling until the 95% confidence interval is within the target
+ * - Reporting of ns/op with its confidence interval
+ * 
+ * Every module of the interpreter has a bench_<module>.c file exposing a
+ * bench_<module>() suite; the suites are listed in main.c.
+ * 
+ * ============================================================================
+ */
+
+#ifndef BENCH_HARNESS_H
+    #define BENCH_HARNESS_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+typedef void (*BenchFunction)(void* context, size_t operations);
+
+typedef struct {
+    double ns_per_op;
+    double ci95;
+    size_t samples;
+    size_t ops_per_sample;
+    bool stable;
+} BenchResult;
+
+void bench_setup(int argc, char** argv);
+bool bench_run(const char* name, BenchFunction function, void* context, BenchResult* result);
+void bench_keep(void* pointer);
+FILE* bench_null_stream(void);
+void bench_teardown(void);
+
+#endif
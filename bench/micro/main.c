@@ -0,0 +1,49 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Microbenchmark Entry Point
+ * ============================================================================
+ * 
+ * Runs every module's microbenchmark suite through the harness. Pass a
+ * substring to run only matching benchmarks, e.g. `bench-micro environment`.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "suites.h"
+
+const char* const bench_sample_program =
+    "int count = 0;\n"
+    "string message = \"Hello, World!\";\n"
+    "char letter = 'A';\n"
+    "count = 42;\n"
+    "message = \"a somewhat longer string literal with \\\"escapes\\\"\\n\";\n"
+    "letter = 'Z';\n"
+    "int another_counter = 123456;\n"
+    "another_counter = 7;\n";
+
+int main(int argc, char** argv) {
+    bench_setup(argc, argv);
+    bench_allocator();
+    bench_environment();
+    bench_int_array();
+    bench_interpreter();
+    bench_jit();
+    bench_lexer();
+    bench_line_index();
+    bench_parser();
+    bench_query();
+    bench_scheduler();
+    bench_scope();
+    bench_stream();
+    bench_string_heap();
+    bench_token();
+    bench_token_buffer();
+    bench_types();
+    bench_undo_log();
+    bench_utf8();
+    bench_utils();
+    bench_teardown();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,42 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Microbenchmark Suites
+ * ============================================================================
+ * 
+ * One suite per interpreter module. Each suite registers its benchmarks
+ * with the harness when called; main.c runs them in module order.
+ * 
+ * The shared sample program is a short mix of declarations and assignments
+ * of every type, used wherever a benchmark needs realistic source text.
+ * 
+ * ============================================================================
+ */
+
+#ifndef BENCH_SUITES_H
+    #define BENCH_SUITES_H
+
+#include "harness.h"
+
+extern const char* const bench_sample_program;
+
+void bench_allocator(void);
+void bench_environment(void);
+void bench_int_array(void);
+void bench_interpreter(void);
+void bench_jit(void);
+void bench_lexer(void);
+void bench_line_index(void);
+void bench_parser(void);
+void bench_query(void);
+void bench_scheduler(void);
+void bench_scope(void);
+void bench_stream(void);
+void bench_string_heap(void);
+void bench_token(void);
+void bench_token_buffer(void);
+void bench_types(void);
+void bench_undo_log(void);
+void bench_utf8(void);
+void bench_utils(void);
+
+#endif
@@ -0,0 +1,234 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Multithreaded Stress Benchmark
+ * ============================================================================
+ * 
+ * Runs N threads that each execute M generated .pong scripts, every script
+ * in a fresh Interpreter with its own output stream. The benchmark is run
+ * for 1, 2, 4, ... N threads with the same amount of work per thread, so
+ * perfect scaling keeps the wall time constant and the reported efficiency
+ * at 100%.
+ * 
+ * Every run is checked for errors and for the expected statement count,
+ * which makes this program the workload used by the ThreadSanitizer build
+ * (make tsan) to verify that interpreter instances share no hidden state.
+ * 
+ * With a non-zero base size, a frozen base environment of that many int
+ * variables is built once and every interpreter layers over it; each script
+ * then also overwrites a few base variables in its private overlay.
+ * 
+ * Usage: bench-threads [max_threads] [scripts_per_thread] [statements] [base]
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "interpreter.h"
+
+#define BASE_WRITES_PER_SCRIPT 16
+
+typedef struct {
+    int thread_index;
+    int scripts;
+    int statements;
+    int base_size;
+    const Environment* base;
+    int failures;
+    FILE* sink;
+} WorkerContext;
+
+static char* generate_script(int seed, int statements, int base_size);
+static Environment* build_base(int base_size);
+static void* worker_main(void* arg);
+static double now_seconds(void);
+static double run_round(WorkerContext* prototype, int threads, int* failures);
+
+static char* generate_script(int seed, int statements, int base_size) {
+    size_t capacity = (size_t)(statements + BASE_WRITES_PER_SCRIPT) * 64 + 64;
+    char* source = malloc(capacity);
+    if (!source) {
+        return NULL;
+    }
+    size_t length = 0;
+    int variables = statements / 4 + 1;
+    for (int i = 0; i < statements; i++) {
+        int var = i % variables;
+        int written;
+        if (i < variables) {
+            switch (var % 3) {
+                case 0:
+                    written = snprintf(source + length, capacity - length,
+                            "int v%d = %d;\n", var, seed + i);
+                    break;
+                case 1:
+                    written = snprintf(source + length, capacity - length,
+                            "char v%d = '%c';\n", var, 'a' + (seed + i) % 26);
+                    break;
+                default:
+                    written = snprintf(source + length, capacity - length,
+                            "string v%d = \"s%d_%d\";\n", var, seed, i);
+                    break;
+            }
+        } else {
+            switch (var % 3) {
+                case 0:
+                    written = snprintf(source + length, capacity - length,
+                            "v%d = %d;\n", var, seed * i);
+                    break;
+                case 1:
+                    written = snprintf(source + length, capacity - length,
+                            "v%d = '%c';\n", var, 'A' + i % 26);
+                    break;
+                default:
+                    written = snprintf(source + length, capacity - length,
+                            "v%d = \"updated %d\";\n", var, i);
+                    break;
+            }
+        }
+        length += (size_t)written;
+    }
+    for (int i = 0; base_size > 0 && i < BASE_WRITES_PER_SCRIPT; i++) {
+        length += (size_t)snprintf(source + length, capacity - length,
+                "b%d = %d;\n", (seed + i * 7919) % base_size, seed);
+    }
+    source[length] = '\0';
+    return source;
+}
+
+static Environment* build_base(int base_size) {
+    Environment* base = create_env();
+    Value* value = init_value(TYPE_INT);
+    char name[32];
+    if (!base || !value) {
+        free_env(base);
+        free_value(value);
+        return NULL;
+    }
+    for (int i = 0; i < base_size; i++) {
+        snprintf(name, sizeof(name), "b%d", i);
+        value->data.int_val = i;
+        set_variable(base, name, value);
+    }
+    free_value(value);
+    freeze_env(base);
+    return base;
+}
+
+static void* worker_main(void* arg) {
+    WorkerContext* ctx = arg;
+    for (int i = 0; i < ctx->scripts; i++) {
+        char* source = generate_script(ctx->thread_index * 1000 + i,
+                                       ctx->statements, ctx->base_size);
+        Interpreter* interp = init_interpreter_with_base(ctx->base);
+        if (!source || !interp) {
+            ctx->failures++;
+            free(source);
+            free_interpreter(interp);
+            continue;
+        }
+        set_interpreter_output(interp, ctx->sink);
+        run(interp, source);
+        int expected = ctx->statements + (ctx->base_size > 0 ? BASE_WRITES_PER_SCRIPT : 0);
+        if (interp->has_error || interp->executed_statements != expected) {
+            ctx->failures++;
+        }
+        free_interpreter(interp);
+        free(source);
+    }
+    return NULL;
+}
+
+static double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+static double run_round(WorkerContext* prototype, int threads, int* failures) {
+    pthread_t* handles = calloc((size_t)threads, sizeof(pthread_t));
+    WorkerContext* contexts = calloc((size_t)threads, sizeof(WorkerContext));
+    if (!handles || !contexts) {
+        free(handles);
+        free(contexts);
+        *failures = threads * prototype->scripts;
+        return 0.0;
+    }
+    for (int t = 0; t < threads; t++) {
+        contexts[t] = *prototype;
+        contexts[t].thread_index = t;
+        contexts[t].sink = fopen("/dev/null", "w");
+    }
+    double start = now_seconds();
+    for (int t = 0; t < threads; t++) {
+        pthread_create(&handles[t], NULL, worker_main, &contexts[t]);
+    }
+    *failures = 0;
+    for (int t = 0; t < threads; t++) {
+        pthread_join(handles[t], NULL);
+        *failures += contexts[t].failures;
+    }
+    double elapsed = now_seconds() - start;
+    for (int t = 0; t < threads; t++) {
+        if (contexts[t].sink) {
+            fclose(contexts[t].sink);
+        }
+    }
+    free(handles);
+    free(contexts);
+    return elapsed;
+}
+
+int main(int argc, char** argv) {
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int max_threads = argc > 1 ? atoi(argv[1]) : (int)(cpus > 0 ? cpus : 1);
+    int scripts = argc > 2 ? atoi(argv[2]) : 64;
+    int statements = argc > 3 ? atoi(argv[3]) : 2000;
+    int base_size = argc > 4 ? atoi(argv[4]) : 0;
+    if (max_threads < 1 || scripts < 1 || statements < 1 || base_size < 0) {
+        fprintf(stderr, "Usage: %s [max_threads] [scripts_per_thread] [statements] [base]\n",
+                argv[0]);
+        return EXIT_FAILURE;
+    }
+    WorkerContext prototype = {0, scripts, statements, base_size, NULL, 0, NULL};
+    Environment* base = NULL;
+    if (base_size > 0) {
+        base = build_base(base_size);
+        if (!base) {
+            fprintf(stderr, "Failed to build base environment\n");
+            return EXIT_FAILURE;
+        }
+        prototype.base = base;
+    }
+    printf("Interpreter thread scaling: %d scripts/thread, %d statements/script, "
+           "%d base variables, %ld CPUs\n", scripts, statements, base_size, cpus);
+    printf("%8s %12s %14s %12s %10s\n", "threads", "seconds", "scripts/s", "speedup", "efficiency");
+    double baseline = 0.0;
+    int total_failures = 0;
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        int failures = 0;
+        double elapsed = run_round(&prototype, threads, &failures);
+        double throughput = elapsed > 0.0 ? threads * scripts / elapsed : 0.0;
+        if (threads == 1) {
+            baseline = throughput;
+        }
+        double speedup = baseline > 0.0 ? throughput / baseline : 0.0;
+        printf("%8d %12.3f %14.1f %11.2fx %9.1f%%\n",
+               threads, elapsed, throughput, speedup, 100.0 * speedup / threads);
+        total_failures += failures;
+        if (threads * 2 > max_threads && threads != max_threads) {
+            threads = max_threads / 2;
+        }
+    }
+    free_env(base);
+    if (total_failures > 0) {
+        fprintf(stderr, "%d script runs failed\n", total_failures);
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,73 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Allocator Module
+ * ============================================================================
+ *
+ * This module lets an embedder supply the memory behind an Interpreter: an
+ * Allocator is a table of alloc/realloc/free callbacks plus a context
+ * pointer handed back to each of them, in the manner of an arena or a
+ * tracking allocator.
+ *
+ * Core Functionality:
+ * - The Allocator vtable and the allocator current on the calling thread
+ * - mem_alloc() / mem_calloc() / mem_realloc() / mem_free() and the string
+ *   copies mem_strdup() / mem_strndup(), which go to the current allocator
+ *
+ * The lexer, tokens, parser, values, environments and undo logs allocate
+ * through these functions. Rather than carrying an allocator argument
+ * through every one of their calls, the interpreter installs its own with
+ * use_allocator() for the duration of each of its entry points and
+ * restores the previous one on return. With no allocator installed (the
+ * default on every thread) the functions call malloc() and friends
+ * directly. mem_alloc(), mem_realloc() and mem_free() are inline, so that
+ * path costs one thread-local load and a branch at the call site rather
+ * than an extra call.
+ *
+ * Memory must be released under the allocator that was current when it
+ * was allocated. All three callbacks are required; alloc and realloc
+ * return NULL on failure like their libc counterparts.
+ *
+ * ============================================================================
+ */
+
+#ifndef ALLOCATOR_H
+    #define ALLOCATOR_H
+
+#include <stddef.h>
+#include <stdlib.h>
+
+typedef struct Allocator {
+    void* (*alloc)(void* context, size_t size);
+    void* (*realloc)(void* context, void* pointer, size_t size);
+    void (*free)(void* context, void* pointer);
+    void* context;
+} Allocator;
+
+extern __thread const Allocator* thread_allocator;
+
+const Allocator* use_allocator(const Allocator* allocator);
+const Allocator* current_allocator(void);
+void* mem_calloc(size_t count, size_t size);
+char* mem_strdup(const char* text);
+char* mem_strndup(const char* text, size_t length);
+
+static inline void* mem_alloc(size_t size) {
+    const Allocator* allocator = thread_allocator;
+    return allocator ? allocator->alloc(allocator->context, size) : malloc(size);
+}
+
+static inline void* mem_realloc(void* pointer, size_t size) {
+    const Allocator* allocator = thread_allocator;
+    return allocator ? allocator->realloc(allocator->context, pointer, size) : realloc(pointer, size);
+}
+
+static inline void mem_free(void* pointer) {
+    const Allocator* allocator = thread_allocator;
+    if (!allocator) {
+        free(pointer);
+    } else if (pointer) {
+        allocator->free(allocator->context, pointer);
+    }
+}
+
+#endif
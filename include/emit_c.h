@@ -0,0 +1,43 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - C Code Generator Module
+ * ============================================================================
+ *
+ * This module implements `--emit-c` and `--compile`: ahead-of-time
+ * translation of a .pong script into a standalone C program whose output
+ * and exit status are byte-for-byte those of interpreting the script.
+ *
+ * Core Functionality:
+ * - Global variables become static C variables, block-local variables
+ *   become C locals of nested C blocks
+ * - Every declaration and assignment becomes a store and a printf; an
+ *   assignment to a global is a call to that global's setter
+ * - Parse and runtime errors become the interpreter's own messages at the
+ *   statement where the interpreter would stop
+ * - Native compilation of the generated file with the local C compiler
+ *
+ * The generator drives the interpreter's front end and executes each
+ * statement as it translates it, so duplicate declarations, undefined
+ * variables and parse errors are found by the same code, with the same
+ * messages, as in an interpreted run. Statements after the first error are
+ * never translated.
+ *
+ * Top-level statements are split into functions of at most
+ * EMIT_C_CHUNK_STATEMENTS each so the C compiler never sees a single
+ * enormous function.
+ *
+ * ============================================================================
+ */
+
+#ifndef EMIT_C_H
+    #define EMIT_C_H
+
+#include <stdio.h>
+#include "interpreter.h"
+
+#define EMIT_C_CHUNK_STATEMENTS 1024
+
+bool emit_c_program(Interpreter* interp, const char* filename, char* source, FILE* out);
+bool compile_c_program(const char* c_path, const char* binary_path);
+
+#endif
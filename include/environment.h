@@ -13,11 +13,36 @@
  * - Variable creation, modification, and deletion
  * - Memory-safe environment management with proper cleanup
  * - Variable existence checking for optimization
- * - Support for variable scoping (future extension point)
+ * - Frozen, read-only base environments shared by copy-on-write children
+ * - Global scope storage (block scopes live in frames, see scope.h)
  * 
  * The environment uses a simple linked list implementation for variable
  * storage, providing O(n) lookup but excellent memory efficiency.
  * 
+ * freeze_env() turns an environment into an immutable base indexed by an
+ * open-addressed hash table. Any number of children created with
+ * create_child_env() on any thread may layer over a frozen base without
+ * locking: a child records its own declarations and assignments in its
+ * private list (assigning a base variable shadows it there), and lookups
+ * fall through to the base. The base must outlive all of its children.
+ * 
+ * String values are stored in the environment's own StringHeap, created on
+ * the first string write. Without an UndoLog, reassigning a variable of the
+ * same type updates its Value in place, and a string whose new text fits
+ * its size class is overwritten without allocating. compact_env_strings()
+ * copies the live strings into a fresh, dense heap and frees the old one.
+ * 
+ * declare_variable() adds a variable the caller knows to be new without
+ * searching the list for it first, which keeps bulk loads linear.
+ * 
+ * append_variable() extends a string variable where it is stored, the
+ * block growing geometrically, so building a string piece by piece stays
+ * linear. A variable of a base, or one whose old value the undo log must
+ * keep, is appended to in a copy instead.
+ * 
+ * While an UndoLog is attached, set_variable() records each change in it
+ * and keeps overwritten values alive for a later rollback or commit.
+ * 
  * ============================================================================
  */
 
@@ -25,21 +50,37 @@
     #define ENVIRONMENT_H
 
 #include "types.h"
+#include "string_heap.h"
+
+struct UndoLog;
 
 typedef struct VariableNode {
     Variable* variable;
     struct VariableNode* next;
 } VariableNode;
 
-typedef struct {
+typedef struct Environment {
     VariableNode* variables;
     size_t count;
+    const struct Environment* base;
+    Variable** frozen_table;
+    size_t frozen_capacity;
+    struct UndoLog* undo_log;
+    StringHeap* strings;
 } Environment;
 
 Environment* create_env(void);
+Environment* create_child_env(const Environment* base);
+Environment* clone_env(const Environment* env);
+bool freeze_env(Environment* env);
+bool env_is_frozen(const Environment* env);
 void free_env(Environment* env);
 bool set_variable(Environment* env, char* name, Value* value);
+bool declare_variable(Environment* env, char* name, Value* value);
+bool append_variable(Environment* env, char* name, const char* text, size_t length);
 Value* get_variable(Environment* env, char* name);
 bool variable_exists(Environment* env, char* name);
+bool compact_env_strings(Environment* env);
+void env_string_stats(const Environment* env, StringHeapStats* stats);
 
 #endif
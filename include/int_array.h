@@ -0,0 +1,45 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Int Array Module
+ * ============================================================================
+ *
+ * This module implements the storage of the `int[N]` type: N ints in one
+ * contiguous buffer aligned to a cache line, and the bulk operations the
+ * language exposes on it.
+ *
+ * Core Functionality:
+ * - Creation, deep copy and release of an array
+ * - fill and copy of a whole array
+ * - sum (wrapping on overflow like the interpreter's int), min and max
+ *
+ * The bulk operations process 8 ints per instruction with AVX2 or 4 with
+ * SSE2, whichever the build targets, and finish the last few elements one
+ * at a time; a build for neither runs the scalar loop only. Every buffer
+ * starts on a 64-byte boundary, so the vector loops use aligned loads and
+ * stores from the first element.
+ *
+ * ============================================================================
+ */
+
+#ifndef INT_ARRAY_H
+    #define INT_ARRAY_H
+
+#include <stddef.h>
+
+#define INT_ARRAY_ALIGNMENT 64
+
+typedef struct IntArray {
+    size_t length;
+    int* items;
+} IntArray;
+
+IntArray* create_int_array(size_t length, int value);
+IntArray* copy_int_array(const IntArray* src);
+void free_int_array(IntArray* array);
+void int_array_fill(IntArray* array, int value);
+void int_array_copy(IntArray* dst, const IntArray* src);
+int int_array_sum(const IntArray* array);
+int int_array_min(const IntArray* array);
+int int_array_max(const IntArray* array);
+
+#endif
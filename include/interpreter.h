@@ -18,6 +18,73 @@
  * The interpreter maintains execution context and provides comprehensive
  * error reporting for runtime issues and semantic violations.
  * 
+ * Instances share no mutable state: every Interpreter owns its environment
+ * and writes all of its output to its own stream (stdout by default), so
+ * independent instances may run concurrently on separate threads. Instances
+ * started with init_interpreter_with_base() share a frozen base environment
+ * read-only and only pay memory for their own writes.
+ * 
+ * In transactional mode run() attaches an undo log to the global
+ * environment: a run that stops on an error is rolled back to the state
+ * the environment had before the run, and a successful run commits by
+ * discarding the log.
+ * 
+ * With buffered_tokens set, run() tokenizes the whole source into a packed
+ * TokenBuffer before parsing instead of lexing one heap Token at a time.
+ * 
+ * run() is built on an Execution: begin_execution() prepares the front end
+ * at any source position, execute_next() parses and executes one top-level
+ * statement, and end_execution() settles the transaction and releases it.
+ * 
+ * run() is itself start_run() followed by run_step() with no budget. An
+ * embedder can instead call run_step() with a budget of statements and/or
+ * microseconds (a zero limit is no limit): it returns after the budget is
+ * spent with the execution parked on the Interpreter, and the next call
+ * resumes at the following top-level statement. The output of a run
+ * sliced this way is identical to that of run(). A block always runs to
+ * completion within one step.
+ * 
+ * Statements only record their source offset; a runtime error message
+ * converts it to a line number through a LineIndex over the source of the
+ * current execution, built the first time one is needed.
+ * 
+ * An Interpreter with a profiler attached (see profiler.h) times each
+ * declaration and assignment it executes and hands the profiler to the
+ * parser of every execution it begins.
+ * 
+ * An Interpreter with a trace attached (see trace.h) also appends a binary
+ * record for each of them, and one for how every execution ended.
+ * 
+ * Block-local variables are stored in frames of the interpreter's value
+ * stack and addressed by the (depth, slot) pair the parser resolved.
+ * 
+ * A `repeat N` loop executes its body once; since that leaves the state
+ * every further iteration would, the remaining iterations only repeat
+ * its output and statement count (all of them run when a profiler or
+ * trace must see each one, or when the body reads variables through
+ * copy(), a reduction or a concatenation). The output is that of N
+ * executions.
+ * 
+ * Array statements modify a local or an owned global array in place, so
+ * setting one element costs the same whatever the array's length; fill,
+ * copy and the reductions run the SIMD loops of int_array.h.
+ * 
+ * `s = s + ...;` appends to s where it is stored (append_variable() for a
+ * global, append_local() for a local), so building a string from n pieces
+ * is linear in its final length; it echoes `Appended "..." to variable
+ * 's'` rather than the whole string.
+ * 
+ * An Interpreter made by init_interpreter_with_allocator() allocates
+ * itself, its tokens, statements, values, environments and undo logs
+ * through the given Allocator (see allocator.h), which the caller keeps
+ * alive until free_interpreter(). execute_statement(), the Execution
+ * functions, free_interpreter() and the other run modes install it on the
+ * calling thread while they work; an embedder that calls the environment
+ * functions on interp->global_env directly wraps them in
+ * use_allocator(interp->allocator) itself. The JIT's code and side
+ * tables (jit.c), the scheduler's run list, the rings and the pipeline's
+ * batches stay on malloc().
+ * 
  * ============================================================================
  */
 
@@ -26,18 +93,55 @@
 
 #include "parser.h"
 #include "environment.h"
+#include "allocator.h"
+
+typedef struct {
+    int statements;
+    long microseconds;
+} StepBudget;
 
 typedef struct {
     Environment* global_env;
+    ValueStack* stack;
+    FILE* output;
+    bool transactional;
+    bool buffered_tokens;
     bool has_error;
     char error_message[256];
     int executed_statements;
+    const char* source;
+    LineIndex* lines;
+    struct Profiler* profiler;
+    struct TraceWriter* trace;
+    struct Execution* step;
+    const Allocator* allocator;
 } Interpreter;
 
+typedef struct Execution {
+    Lexer* lexer;
+    TokenBuffer* tokens;
+    Parser* parser;
+    struct UndoLog* undo_log;
+    bool done;
+    bool failed;
+} Execution;
+
 Interpreter* init_interpreter(void);
+Interpreter* init_interpreter_with_base(const Environment* base);
+Interpreter* init_interpreter_with_allocator(const Allocator* allocator);
+void set_interpreter_output(Interpreter* interp, FILE* output);
 bool execute_declaration(Interpreter* interp, Statement* stmt);
 bool execute_assignment(Interpreter* interp, Statement* stmt);
+bool execute_block(Interpreter* interp, Statement* stmt);
+bool execute_repeat(Interpreter* interp, Statement* stmt);
+bool execute_array(Interpreter* interp, Statement* stmt);
+bool execute_concat(Interpreter* interp, Statement* stmt);
 bool execute_statement(Interpreter* interp, Statement* stmt);
+bool begin_execution(Interpreter* interp, Execution* exec, char* source, size_t offset);
+bool execute_next(Interpreter* interp, Execution* exec);
+void end_execution(Interpreter* interp, Execution* exec);
+bool start_run(Interpreter* interp, char* source);
+bool run_step(Interpreter* interp, StepBudget budget);
 void run(Interpreter* interp, char* source);
 void free_interpreter(Interpreter* interp);
 
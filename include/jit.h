@@ -0,0 +1,50 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - JIT Execution Engine Module
+ * ============================================================================
+ *
+ * This module implements the experimental `--engine=jit`: statements are
+ * compiled to x86-64 machine code in batches and the batch is run as one
+ * native function instead of dispatching execute_statement() per
+ * statement.
+ *
+ * Core Functionality:
+ * - Assignments of int and char literals to global variables become a
+ *   direct store into the variable's Value through a slot array, followed
+ *   by a call to a buffered echo routine with the precomputed output line
+ * - Every other statement (declarations, strings, blocks) becomes a call
+ *   back into execute_statement(), which also fills the slot of each
+ *   global it declares
+ * - Code is written into an mmap'd read-write region that is switched to
+ *   read-execute before it runs, so no page is ever writable and
+ *   executable at once
+ *
+ * Parsing runs ahead of execution one batch at a time against a symbol
+ * environment seeded from the interpreter's globals, as in the pipelined
+ * mode; output, errors and the executed statement count are those of
+ * run().
+ *
+ * run_jit() falls back to run() on other architectures, when the system
+ * refuses to make a mapping executable (W^X policies such as SELinux
+ * execmem or PaX MPROTECT), and in transactional mode, where undo logging
+ * replaces Values instead of updating them in place.
+ *
+ * ============================================================================
+ */
+
+#ifndef JIT_H
+    #define JIT_H
+
+#include "interpreter.h"
+
+#define JIT_BATCH_STATEMENTS 4096
+
+typedef struct JitProgram JitProgram;
+
+bool jit_available(const Interpreter* interp, char* reason, size_t reason_size);
+JitProgram* jit_compile(Interpreter* interp, Statement** statements, size_t count);
+bool jit_execute(JitProgram* program);
+void free_jit_program(JitProgram* program);
+void run_jit(Interpreter* interp, char* source);
+
+#endif
@@ -14,8 +14,16 @@
  * - Whitespace and comment handling
  * - Comprehensive token generation for all language elements
  * 
- * The lexer maintains accurate line and column information for error reporting
- * and debugging purposes throughout the tokenization process.
+ * The lexer tracks only the byte offset of each token; lines and columns
+ * are derived from offsets when an error is reported (see line_index.h).
+ * 
+ * scan_lexeme() is the allocation-free core: it describes the next token
+ * with a Lexeme whose text points into the source (identifiers) or into the
+ * lexer's scratch buffer (string literals, valid until the next scan).
+ * next_token() builds heap Tokens on top of it.
+ * 
+ * The lexer never reads past `length`, so init_lexer_with_length() can run
+ * it over the filled prefix of a buffer that is still being read into.
  * 
  * ============================================================================
  */
@@ -29,14 +37,25 @@ typedef struct {
     char* source;
     size_t position;
     size_t length;
-    int line;
-    int column;
+    char text[MAX_STRING_LENGTH];
 } Lexer;
 
+typedef struct {
+    TokenType type;
+    size_t offset;
+    const char* text;
+    size_t length;
+    int int_val;
+    uint32_t char_val;
+} Lexeme;
+
 Lexer* init_lexer(char* source);
+Lexer* init_lexer_with_length(char* source, size_t length);
+void lexer_seek(Lexer* lexer, size_t offset);
 char next_char(Lexer* lexer);
 void skip_whitespace(Lexer* lexer);
 char* read_string(Lexer* lexer);
+bool scan_lexeme(Lexer* lexer, Lexeme* lexeme);
 Token* next_token(Lexer* lexer);
 void free_lexer(Lexer* lexer);
 
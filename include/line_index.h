@@ -0,0 +1,50 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Line Index Module
+ * ============================================================================
+ * 
+ * This module converts byte offsets into line:column positions. The lexer
+ * only tracks offsets; positions are needed when an error is reported, so
+ * they are computed here on demand instead of being maintained per byte.
+ * 
+ * Core Functionality:
+ * - Table of line start offsets, built lazily and only as far as the
+ *   largest offset queried so far
+ * - Newline scan 16 bytes at a time with SSE2 where available
+ * - Binary search from an offset to its line
+ * 
+ * The index never reads the source at or past the offset it is asked
+ * about, so it can be used on a buffer that is still being filled as long
+ * as the queried offsets belong to the filled part. Lines and columns are
+ * 1-based and a column counts bytes, as the lexer always has.
+ * 
+ * An index over a sliding window (see stream.h) is moved along with
+ * line_index_rebase(), which first scans every line start before the new
+ * base: offsets that have slid out of the window are then answered from
+ * the table alone.
+ * 
+ * ============================================================================
+ */
+
+#ifndef LINE_INDEX_H
+    #define LINE_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct {
+    const char* source;
+    size_t base;
+    size_t* line_starts;
+    size_t line_count;
+    size_t capacity;
+    size_t scanned;
+} LineIndex;
+
+LineIndex* create_line_index(const char* source);
+bool line_index_rebase(LineIndex* index, const char* source, size_t base);
+bool line_index_position(LineIndex* index, size_t offset, int* line, int* column);
+int line_index_line(LineIndex* index, size_t offset);
+void free_line_index(LineIndex* index);
+
+#endif
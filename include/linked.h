@@ -0,0 +1,48 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Linked Execution Module
+ * ============================================================================
+ *
+ * This module implements `--link`: several .pong files given in order are
+ * run as one program against a single global environment, as if they had
+ * been concatenated, without writing the concatenation anywhere.
+ *
+ * Core Functionality:
+ * - Front end in parallel: worker threads read and tokenize every file,
+ *   then parse every file into its own list of statements
+ * - Execution in order: the statements of each file run after those of
+ *   the files before it, against the interpreter's environment
+ * - Error positions as file:line:col, prefixed to parse and runtime errors
+ *   in place of the line (and column) their messages name
+ *
+ * A file can use the globals the files before it declare, so its parser
+ * must know them before any of them has executed. After tokenizing, each
+ * file's top-level declarations are collected from its token buffer (a
+ * type keyword at brace depth 0, then the name); the parser of file i
+ * starts from a clone of the environment plus the declarations of files
+ * 0..i-1, which is what it would hold after parsing them in sequence.
+ *
+ * Output is that of run() on the concatenated files: a parse error is
+ * printed once the statements before it have run, and nothing after the
+ * first error runs. In transactional mode the whole link is one
+ * transaction.
+ *
+ * ============================================================================
+ */
+
+#ifndef LINKED_H
+    #define LINKED_H
+
+#include "interpreter.h"
+
+#define LINK_MAX_FILES 256
+
+typedef enum {
+    LINK_COMPLETED,
+    LINK_READ_FAILED,
+    LINK_START_FAILED
+} LinkStatus;
+
+LinkStatus run_linked(Interpreter* interp, char** filenames, size_t count);
+
+#endif
@@ -0,0 +1,43 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Parallel Execution Module
+ * ============================================================================
+ *
+ * This module implements `--parallel[=N]`: the statements of a script are
+ * executed on N worker threads, partitioned by the global variable they
+ * touch, and their output is merged back into source order.
+ *
+ * Core Functionality:
+ * - Partitioning: every statement goes to the worker chosen by the hash of
+ *   its variable's name, so all writes to one variable run on one thread
+ *   in source order; a block, loop, copy(), reduction or concatenation
+ *   that touches several globals joins their partitions (union-find), one that touches
+ *   none is dealt round-robin
+ * - Execution: each worker runs its statements against a private
+ *   environment and writes the echo lines to a private memory stream,
+ *   noting where each statement's output ends
+ * - Merge: the per-worker outputs are copied out in statement order and
+ *   the workers' variables are declared in the interpreter's environment
+ *   in declaration order
+ *
+ * Output, executed statement count and final environment are those of
+ * run(). A runtime error stops every worker; since the workers never touch
+ * the interpreter's own environment or output, the script is then simply
+ * run again with run(), which reports the first error by statement index
+ * exactly as a serial run does (and rolls back in transactional mode).
+ * The parallel path is also skipped when the environment is not empty.
+ *
+ * ============================================================================
+ */
+
+#ifndef PARALLEL_H
+    #define PARALLEL_H
+
+#include "interpreter.h"
+
+#define PARALLEL_MAX_WORKERS 64
+
+int parallel_default_workers(void);
+void run_parallel(Interpreter* interp, char* source, int workers);
+
+#endif
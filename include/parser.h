@@ -18,6 +18,46 @@
  * The parser maintains current token state and provides lookahead
  * capabilities for complex parsing decisions and error recovery.
  * 
+ * A `{ ... }` block is parsed as a whole into a STMT_BLOCK holding its
+ * statements. Variables declared inside it are resolved through the
+ * parser's scope table to a (depth, slot) pair; globals keep depth 0 and
+ * are looked up by name in the environment.
+ * 
+ * `repeat N { ... }` is a STMT_REPEAT: the iteration count and its body,
+ * a STMT_BLOCK parsed once however many times it runs.
+ * 
+ * `int[N] name = V;` declares an int array of N elements all set to V; it
+ * is an ordinary STMT_DECLARATION whose initial value holds the array.
+ * Every other use of an array is a STMT_ARRAY: `name[i] = V;`,
+ * `fill(name, V);` and `copy(dst, src);` write the array named by `array`,
+ * while `x = sum(name);` (or min, max) reads it and stores into the int
+ * named by `other`. The built-in names are recognized only where a call is
+ * expected, so they remain valid variable names.
+ * 
+ * A string assignment whose value joins operands with `+`, or is a single
+ * string variable, is a STMT_CONCAT: `s = t + "!" + u;`. Each operand is a
+ * string literal (`text`) or a string variable (`variable`, when `text` is
+ * NULL). `append` is set when the first operand is the target itself and
+ * no later one is, so `s = s + ...;` can extend s where it is stored.
+ * 
+ * A parser created with init_parser_buffered() reads from a pre-tokenized
+ * TokenBuffer instead of the lexer: current_token then points at a reused
+ * Token whose strings belong to the buffer, and advancing is an index bump.
+ * 
+ * Tokens and statements carry only source offsets: parser_position()
+ * turns one into line:column through a LineIndex over the parser's source
+ * text, created the first time an error message needs it.
+ * 
+ * With a profiler attached (by init_parser_profiled(), before the first
+ * token is read), every token pulled from the lexer and every declaration
+ * or assignment parsed is timed and charged to its source line.
+ * 
+ * A parser created with init_parser_source() pulls heap Tokens from a
+ * callback and runs ahead of execution, so it cannot look globals up in the
+ * live environment: it records every global declaration in its own symbol
+ * environment instead (a global keeps the type of its first declaration,
+ * and a redeclaration is rejected at execution time).
+ * 
  * ============================================================================
  */
 
@@ -25,52 +65,134 @@
     #define PARSER_H
 
 #include "lexer.h"
+#include "token_buffer.h"
 #include "environment.h"
+#include "scope.h"
+#include "line_index.h"
 
 typedef enum {
     STMT_DECLARATION,
     STMT_ASSIGNMENT,
-    STMT_EXPRESSION
+    STMT_EXPRESSION,
+    STMT_BLOCK,
+    STMT_REPEAT,
+    STMT_ARRAY,
+    STMT_CONCAT
 } StatementType;
 
 typedef struct {
     char* var_name;
     ValueType var_type;
     Value* initial_value;
+    int depth;
+    int slot;
 } DeclarationStatement;
 
 typedef struct {
     char* var_name;
     Value* new_value;
+    int depth;
+    int slot;
 } AssignmentStatement;
 
+struct Statement;
+
+typedef struct {
+    struct Statement** statements;
+    size_t count;
+    int frame_size;
+} BlockStatement;
+
+typedef struct {
+    int count;
+    struct Statement* body;
+} RepeatStatement;
+
+typedef enum {
+    ARRAY_SET,
+    ARRAY_FILL,
+    ARRAY_COPY,
+    ARRAY_SUM,
+    ARRAY_MIN,
+    ARRAY_MAX
+} ArrayOperation;
+
+typedef struct {
+    char* name;
+    int depth;
+    int slot;
+} VariableReference;
+
+typedef struct {
+    ArrayOperation operation;
+    VariableReference array;
+    VariableReference other;
+    size_t index;
+    int value;
+} ArrayStatement;
+
+typedef struct {
+    char* text;
+    VariableReference variable;
+} ConcatOperand;
+
+typedef struct {
+    VariableReference target;
+    ConcatOperand* operands;
+    size_t count;
+    bool append;
+} ConcatStatement;
+
 typedef union {
     DeclarationStatement declaration;
     AssignmentStatement assignment;
+    BlockStatement block;
+    RepeatStatement repeat;
+    ArrayStatement array;
+    ConcatStatement concat;
 } StatementData;
 
-typedef struct {
+typedef struct Statement {
     StatementType type;
     StatementData data;
-    int line;
-    int column;
+    size_t offset;
 } Statement;
 
+typedef Token* (*TokenSource)(void* context);
+
 typedef struct {
     Lexer* lexer;
+    TokenBuffer* tokens;
+    TokenSource source;
+    void* source_context;
+    bool records_globals;
+    const char* text;
+    LineIndex* lines;
+    struct Profiler* profiler;
+    size_t token_index;
+    Token buffered_token;
     Token* current_token;
     Environment* env;
+    ScopeTable* scopes;
     bool has_error;
     char error_message[256];
 } Parser;
 
 Parser* init_parser(Lexer* lexer, Environment* env);
+Parser* init_parser_profiled(Lexer* lexer, Environment* env, struct Profiler* profiler);
+Parser* init_parser_buffered(TokenBuffer* tokens, Environment* env);
+Parser* init_parser_source(TokenSource source, void* context, const char* text,
+                           Environment* symbols);
+TokenType peek_token_type(Parser* parser, size_t ahead);
 Statement* parse_declaration(Parser* parser);
 Statement* parse_assignment(Parser* parser);
+Statement* parse_block(Parser* parser);
+Statement* parse_repeat(Parser* parser);
 bool expect_token(Parser* parser, TokenType expected);
 void advance_token(Parser* parser);
 Statement* parse_statement(Parser* parser);
 void free_parser(Parser* parser);
+void parser_position(Parser* parser, size_t offset, int* line, int* column);
 void free_statement(Statement* stmt);
 
 #endif
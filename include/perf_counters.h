@@ -0,0 +1,80 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Performance Counter Module
+ * ============================================================================
+ *
+ * This module implements `--perf-counters[=FILE]`: CPU performance counters
+ * read around each phase of a run (read, lex, parse, execute) and reported
+ * per phase as JSON, so a change to the layout of a Token or an Environment
+ * can be judged by its cache misses and not only by its wall-clock time.
+ *
+ * Core Functionality:
+ * - One perf_event_open() group counting cycles, instructions, branch
+ *   misses, L1 data cache read misses and last-level cache misses in user
+ *   space; members the CPU does not offer are left out of the group
+ * - Graceful degradation: when the kernel denies hardware events (no PMU,
+ *   perf_event_paranoid, a container) the group counts the software events
+ *   task-clock, page faults, context switches and CPU migrations instead,
+ *   and when it denies those too only wall-clock time is reported
+ * - run_counted(), a run() whose phases are strictly sequential: the source
+ *   is tokenized into a TokenBuffer, every statement is parsed, and then
+ *   they are executed, each phase between one counter reset and one read
+ *
+ * run() interleaves lexing, parsing and executing per statement; reading
+ * the counters at every switch would cost a system call per token, and
+ * the kernel work would pollute the very caches being measured. Parsing
+ * ahead is done against a clone of the environment, as the JIT and the
+ * parallel engine do, and the output, statement count, errors and
+ * transactional rollback are those of run().
+ *
+ * Counts from a group the kernel had to multiplex are scaled by the ratio
+ * of its enabled to running time, as perf stat does.
+ *
+ * ============================================================================
+ */
+
+#ifndef PERF_COUNTERS_H
+    #define PERF_COUNTERS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "interpreter.h"
+
+#define PERF_MAX_EVENTS 5
+
+typedef enum {
+    PERF_PHASE_READ,
+    PERF_PHASE_LEX,
+    PERF_PHASE_PARSE,
+    PERF_PHASE_EXECUTE,
+    PERF_PHASE_COUNT
+} PerfPhase;
+
+typedef enum {
+    PERF_SOURCE_HARDWARE,
+    PERF_SOURCE_SOFTWARE,
+    PERF_SOURCE_NONE
+} PerfSource;
+
+typedef struct PerfCounters {
+    PerfSource source;
+    int hardware_error;
+    int leader;
+    int fds[PERF_MAX_EVENTS];
+    const char* names[PERF_MAX_EVENTS];
+    size_t event_count;
+    uint64_t values[PERF_PHASE_COUNT][PERF_MAX_EVENTS];
+    uint64_t wall_ns[PERF_PHASE_COUNT];
+    uint64_t started_ns;
+    uint64_t time_enabled;
+    uint64_t time_running;
+} PerfCounters;
+
+PerfCounters* create_perf_counters(void);
+void perf_phase_begin(PerfCounters* counters);
+void perf_phase_end(PerfCounters* counters, PerfPhase phase);
+void print_perf_counters(const PerfCounters* counters, FILE* stream);
+void free_perf_counters(PerfCounters* counters);
+void run_counted(Interpreter* interp, char* source, PerfCounters* counters);
+
+#endif
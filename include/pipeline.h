@@ -0,0 +1,46 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Pipelined Execution Module
+ * ============================================================================
+ * 
+ * This module implements `--pipeline`: the four stages of run() execute
+ * concurrently on their own threads instead of one after another.
+ * 
+ * Core Functionality:
+ * - Reader thread: reads the file in chunks with sequential read-ahead
+ *   and publishes how many bytes are ready
+ * - Lexer thread: lexes the ready prefix into batches of heap Tokens
+ * - Parser thread: parses token batches into batches of Statements
+ * - Executor (calling thread): executes statements in source order
+ * 
+ * Stages are linked by bounded SPSC rings (see ring.h) carrying batches of
+ * PIPELINE_BATCH_SIZE items, so at most PIPELINE_RING_CAPACITY batches are
+ * in flight between two stages whatever the size of the script.
+ * 
+ * Output is identical to run(): a parse error travels down the pipeline
+ * behind the statements that precede it and is printed by the executor
+ * only once they have run, and a runtime error closes the rings so the
+ * earlier stages stop without printing anything.
+ * 
+ * ============================================================================
+ */
+
+#ifndef PIPELINE_H
+    #define PIPELINE_H
+
+#include "interpreter.h"
+
+#define PIPELINE_BATCH_SIZE 256
+#define PIPELINE_RING_CAPACITY 16
+#define PIPELINE_READ_CHUNK (64 * 1024)
+
+typedef enum {
+    PIPELINE_COMPLETED,
+    PIPELINE_EMPTY_SOURCE,
+    PIPELINE_READ_FAILED,
+    PIPELINE_START_FAILED
+} PipelineStatus;
+
+PipelineStatus run_pipelined(Interpreter* interp, const char* filename);
+
+#endif
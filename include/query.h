@@ -0,0 +1,51 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Query Module
+ * ============================================================================
+ *
+ * This module implements `--query=NAMES`: it answers the final values of a
+ * few global variables without executing the script.
+ *
+ * Core Functionality:
+ * - Index: one forward pass of the allocation-free lexer records where
+ *   every top-level statement starts and checks that each statement is
+ *   well formed (a declaration or assignment of a literal, or a balanced
+ *   block of them) and would run: every name assigned is declared in
+ *   scope with its literal's type, and none is declared twice in a scope
+ * - Backward scan: statements are visited from the last one, reading only
+ *   their first tokens; the last write to each queried variable supplies
+ *   its value, and every earlier write must have the same type and end at
+ *   exactly one top-level declaration. A block is lexed only when its text
+ *   mentions a queried name; only its writes to globals count, but its
+ *   local declarations and writes of queried names are checked too
+ * - Fallback: when any of these checks fails, or the interpreter already
+ *   holds variables, the script is executed in full with its output
+ *   discarded, so the query reports the error run() would stop at (or
+ *   the values when the doubt was unfounded)
+ *
+ * Either way the answers end up in the interpreter's global environment,
+ * where a name that the script never declares is simply missing.
+ *
+ * ============================================================================
+ */
+
+#ifndef QUERY_H
+    #define QUERY_H
+
+#include "interpreter.h"
+
+typedef enum {
+    QUERY_INDEXED,
+    QUERY_EXECUTED,
+    QUERY_FAILED
+} QueryMethod;
+
+typedef struct Query Query;
+
+Query* create_query(const char* names);
+size_t query_count(const Query* query);
+char* query_name(const Query* query, size_t index);
+QueryMethod run_query(Interpreter* interp, Query* query, char* source);
+void free_query(Query* query);
+
+#endif
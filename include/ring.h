@@ -0,0 +1,51 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Single-Producer/Single-Consumer Ring Module
+ * ============================================================================
+ * 
+ * This module implements the bounded lock-free queue that links the stages
+ * of the pipelined front end. Exactly one thread pushes and exactly one
+ * thread pops; the two indices are only ever written by their owner and
+ * published with release/acquire ordering, so no lock is taken.
+ * 
+ * Core Functionality:
+ * - Non-blocking ring_try_push() / ring_try_pop()
+ * - Blocking ring_push() / ring_pop() that yield the CPU while waiting
+ * - Closing from either side: the producer closes after its last item, the
+ *   consumer closes to tell the producer to stop early
+ * 
+ * A full ring blocks the producer, which is the backpressure that keeps a
+ * fast stage from running arbitrarily far ahead of a slow one.
+ * 
+ * ============================================================================
+ */
+
+#ifndef RING_H
+    #define RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define RING_CACHE_LINE 64
+
+typedef struct {
+    void** slots;
+    size_t mask;
+    char head_pad[RING_CACHE_LINE];
+    size_t head;
+    char tail_pad[RING_CACHE_LINE];
+    size_t tail;
+    char closed_pad[RING_CACHE_LINE];
+    int closed;
+} SpscRing;
+
+SpscRing* create_ring(size_t capacity);
+bool ring_try_push(SpscRing* ring, void* item);
+bool ring_try_pop(SpscRing* ring, void** item);
+bool ring_push(SpscRing* ring, void* item);
+void* ring_pop(SpscRing* ring);
+void ring_close(SpscRing* ring);
+bool ring_is_closed(SpscRing* ring);
+void free_ring(SpscRing* ring, void (*free_item)(void* item));
+
+#endif
@@ -0,0 +1,39 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Round-Robin Scheduler Module
+ * ============================================================================
+ *
+ * This module interleaves many scripts on one thread. Each script runs in
+ * its own Interpreter and is advanced with run_step() one time slice at a
+ * time, in the order the scripts were added.
+ *
+ * Core Functionality:
+ * - scheduler_add() starts a run and queues it behind the others
+ * - scheduler_tick() gives the next queued run one slice and returns its
+ *   Interpreter, so an event loop can do one bounded piece of work per
+ *   iteration and flush that interpreter's output
+ * - scheduler_run() ticks until every run has finished
+ *
+ * A run that finishes or fails leaves the queue; the others keep their
+ * place. The scheduler owns neither the interpreters nor the sources,
+ * which must outlive their runs; runs still queued when the scheduler is
+ * freed stay parked on their interpreters until free_interpreter().
+ *
+ * ============================================================================
+ */
+
+#ifndef SCHEDULER_H
+    #define SCHEDULER_H
+
+#include "interpreter.h"
+
+typedef struct Scheduler Scheduler;
+
+Scheduler* create_scheduler(StepBudget slice);
+bool scheduler_add(Scheduler* scheduler, Interpreter* interp, char* source);
+size_t scheduler_pending(const Scheduler* scheduler);
+Interpreter* scheduler_tick(Scheduler* scheduler);
+void scheduler_run(Scheduler* scheduler);
+void free_scheduler(Scheduler* scheduler);
+
+#endif
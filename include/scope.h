@@ -0,0 +1,76 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Block Scope Module
+ * ============================================================================
+ * 
+ * This module implements block scoping for the .pong language. Variables
+ * declared inside `{ ... }` live in a flat frame on a contiguous value stack
+ * instead of in the global environment.
+ * 
+ * Core Functionality:
+ * - Parse-time scope table resolving block variables to (depth, slot)
+ * - Runtime value stack holding one contiguous frame per active block
+ * - O(1) frame entry and exit by moving the stack pointer
+ * - Release of a frame's strings when its block is left
+ * 
+ * Depth 0 is the global scope, which stays in the name-indexed Environment.
+ * Depths 1 and above are block frames: every declaration is given the next
+ * free slot of its block's frame when it is parsed, so at runtime a variable
+ * is found with frame_bases[depth] + slot and no name comparison at all.
+ * 
+ * Slot strings are plain strdup'd buffers until append_local() extends one:
+ * it then moves into the stack's own StringHeap (marked pooled), where
+ * further appends grow it geometrically.
+ * 
+ * ============================================================================
+ */
+
+#ifndef SCOPE_H
+    #define SCOPE_H
+
+#include "types.h"
+#include "string_heap.h"
+
+#define MAX_BLOCK_DEPTH 64
+#define GLOBAL_DEPTH 0
+
+typedef struct {
+    char* name;
+    ValueType type;
+    int depth;
+    int slot;
+} ScopeEntry;
+
+typedef struct {
+    ScopeEntry* entries;
+    size_t count;
+    size_t capacity;
+    int depth;
+    int frame_sizes[MAX_BLOCK_DEPTH + 1];
+} ScopeTable;
+
+typedef struct {
+    Value* slots;
+    size_t top;
+    size_t capacity;
+    int depth;
+    size_t frame_bases[MAX_BLOCK_DEPTH + 1];
+    StringHeap* strings;
+} ValueStack;
+
+ScopeTable* create_scope_table(void);
+bool scope_enter(ScopeTable* table);
+int scope_leave(ScopeTable* table);
+ScopeEntry* scope_declare(ScopeTable* table, char* name, ValueType type);
+ScopeEntry* scope_resolve(ScopeTable* table, char* name);
+void free_scope_table(ScopeTable* table);
+
+ValueStack* create_value_stack(void);
+bool push_frame(ValueStack* stack, int frame_size);
+void pop_frame(ValueStack* stack);
+Value* frame_slot(ValueStack* stack, int depth, int slot);
+bool append_local(ValueStack* stack, int depth, int slot, const char* text, size_t length);
+void release_slot_string(Value* slot);
+void free_value_stack(ValueStack* stack);
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Streaming Input Module
+ * ============================================================================
+ *
+ * This module runs scripts stored compressed (.pong.gz, .pong.zst) straight
+ * from the archive: the decompressed text is lexed and executed chunk by
+ * chunk and never exists in memory as a whole.
+ *
+ * Core Functionality:
+ * - SourceStream: reads a file as plain text, gzip or zstd, recognized by
+ *   its first bytes; gzip needs zlib and zstd needs libzstd, each compiled
+ *   in only when the build found it (HAVE_ZLIB, HAVE_ZSTD)
+ * - run_streamed(): lexes a window of decompressed text that slides forward
+ *   as tokens are consumed and executes each statement once it is parsed
+ * - read_source(): the whole decompressed text, for the modes that need
+ *   all of it at once (line profiling, token buffer, JIT, parallel, C
+ *   translation)
+ *
+ * The window starts at STREAM_WINDOW bytes and only grows to hold a single
+ * token (with the blanks before it) longer than that. A token that reaches
+ * the end of the window before the end of the input may be incomplete, so
+ * it is lexed again once the window has been refilled, as in the pipelined
+ * mode. Token offsets are absolute; the line index used for error messages
+ * is rebased as the window slides (see line_index.h).
+ *
+ * Output, errors and executed statement count are those of run(). A
+ * corrupt or truncated archive stops the run with "Read error: ..." after
+ * the statements that preceded the damage, and rolls back in
+ * transactional mode.
+ *
+ * ============================================================================
+ */
+
+#ifndef STREAM_H
+    #define STREAM_H
+
+#include "interpreter.h"
+
+#define STREAM_WINDOW (64 * 1024)
+#define STREAM_INPUT_CHUNK (64 * 1024)
+
+typedef enum {
+    SOURCE_PLAIN,
+    SOURCE_GZIP,
+    SOURCE_ZSTD
+} SourceFormat;
+
+typedef enum {
+    STREAM_COMPLETED,
+    STREAM_EMPTY_SOURCE,
+    STREAM_READ_FAILED,
+    STREAM_START_FAILED
+} StreamStatus;
+
+typedef struct SourceStream SourceStream;
+
+size_t source_extension_length(const char* filename);
+bool is_compressed_source_name(const char* filename);
+SourceStream* open_source_stream(const char* filename);
+SourceFormat source_stream_format(const SourceStream* stream);
+bool read_source_stream(SourceStream* stream, char* buffer, size_t size, size_t* produced);
+const char* source_stream_error(const SourceStream* stream);
+void close_source_stream(SourceStream* stream);
+char* read_source(char* filename);
+StreamStatus run_streamed(Interpreter* interp, const char* filename);
+
+#endif
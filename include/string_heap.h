@@ -0,0 +1,94 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - String Heap Module
+ * ============================================================================
+ * 
+ * This module implements the storage used for string values held by an
+ * environment, in place of one strdup'd buffer per Value.
+ * 
+ * Core Functionality:
+ * - Power-of-two size classes from 16 to 2048 bytes, each carved out of
+ *   its own 64 KB slabs, with a free list per class
+ * - Length-prefixed blocks: the length is read from the block header, so
+ *   no strlen() is needed to copy or compare sizes
+ * - In-place overwrite when the new text fits the block's size class
+ * - Larger strings in individually allocated, linked blocks with the same
+ *   header
+ * - Appending in place, with geometric growth when the block is full
+ * - Live, used and reserved byte counters for fragmentation statistics
+ * 
+ * The string pointer handed out points at the NUL-terminated text right
+ * after the header, so pooled strings are read like any other C string.
+ * Each header records its heap, which lets string_heap_release() return a
+ * block without being told where it came from.
+ * 
+ * string_heap_append() returns the string's new address (it may have
+ * moved), or NULL with `current` untouched if it could not grow. The text
+ * appended must not point into `current` itself.
+ * 
+ * A heap is not thread-safe; every environment owns its own.
+ * 
+ * ============================================================================
+ */
+
+#ifndef STRING_HEAP_H
+    #define STRING_HEAP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define STRING_HEAP_MIN_CLASS 16
+#define STRING_HEAP_CLASS_COUNT 8
+#define STRING_HEAP_SLAB_SIZE (64 * 1024)
+
+struct StringHeap;
+
+typedef struct {
+    uint32_t length;
+    uint32_t capacity;
+    struct StringHeap* heap;
+} StringHeader;
+
+typedef struct StringSlab {
+    struct StringSlab* next;
+    size_t size;
+} StringSlab;
+
+typedef struct StringLarge {
+    struct StringLarge* prev;
+    struct StringLarge* next;
+} StringLarge;
+
+typedef struct StringHeap {
+    StringSlab* slabs;
+    size_t slab_count;
+    StringLarge* large_blocks;
+    char* free_lists[STRING_HEAP_CLASS_COUNT];
+    char* carve[STRING_HEAP_CLASS_COUNT];
+    size_t carve_left[STRING_HEAP_CLASS_COUNT];
+    size_t live_strings;
+    size_t live_bytes;
+    size_t used_bytes;
+    size_t reserved_bytes;
+} StringHeap;
+
+typedef struct {
+    size_t live_strings;
+    size_t live_bytes;
+    size_t used_bytes;
+    size_t reserved_bytes;
+    size_t slab_count;
+    double fragmentation;
+} StringHeapStats;
+
+StringHeap* create_string_heap(void);
+char* string_heap_alloc(StringHeap* heap, const char* text, size_t length);
+char* string_heap_assign(StringHeap* heap, char* current, const char* text, size_t length);
+char* string_heap_append(StringHeap* heap, char* current, const char* text, size_t length);
+void string_heap_release(char* string);
+size_t string_heap_length(const char* string);
+void string_heap_stats(const StringHeap* heap, StringHeapStats* stats);
+void free_string_heap(StringHeap* heap);
+
+#endif
@@ -24,7 +24,7 @@
 
 #include "types.h"
 
-Token* create_token(TokenType type, void* value, int line, int col);
+Token* create_token(TokenType type, void* value, size_t offset);
 void free_token(Token* token);
 void print_token(Token* token);
 bool is_keyword(char* str);
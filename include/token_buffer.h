@@ -0,0 +1,49 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Token Buffer Module
+ * ============================================================================
+ * 
+ * This module tokenizes a whole source file up front into a packed
+ * structure-of-arrays buffer, as an alternative to the one-heap-Token-at-a-
+ * time stream the parser normally consumes.
+ * 
+ * Core Functionality:
+ * - Single pass tokenization into dense parallel arrays
+ * - One byte per token type, 32-bit source offset and 32-bit value
+ * - Identifier and string literal text interned in one contiguous pool
+ * 
+ * A token costs 9 bytes (against a 24-byte heap Token plus its allocator
+ * overhead and string copy), the parser walks it by index with free
+ * lookahead, and no allocation happens per token. Numbers and characters
+ * are stored directly in the value array; for identifiers and string
+ * literals the value is the offset of their NUL-terminated text in the pool.
+ * Like heap Tokens, buffered tokens carry only their source offset; the
+ * source pointer is kept so positions can be recovered with a LineIndex.
+ * 
+ * ============================================================================
+ */
+
+#ifndef TOKEN_BUFFER_H
+    #define TOKEN_BUFFER_H
+
+#include <stdint.h>
+#include "lexer.h"
+
+typedef struct {
+    uint8_t* types;
+    uint32_t* offsets;
+    uint32_t* values;
+    size_t count;
+    size_t capacity;
+    char* pool;
+    size_t pool_length;
+    size_t pool_capacity;
+    const char* source;
+} TokenBuffer;
+
+TokenBuffer* tokenize_source(Lexer* lexer);
+TokenType token_buffer_type(const TokenBuffer* buffer, size_t index);
+bool token_buffer_fill(const TokenBuffer* buffer, size_t index, Token* token);
+void free_token_buffer(TokenBuffer* buffer);
+
+#endif
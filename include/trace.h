@@ -0,0 +1,139 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Execution Trace Module
+ * ============================================================================
+ *
+ * This module implements `--trace=file.ptrace`: a compact binary journal
+ * of every declaration and assignment the interpreter executes, and the
+ * reader the `pong-trace` tool decodes it with.
+ *
+ * Core Functionality:
+ * - One record per executed statement: statement index, source offset,
+ *   variable, scope depth, type and value
+ * - Variable names and string values written once into name and literal
+ *   pools and referenced by id afterwards
+ * - End-of-run and rollback records, so a trace states how the run ended
+ * - Sequential decoding with names and literals resolved
+ *
+ * File format: the 8-byte header "PTRC", version, three zero bytes, then a
+ * stream of records, each a tag byte followed by LEB128 varints:
+ *
+ *   0x01 NAME      length, bytes                (next name id)
+ *   0x02 LITERAL   length, bytes                (next literal id)
+ *   0x10|type DECLARE, 0x20|type ASSIGN, 0x40|type APPEND
+ *                  index delta, offset delta, name id, depth, value
+ *   0x30 END       executed statements, failed (0 or 1)
+ *   0x31 ROLLBACK  changes undone
+ *
+ * The index delta counts statements skipped since the previous record and
+ * is 0 in a straight run; the offset delta is from the previous record's
+ * source offset, a zigzag varint because a `repeat` body runs its
+ * statements again from a lower offset (version 1 wrote it unsigned and
+ * lost those). Values are a zigzag varint for int, a varint code point
+ * for char (one byte for ASCII) and a literal id for string, so a typical
+ * record is 5 to 7 bytes. An int[N] array is recorded by its length alone
+ * (the reader returns it in the event's count): a record of an array says
+ * which one was written, not what it holds. An APPEND (`s = s + ...;`)
+ * records only the text appended, which keeps a string built piece by
+ * piece from landing in the literal pool once per piece at full length.
+ *
+ * Every run ends its trace with an END record, so the reader reports a
+ * file that stops before one as truncated, even at a record boundary.
+ *
+ * Records are assembled in a 1 MiB buffer flushed with write(2) when full
+ * and when the trace is closed; a write error is sticky and reported by
+ * close_trace().
+ *
+ * ============================================================================
+ */
+
+#ifndef TRACE_H
+    #define TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "types.h"
+
+#define TRACE_MAGIC "PTRC"
+#define TRACE_VERSION 2
+#define TRACE_HEADER_SIZE 8
+#define TRACE_BUFFER_SIZE (1 << 20)
+
+#define TRACE_TAG_NAME 0x01
+#define TRACE_TAG_LITERAL 0x02
+#define TRACE_TAG_DECLARE 0x10
+#define TRACE_TAG_ASSIGN 0x20
+#define TRACE_TAG_END 0x30
+#define TRACE_TAG_ROLLBACK 0x31
+#define TRACE_TAG_APPEND 0x40
+
+typedef enum {
+    TRACE_DECLARE,
+    TRACE_ASSIGN,
+    TRACE_APPEND,
+    TRACE_END,
+    TRACE_ROLLBACK
+} TraceEventKind;
+
+typedef struct {
+    char* text;
+    size_t length;
+} TracePoolEntry;
+
+typedef struct {
+    TracePoolEntry* entries;
+    size_t count;
+    size_t capacity;
+    uint32_t* buckets;
+    size_t bucket_count;
+} TracePool;
+
+typedef struct TraceWriter {
+    int fd;
+    uint8_t* buffer;
+    size_t used;
+    bool failed;
+    TracePool names;
+    TracePool literals;
+    uint64_t next_index;
+    uint64_t last_offset;
+    uint64_t bytes_written;
+} TraceWriter;
+
+typedef struct {
+    TraceEventKind kind;
+    uint64_t index;
+    uint64_t offset;
+    const char* name;
+    size_t name_id;
+    uint64_t depth;
+    Value value;
+    uint64_t count;
+    bool failed;
+} TraceEvent;
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t position;
+    TracePool names;
+    TracePool literals;
+    uint64_t next_index;
+    uint64_t last_offset;
+    bool ended;
+    char error_message[256];
+} TraceReader;
+
+TraceWriter* open_trace(const char* path);
+void trace_statement(TraceWriter* trace, TraceEventKind kind, int index, size_t offset,
+                     const char* name, int depth, const Value* value);
+void trace_end(TraceWriter* trace, int executed, bool failed);
+void trace_rollback(TraceWriter* trace, size_t undone);
+bool close_trace(TraceWriter* trace);
+
+TraceReader* open_trace_reader(const char* path);
+bool trace_next(TraceReader* reader, TraceEvent* event);
+void free_trace_reader(TraceReader* reader);
+
+#endif
@@ -9,11 +9,18 @@
  * 
  * Core Components:
  * - TokenType: Enumeration of all possible token types in the language
- * - ValueType: Enumeration of supported data types (int, char, string)
+ * - ValueType: Enumeration of supported data types (int, char, string,
+ *   int[N])
  * - Value: Union structure for storing typed values
  * - Variable: Structure representing a named variable with its value
  * - Token: Structure representing a lexical token with metadata
  * 
+ * A string Value is either the sole owner of a malloc'd buffer or, with
+ * `pooled` set, holds a block of an environment's string heap (see
+ * string_heap.h); free_value() releases either kind correctly. A char
+ * holds a Unicode code point and is printed UTF-8 encoded. An int[N] Value
+ * always owns its IntArray (see int_array.h), which copy_value() duplicates.
+ * 
  * Constants define maximum sizes and error codes for robust error handling.
  * 
  * ============================================================================
@@ -22,12 +29,15 @@
 #ifndef TYPES_H
     #define TYPES_H
 
+#include <stdio.h>
+#include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
 
 #define MAX_VARIABLE_NAME 256
 #define MAX_STRING_LENGTH 1024
 #define MAX_IDENTIFIER_LENGTH 256
+#define MAX_ARRAY_LENGTH (1 << 24)
 
 #define ERROR_SUCCESS 0
 #define ERROR_MEMORY_ALLOCATION 1
@@ -60,24 +70,32 @@ typedef enum {
     TOKEN_NUMBER,
     TOKEN_CHAR_LITERAL,
     TOKEN_STRING_LITERAL,
-    TOKEN_UNKNOWN
+    TOKEN_UNKNOWN,
+    TOKEN_INVALID_UTF8,
+    TOKEN_KEYWORD_REPEAT,
+    TOKEN_LBRACKET,
+    TOKEN_RBRACKET,
+    TOKEN_COMMA
 } TokenType;
 
 typedef enum {
     TYPE_INT,
     TYPE_CHAR,
-    TYPE_STRING
+    TYPE_STRING,
+    TYPE_INT_ARRAY
 } ValueType;
 
 typedef union {
     int int_val;
-    char char_val;
+    uint32_t char_val;
     char* string_val;
+    struct IntArray* array_val;
 } ValueData;
 
 typedef struct {
     ValueType type;
     ValueData data;
+    bool pooled;
 } Value;
 
 typedef struct {
@@ -87,7 +105,7 @@ typedef struct {
 
 typedef union {
     int int_val;
-    char char_val;
+    uint32_t char_val;
     char* string_val;
     char* identifier;
 } TokenValue;
@@ -95,13 +113,14 @@ typedef union {
 typedef struct {
     TokenType type;
     TokenValue value;
-    int line;
-    int column;
+    size_t offset;
 } Token;
 
 Value* init_value(ValueType type);
 void free_value(Value* val);
 Value* copy_value(Value* src);
 void print_value(Value* val);
+void fprint_value(FILE* stream, Value* val);
+void print_code_point(FILE* stream, uint32_t code_point);
 
 #endif
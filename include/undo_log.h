@@ -0,0 +1,51 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Undo Log Module
+ * ============================================================================
+ * 
+ * This module implements the append-only undo log behind transactional
+ * execution. While a log is attached to an environment, set_variable()
+ * records every change instead of destroying the previous state, so a
+ * failed run can be rolled back and a successful one committed.
+ * 
+ * Core Functionality:
+ * - Recording of variable creations and overwrites
+ * - Rollback in reverse order, proportional to the number of writes
+ * - Commit by releasing the retained old values
+ * 
+ * Overwrites store the previous Value pointer itself rather than a copy,
+ * so logging costs one entry append per write and no allocation beyond
+ * the occasional growth of the entry array.
+ * 
+ * ============================================================================
+ */
+
+#ifndef UNDO_LOG_H
+    #define UNDO_LOG_H
+
+#include "environment.h"
+
+typedef enum {
+    UNDO_CREATED,
+    UNDO_OVERWRITTEN
+} UndoKind;
+
+typedef struct {
+    UndoKind kind;
+    Variable* variable;
+    Value* old_value;
+} UndoEntry;
+
+typedef struct UndoLog {
+    UndoEntry* entries;
+    size_t count;
+    size_t capacity;
+} UndoLog;
+
+UndoLog* create_undo_log(void);
+bool undo_log_record(UndoLog* log, UndoKind kind, Variable* variable, Value* old_value);
+size_t undo_log_rollback(UndoLog* log, Environment* env);
+void undo_log_commit(UndoLog* log);
+void free_undo_log(UndoLog* log);
+
+#endif
@@ -0,0 +1,35 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - UTF-8 Module
+ * ============================================================================
+ * 
+ * This module implements the UTF-8 handling of the lexer and of value
+ * printing: .pong sources are UTF-8, string literals keep their bytes as
+ * written, and a char holds one Unicode code point.
+ * 
+ * Core Functionality:
+ * - Validation of a byte range, skipping ASCII 16 bytes at a time with
+ *   SSE2 (8 at a time without it) and decoding only multi-byte sequences
+ * - Strict decoding of one sequence: overlong forms, surrogates, code
+ *   points above U+10FFFF and stray continuation bytes are rejected
+ * - Encoding of a code point
+ * 
+ * Validation costs one compare per 16 bytes of ASCII, so sources that are
+ * mostly ASCII are validated at close to the speed of copying them.
+ * 
+ * ============================================================================
+ */
+
+#ifndef UTF8_H
+    #define UTF8_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define UTF8_MAX_SEQUENCE 4
+
+size_t utf8_validate(const char* text, size_t length);
+size_t utf8_decode(const char* text, size_t length, uint32_t* code_point);
+size_t utf8_encode(uint32_t code_point, char* out);
+
+#endif
@@ -12,6 +12,7 @@
  * - Standardized error reporting with position information
  * - Memory allocation wrappers with error checking
  * - String duplication with validation
+ * - Resident set size of the process for memory statistics
  * - Cross-platform compatibility helpers
  * 
  * These utilities ensure consistent error handling and memory management
@@ -23,12 +24,15 @@
 #ifndef UTILS_H
     #define UTILS_H
 
+#include <stdio.h>
 #include <stddef.h>
 
 char* read_file(char* filename);
 void error(char* message, int line, int col);
+void report_error(FILE* stream, char* message, int line, int col);
 void* safe_malloc(size_t size);
 char* safe_strdup(char* str);
 void print_usage(char* program_name);
+size_t resident_set_bytes(void);
 
 #endif
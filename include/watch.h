@@ -0,0 +1,38 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Watch Mode Module
+ * ============================================================================
+ * 
+ * This module implements `--watch`: the script is executed once, then the
+ * file is polled for changes and only the part affected by an edit is
+ * re-executed.
+ * 
+ * Core Functionality:
+ * - Recording of every top-level statement's start position
+ * - Periodic environment checkpoints during execution
+ * - Detection of the first changed byte between two versions of the file
+ * - Resumption from the nearest checkpoint before the change
+ * 
+ * After a change, the environment is restored from the last checkpoint
+ * taken before the first affected statement; the unchanged statements
+ * between that checkpoint and the edit are replayed silently, and output
+ * resumes at the first statement that can differ. At most
+ * WATCH_MAX_CHECKPOINTS checkpoints are kept: when the limit is reached
+ * every other one is dropped and the interval doubles, so memory stays
+ * bounded while the replay distance stays a small fraction of the script.
+ * 
+ * ============================================================================
+ */
+
+#ifndef WATCH_H
+    #define WATCH_H
+
+#include "interpreter.h"
+
+#define WATCH_MAX_CHECKPOINTS 64
+#define WATCH_INITIAL_INTERVAL 1024
+#define WATCH_POLL_INTERVAL_MS 100
+
+int run_watch(Interpreter* interp, char* filename, char** source);
+
+#endif
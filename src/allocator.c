@@ -0,0 +1,60 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Allocator Implementation
+ * ============================================================================
+ *
+ * Implementation of the thread-current allocator and of the wrappers too
+ * large to inline. Each wrapper tests the thread-local pointer once: NULL
+ * takes the libc path, anything else is called through its table.
+ * mem_calloc() zeroes the block itself when a table is installed, since
+ * the vtable has no calloc of its own.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "allocator.h"
+
+__thread const Allocator* thread_allocator = NULL;
+
+const Allocator* use_allocator(const Allocator* allocator) {
+    const Allocator* previous = thread_allocator;
+    thread_allocator = allocator;
+    return previous;
+}
+
+const Allocator* current_allocator(void) {
+    return thread_allocator;
+}
+
+void* mem_calloc(size_t count, size_t size) {
+    const Allocator* allocator = thread_allocator;
+    if (!allocator) {
+        return calloc(count, size);
+    }
+    if (size != 0 && count > SIZE_MAX / size) {
+        return NULL;
+    }
+    void* block = allocator->alloc(allocator->context, count * size);
+    if (block) {
+        memset(block, 0, count * size);
+    }
+    return block;
+}
+
+char* mem_strdup(const char* text) {
+    return mem_strndup(text, strlen(text));
+}
+
+char* mem_strndup(const char* text, size_t length) {
+    size_t copied = strnlen(text, length);
+    char* copy = mem_alloc(copied + 1);
+    if (copy) {
+        memcpy(copy, text, copied);
+        copy[copied] = '\0';
+    }
+    return copy;
+}
@@ -0,0 +1,781 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - C Code Generator Implementation
+ * ============================================================================
+ *
+ * Implementation of the .pong to C translator. Statements are parsed and
+ * executed one at a time exactly as execute_next() does, with the
+ * interpreter's output sent to /dev/null; each statement that executes is
+ * translated into the current chunk function, and the first failure is
+ * translated into the message the interpreter printed for it.
+ *
+ * Chunk bodies and global definitions are generated into two memory
+ * streams and assembled behind a fixed prologue once the whole script has
+ * been translated.
+ *
+ * A string variable is a Text: the characters, their length and the
+ * capacity of the buffer holding them, 0 for a literal. Concatenation
+ * mallocs a buffer and `s = s + ...` grows it geometrically, as the
+ * interpreter's string heap does; assigning over an owned buffer, or
+ * leaving the block of a local that owns one, frees it.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <spawn.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "emit_c.h"
+#include "utf8.h"
+#include "int_array.h"
+
+typedef struct {
+    Interpreter* interp;
+    FILE* body;
+    char* body_text;
+    size_t body_size;
+    FILE* globals;
+    char* globals_text;
+    size_t globals_size;
+    size_t chunk_count;
+    size_t chunk_statements;
+    int indent;
+    bool array_helpers;
+    bool text_helpers;
+} CEmitter;
+
+static void emit_string(FILE* out, const char* text);
+static const char* c_type_name(ValueType type);
+static void emit_indent(CEmitter* emitter);
+static void emit_slot(FILE* out, const char* name, int depth, int slot);
+static void emit_read(FILE* out, const char* name, int depth, int slot, ValueType type);
+static void emit_value(FILE* out, const Value* value);
+static void emit_print(FILE* out, const char* verb, const char* name, ValueType type);
+static void emit_global(CEmitter* emitter, const char* name, ValueType type);
+static void emit_report(CEmitter* emitter, const char* prefix, const char* message, bool runtime);
+static void begin_chunk(CEmitter* emitter);
+static void end_chunk(CEmitter* emitter);
+static void emit_line(CEmitter* emitter, const char* line);
+static void require_array_helpers(CEmitter* emitter);
+static size_t array_length(Interpreter* interp, const VariableReference* ref);
+static void emit_array_declaration(CEmitter* emitter, Statement* stmt);
+static bool emit_array(CEmitter* emitter, Statement* stmt);
+static void require_text_helpers(CEmitter* emitter);
+static void emit_operand(FILE* out, const ConcatOperand* operand);
+static bool emit_concat(CEmitter* emitter, Statement* stmt);
+static void emit_frees(CEmitter* emitter, BlockStatement* block);
+static bool emit_store(CEmitter* emitter, Statement* stmt);
+static bool emit_repeat(CEmitter* emitter, Statement* stmt);
+static bool emit_statement(CEmitter* emitter, Statement* stmt);
+static bool translate(CEmitter* emitter, char* source);
+static void emit_program(CEmitter* emitter, const char* filename, bool empty, FILE* out);
+
+/*
+ * Writes a C string literal. Everything outside printable ASCII, the
+ * quote, the backslash and '?' (trigraphs) is written as a three-digit
+ * octal escape so that a following digit can never extend it.
+ */
+static void emit_string(FILE* out, const char* text) {
+    fputc('"', out);
+    for (const unsigned char* c = (const unsigned char*)text; *c; c++) {
+        if (*c == '"' || *c == '\\') {
+            fputc('\\', out);
+            fputc(*c, out);
+        } else if (*c == '\n') {
+            fputs("\\n", out);
+        } else if (*c < 0x20 || *c > 0x7e || *c == '?') {
+            fprintf(out, "\\%03o", *c);
+        } else {
+            fputc(*c, out);
+        }
+    }
+    fputc('"', out);
+}
+
+static const char* c_type_name(ValueType type) {
+    switch (type) {
+        case TYPE_INT:
+            return "int";
+        case TYPE_INT_ARRAY:
+            return "int*";
+        case TYPE_STRING:
+            return "Text";
+        default:
+            return "const char*";
+    }
+}
+
+static void emit_indent(CEmitter* emitter) {
+    for (int i = 0; i < emitter->indent; i++) {
+        fputs("    ", emitter->body);
+    }
+}
+
+static void emit_slot(FILE* out, const char* name, int depth, int slot) {
+    if (depth == GLOBAL_DEPTH) {
+        fprintf(out, "g_%s", name);
+    } else {
+        fprintf(out, "l%d_%d", depth, slot);
+    }
+}
+
+/*
+ * Writes the variable as printf() takes it: a string's characters.
+ */
+static void emit_read(FILE* out, const char* name, int depth, int slot, ValueType type) {
+    emit_slot(out, name, depth, slot);
+    if (type == TYPE_STRING) {
+        fputs(".text", out);
+    }
+}
+
+static void emit_value(FILE* out, const Value* value) {
+    switch (value->type) {
+        case TYPE_INT:
+            fprintf(out, "%d", value->data.int_val);
+            break;
+        case TYPE_CHAR: {
+            char text[UTF8_MAX_SEQUENCE + 1];
+            text[utf8_encode(value->data.char_val, text)] = '\0';
+            emit_string(out, text);
+            break;
+        }
+        case TYPE_STRING: {
+            const char* text = value->data.string_val ? value->data.string_val : "";
+            fputs("(Text){", out);
+            emit_string(out, text);
+            fprintf(out, ", %zu, 0}", strlen(text));
+            break;
+        }
+        case TYPE_INT_ARRAY:
+            fputs("NULL", out);
+            break;
+    }
+}
+
+static void emit_print(FILE* out, const char* verb, const char* name, ValueType type) {
+    fprintf(out, "printf(\"%s variable '%s' = ", verb, name);
+    switch (type) {
+        case TYPE_INT:
+            fputs("%d\\n\", ", out);
+            break;
+        case TYPE_CHAR:
+            fputs("'%s'\\n\", ", out);
+            break;
+        case TYPE_STRING:
+            fputs("\\\"%s\\\"\\n\", ", out);
+            break;
+        case TYPE_INT_ARRAY:
+            fputs("\", ", out);
+            break;
+    }
+}
+
+/*
+ * A global gets a static variable and a setter that stores, prints and
+ * counts an assignment, so each assignment to it compiles to one call.
+ */
+static void emit_global(CEmitter* emitter, const char* name, ValueType type) {
+    FILE* out = emitter->globals;
+    fprintf(out, "static %s g_%s;\n\n", c_type_name(type), name);
+    fprintf(out, "static void set_g_%s(%s value) {\n", name, c_type_name(type));
+    if (type == TYPE_STRING) {
+        fprintf(out, "    release_text(&g_%s);\n", name);
+    }
+    fprintf(out, "    g_%s = value;\n    ", name);
+    emit_print(out, "Assigned", name, type);
+    fputs(type == TYPE_STRING ? "value.text);\n" : "value);\n", out);
+    fputs("    executed++;\n}\n\n", out);
+}
+
+static void emit_report(CEmitter* emitter, const char* prefix, const char* message, bool runtime) {
+    size_t length = strlen(prefix) + strlen(message) + 2;
+    char* line = malloc(length);
+    if (!line) {
+        return;
+    }
+    snprintf(line, length, "%s%s\n", prefix, message);
+    emit_indent(emitter);
+    fputs("fputs(", emitter->body);
+    emit_string(emitter->body, line);
+    fputs(", stdout);\n", emitter->body);
+    free(line);
+    if (runtime) {
+        emit_indent(emitter);
+        fputs("failure = ", emitter->body);
+        emit_string(emitter->body, message);
+        fputs(";\n", emitter->body);
+    }
+    emit_indent(emitter);
+    fputs("return false;\n", emitter->body);
+}
+
+static void begin_chunk(CEmitter* emitter) {
+    fprintf(emitter->body, "static bool chunk_%zu(void) {\n", emitter->chunk_count);
+    emitter->chunk_statements = 0;
+    emitter->indent = 1;
+}
+
+static void end_chunk(CEmitter* emitter) {
+    fputs("    return true;\n}\n\n", emitter->body);
+    emitter->chunk_count++;
+}
+
+/*
+ * Writes a statement that prints `line` as it is; used for echo lines
+ * whose every part is known when translating.
+ */
+static void emit_line(CEmitter* emitter, const char* line) {
+    emit_indent(emitter);
+    fputs("fputs(", emitter->body);
+    emit_string(emitter->body, line);
+    fputs(", stdout);\n", emitter->body);
+}
+
+/*
+ * Arrays are heap buffers handled by a few helpers, written once ahead of
+ * the first chunk that uses an array. Sums wrap like the interpreter's.
+ */
+static void require_array_helpers(CEmitter* emitter) {
+    if (emitter->array_helpers) {
+        return;
+    }
+    emitter->array_helpers = true;
+    fputs("static void fill_array(int* items, size_t length, int value) {\n"
+          "    for (size_t i = 0; i < length; i++) {\n"
+          "        items[i] = value;\n"
+          "    }\n"
+          "}\n\n"
+          "static int* new_array(size_t length, int value) {\n"
+          "    int* items = malloc(length * sizeof(int));\n"
+          "    if (!items) {\n"
+          "        fputs(\"Out of memory\\n\", stderr);\n"
+          "        exit(EXIT_FAILURE);\n"
+          "    }\n"
+          "    fill_array(items, length, value);\n"
+          "    return items;\n"
+          "}\n\n"
+          "static void copy_array(int* dst, const int* src, size_t length) {\n"
+          "    for (size_t i = 0; i < length; i++) {\n"
+          "        dst[i] = src[i];\n"
+          "    }\n"
+          "}\n\n"
+          "static int sum_array(const int* items, size_t length) {\n"
+          "    unsigned total = 0;\n"
+          "    for (size_t i = 0; i < length; i++) {\n"
+          "        total += (unsigned)items[i];\n"
+          "    }\n"
+          "    return (int)total;\n"
+          "}\n\n"
+          "static int min_array(const int* items, size_t length) {\n"
+          "    int result = items[0];\n"
+          "    for (size_t i = 1; i < length; i++) {\n"
+          "        result = items[i] < result ? items[i] : result;\n"
+          "    }\n"
+          "    return result;\n"
+          "}\n\n"
+          "static int max_array(const int* items, size_t length) {\n"
+          "    int result = items[0];\n"
+          "    for (size_t i = 1; i < length; i++) {\n"
+          "        result = items[i] > result ? items[i] : result;\n"
+          "    }\n"
+          "    return result;\n"
+          "}\n\n"
+          "static void print_array(const int* items, size_t length) {\n"
+          "    printf(\"int[%zu] {\", length);\n"
+          "    for (size_t i = 0; i < length && i < 8; i++) {\n"
+          "        printf(i ? \", %d\" : \"%d\", items[i]);\n"
+          "    }\n"
+          "    fputs(length > 8 ? \", ...}\\n\" : \"}\\n\", stdout);\n"
+          "}\n\n", emitter->globals);
+}
+
+/*
+ * The Text helpers are written once, ahead of the first string variable.
+ * concat_texts() copies the parts before it frees the target's old
+ * buffer, so a part may be the target itself.
+ */
+static void require_text_helpers(CEmitter* emitter) {
+    if (emitter->text_helpers) {
+        return;
+    }
+    emitter->text_helpers = true;
+    fputs("typedef struct {\n"
+          "    const char* text;\n"
+          "    size_t length;\n"
+          "    size_t capacity;\n"
+          "} Text;\n\n"
+          "static void release_text(Text* text) {\n"
+          "    if (text->capacity) {\n"
+          "        free((char*)text->text);\n"
+          "    }\n"
+          "}\n\n"
+          "static void concat_texts(Text* target, bool append, size_t count, const Text* parts) {\n"
+          "    Text result = append ? *target : (Text){\"\", 0, 0};\n"
+          "    size_t length = result.length;\n"
+          "    for (size_t i = 0; i < count; i++) {\n"
+          "        length += parts[i].length;\n"
+          "    }\n"
+          "    char* buffer = (char*)result.text;\n"
+          "    if (length + 1 > result.capacity) {\n"
+          "        size_t capacity = result.capacity ? result.capacity : 16;\n"
+          "        while (capacity < length + 1) {\n"
+          "            capacity *= 2;\n"
+          "        }\n"
+          "        buffer = malloc(capacity);\n"
+          "        if (!buffer) {\n"
+          "            fputs(\"Out of memory\\n\", stderr);\n"
+          "            exit(EXIT_FAILURE);\n"
+          "        }\n"
+          "        memcpy(buffer, result.text, result.length);\n"
+          "        result.capacity = capacity;\n"
+          "    }\n"
+          "    for (size_t i = 0; i < count; i++) {\n"
+          "        memcpy(buffer + result.length, parts[i].text, parts[i].length);\n"
+          "        result.length += parts[i].length;\n"
+          "    }\n"
+          "    buffer[result.length] = '\\0';\n"
+          "    if (buffer != target->text) {\n"
+          "        release_text(target);\n"
+          "    }\n"
+          "    *target = (Text){buffer, result.length, result.capacity};\n"
+          "}\n\n", emitter->globals);
+}
+
+static void emit_operand(FILE* out, const ConcatOperand* operand) {
+    if (operand->text) {
+        fputs("(Text){", out);
+        emit_string(out, operand->text);
+        fprintf(out, ", %zu, 0}", strlen(operand->text));
+    } else {
+        emit_slot(out, operand->variable.name, operand->variable.depth, operand->variable.slot);
+    }
+}
+
+static bool emit_concat(CEmitter* emitter, Statement* stmt) {
+    Interpreter* interp = emitter->interp;
+    if (!execute_concat(interp, stmt)) {
+        emit_report(emitter, "Runtime error: ", interp->error_message, true);
+        return false;
+    }
+    ConcatStatement* concat = &stmt->data.concat;
+    VariableReference* target = &concat->target;
+    FILE* body = emitter->body;
+    size_t first = concat->append ? 1 : 0;
+    require_text_helpers(emitter);
+    emit_indent(emitter);
+    fputs("concat_texts(&", body);
+    emit_slot(body, target->name, target->depth, target->slot);
+    fprintf(body, ", %s, %zu, (Text[]){", concat->append ? "true" : "false", concat->count - first);
+    for (size_t i = first; i < concat->count; i++) {
+        fputs(i > first ? ", " : "", body);
+        emit_operand(body, &concat->operands[i]);
+    }
+    fputs("});\n", body);
+    if (!concat->append) {
+        emit_indent(emitter);
+        emit_print(body, "Assigned", target->name, TYPE_STRING);
+        emit_read(body, target->name, target->depth, target->slot, TYPE_STRING);
+        fputs(");\n", body);
+    } else {
+        emit_line(emitter, "Appended \"");
+        for (size_t i = first; i < concat->count; i++) {
+            ConcatOperand* operand = &concat->operands[i];
+            emit_indent(emitter);
+            fputs("fputs(", body);
+            if (operand->text) {
+                emit_string(body, operand->text);
+            } else {
+                emit_read(body, operand->variable.name, operand->variable.depth,
+                          operand->variable.slot, TYPE_STRING);
+            }
+            fputs(", stdout);\n", body);
+        }
+        char line[MAX_VARIABLE_NAME + 32];
+        snprintf(line, sizeof(line), "\" to variable '%s'\n", target->name);
+        emit_line(emitter, line);
+    }
+    emit_indent(emitter);
+    fputs("executed++;\n", body);
+    return true;
+}
+
+/*
+ * Array lengths never change, so the length the interpreter holds while
+ * translating is the one the generated program will have.
+ */
+static size_t array_length(Interpreter* interp, const VariableReference* ref) {
+    Value* value = ref->depth == GLOBAL_DEPTH ? get_variable(interp->global_env, ref->name)
+                                              : frame_slot(interp->stack, ref->depth, ref->slot);
+    return value && value->type == TYPE_INT_ARRAY && value->data.array_val
+        ? value->data.array_val->length : 0;
+}
+
+static void emit_array_declaration(CEmitter* emitter, Statement* stmt) {
+    DeclarationStatement* decl = &stmt->data.declaration;
+    IntArray* array = decl->initial_value->data.array_val;
+    FILE* body = emitter->body;
+    require_array_helpers(emitter);
+    if (decl->depth == GLOBAL_DEPTH) {
+        fprintf(emitter->globals, "static int* g_%s;\n\n", decl->var_name);
+    }
+    emit_indent(emitter);
+    if (decl->depth != GLOBAL_DEPTH) {
+        fputs("int* ", body);
+    }
+    emit_slot(body, decl->var_name, decl->depth, decl->slot);
+    fprintf(body, " = new_array(%zu, %d);\n", array->length, array->items[0]);
+    emit_indent(emitter);
+    fprintf(body, "printf(\"Declared variable '%s' = \");\n", decl->var_name);
+    emit_indent(emitter);
+    fputs("print_array(", body);
+    emit_slot(body, decl->var_name, decl->depth, decl->slot);
+    fprintf(body, ", %zu);\n", array->length);
+    emit_indent(emitter);
+    fputs("executed++;\n", body);
+}
+
+static bool emit_array(CEmitter* emitter, Statement* stmt) {
+    Interpreter* interp = emitter->interp;
+    if (!execute_array(interp, stmt)) {
+        emit_report(emitter, "Runtime error: ", interp->error_message, true);
+        return false;
+    }
+    ArrayStatement* op = &stmt->data.array;
+    FILE* body = emitter->body;
+    size_t length = array_length(interp, &op->array);
+    char line[2 * MAX_VARIABLE_NAME + 64];
+    require_array_helpers(emitter);
+    emit_indent(emitter);
+    switch (op->operation) {
+        case ARRAY_SET:
+            emit_slot(body, op->array.name, op->array.depth, op->array.slot);
+            fprintf(body, "[%zu] = %d;\n", op->index, op->value);
+            snprintf(line, sizeof(line), "Assigned variable '%s[%zu]' = %d\n",
+                     op->array.name, op->index, op->value);
+            emit_line(emitter, line);
+            break;
+        case ARRAY_FILL:
+            fputs("fill_array(", body);
+            emit_slot(body, op->array.name, op->array.depth, op->array.slot);
+            fprintf(body, ", %zu, %d);\n", length, op->value);
+            snprintf(line, sizeof(line), "Filled array '%s' with %d\n", op->array.name, op->value);
+            emit_line(emitter, line);
+            break;
+        case ARRAY_COPY:
+            fputs("copy_array(", body);
+            emit_slot(body, op->array.name, op->array.depth, op->array.slot);
+            fputs(", ", body);
+            emit_slot(body, op->other.name, op->other.depth, op->other.slot);
+            fprintf(body, ", %zu);\n", length);
+            snprintf(line, sizeof(line), "Copied array '%s' into '%s'\n", op->other.name, op->array.name);
+            emit_line(emitter, line);
+            break;
+        default: {
+            const char* function = op->operation == ARRAY_SUM ? "sum_array"
+                                 : op->operation == ARRAY_MIN ? "min_array" : "max_array";
+            if (op->other.depth == GLOBAL_DEPTH) {
+                fprintf(body, "set_g_%s(%s(", op->other.name, function);
+                emit_slot(body, op->array.name, op->array.depth, op->array.slot);
+                fprintf(body, ", %zu));\n", length);
+                return true;
+            }
+            emit_slot(body, op->other.name, op->other.depth, op->other.slot);
+            fprintf(body, " = %s(", function);
+            emit_slot(body, op->array.name, op->array.depth, op->array.slot);
+            fprintf(body, ", %zu);\n", length);
+            emit_indent(emitter);
+            emit_print(body, "Assigned", op->other.name, TYPE_INT);
+            emit_slot(body, op->other.name, op->other.depth, op->other.slot);
+            fputs(");\n", body);
+            break;
+        }
+    }
+    emit_indent(emitter);
+    fputs("executed++;\n", body);
+    return true;
+}
+
+/*
+ * Local arrays and strings are released where their block ends, so a
+ * block run by a C loop does not leak one buffer per iteration.
+ */
+static void emit_frees(CEmitter* emitter, BlockStatement* block) {
+    for (size_t i = 0; i < block->count; i++) {
+        Statement* inner = block->statements[i];
+        if (inner->type != STMT_DECLARATION || (inner->data.declaration.var_type != TYPE_INT_ARRAY &&
+                                                inner->data.declaration.var_type != TYPE_STRING)) {
+            continue;
+        }
+        emit_indent(emitter);
+        fputs(inner->data.declaration.var_type == TYPE_STRING ? "release_text(&" : "free(",
+              emitter->body);
+        emit_slot(emitter->body, inner->data.declaration.var_name,
+                  inner->data.declaration.depth, inner->data.declaration.slot);
+        fputs(");\n", emitter->body);
+    }
+}
+
+static bool emit_store(CEmitter* emitter, Statement* stmt) {
+    Interpreter* interp = emitter->interp;
+    bool declaration = stmt->type == STMT_DECLARATION;
+    bool ok = declaration ? execute_declaration(interp, stmt) : execute_assignment(interp, stmt);
+    if (!ok) {
+        emit_report(emitter, "Runtime error: ", interp->error_message, true);
+        return false;
+    }
+    const char* name = declaration ? stmt->data.declaration.var_name : stmt->data.assignment.var_name;
+    Value* value = declaration ? stmt->data.declaration.initial_value : stmt->data.assignment.new_value;
+    int depth = declaration ? stmt->data.declaration.depth : stmt->data.assignment.depth;
+    int slot = declaration ? stmt->data.declaration.slot : stmt->data.assignment.slot;
+    FILE* body = emitter->body;
+    if (value->type == TYPE_INT_ARRAY) {
+        emit_array_declaration(emitter, stmt);
+        return true;
+    }
+    if (value->type == TYPE_STRING) {
+        require_text_helpers(emitter);
+    }
+    if (declaration && depth == GLOBAL_DEPTH) {
+        emit_global(emitter, name, value->type);
+    }
+    emit_indent(emitter);
+    if (!declaration && depth == GLOBAL_DEPTH) {
+        fprintf(body, "set_g_%s(", name);
+        emit_value(body, value);
+        fputs(");\n", body);
+        return true;
+    }
+    if (declaration && depth != GLOBAL_DEPTH) {
+        fprintf(body, "%s ", c_type_name(value->type));
+    } else if (!declaration && value->type == TYPE_STRING) {
+        fputs("release_text(&", body);
+        emit_slot(body, name, depth, slot);
+        fputs(");\n", body);
+        emit_indent(emitter);
+    }
+    emit_slot(body, name, depth, slot);
+    fputs(" = ", body);
+    emit_value(body, value);
+    fputs(";\n", body);
+    emit_indent(emitter);
+    emit_print(body, declaration ? "Declared" : "Assigned", name, value->type);
+    emit_read(body, name, depth, slot, value->type);
+    fputs(");\n", body);
+    emit_indent(emitter);
+    fputs("executed++;\n", body);
+    return true;
+}
+
+/*
+ * The body is translated (and so executed) once, inside a C loop: its
+ * first iteration is the only one that can fail.
+ */
+static bool emit_repeat(CEmitter* emitter, Statement* stmt) {
+    if (stmt->data.repeat.count <= 0) {
+        return true;
+    }
+    int level = emitter->indent;
+    emit_indent(emitter);
+    fprintf(emitter->body, "for (int repeat_%d = 0; repeat_%d < %d; repeat_%d++) {\n",
+            level, level, stmt->data.repeat.count, level);
+    emitter->indent++;
+    bool ok = emit_statement(emitter, stmt->data.repeat.body);
+    emitter->indent--;
+    emit_indent(emitter);
+    fputs("}\n", emitter->body);
+    return ok;
+}
+
+static bool emit_statement(CEmitter* emitter, Statement* stmt) {
+    if (stmt->type == STMT_REPEAT) {
+        return emit_repeat(emitter, stmt);
+    }
+    if (stmt->type == STMT_ARRAY) {
+        return emit_array(emitter, stmt);
+    }
+    if (stmt->type == STMT_CONCAT) {
+        return emit_concat(emitter, stmt);
+    }
+    if (stmt->type != STMT_BLOCK) {
+        return emit_store(emitter, stmt);
+    }
+    BlockStatement* block = &stmt->data.block;
+    Interpreter* interp = emitter->interp;
+    if (!push_frame(interp->stack, block->frame_size)) {
+        if (!interp->lines) {
+            interp->lines = create_line_index(interp->source);
+        }
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to enter block at line %d", line_index_line(interp->lines, stmt->offset));
+        emit_report(emitter, "Runtime error: ", interp->error_message, true);
+        return false;
+    }
+    emit_indent(emitter);
+    fputs("{\n", emitter->body);
+    emitter->indent++;
+    bool ok = true;
+    for (size_t i = 0; i < block->count && ok; i++) {
+        ok = emit_statement(emitter, block->statements[i]);
+    }
+    if (ok) {
+        emit_frees(emitter, block);
+    }
+    emitter->indent--;
+    emit_indent(emitter);
+    fputs("}\n", emitter->body);
+    pop_frame(interp->stack);
+    return ok;
+}
+
+static bool translate(CEmitter* emitter, char* source) {
+    Interpreter* interp = emitter->interp;
+    Execution exec;
+    if (!begin_execution(interp, &exec, source, 0)) {
+        return false;
+    }
+    begin_chunk(emitter);
+    Parser* parser = exec.parser;
+    while (parser->current_token && parser->current_token->type != TOKEN_EOF) {
+        if (parser->has_error) {
+            emit_report(emitter, "Parser error: ", parser->error_message, false);
+            break;
+        }
+        Statement* stmt = parse_statement(parser);
+        if (!stmt) {
+            if (parser->has_error) {
+                emit_report(emitter, "Parse error: ", parser->error_message, false);
+            }
+            break;
+        }
+        if (emitter->chunk_statements == EMIT_C_CHUNK_STATEMENTS) {
+            end_chunk(emitter);
+            begin_chunk(emitter);
+        }
+        emitter->chunk_statements++;
+        bool ok = emit_statement(emitter, stmt);
+        free_statement(stmt);
+        if (!ok) {
+            break;
+        }
+    }
+    end_chunk(emitter);
+    end_execution(interp, &exec);
+    interp->has_error = false;
+    return true;
+}
+
+static void emit_program(CEmitter* emitter, const char* filename, bool empty, FILE* out) {
+    fputs("/* Generated from ", out);
+    for (const char* c = filename; *c; c++) {
+        fputc(*c == '*' ? '_' : *c, out);
+    }
+    fputs(" by pong-interpreter --emit-c. */\n\n", out);
+    fputs("#include <stdbool.h>\n#include <stdio.h>\n#include <stdlib.h>\n#include <string.h>\n\n", out);
+    fputs("static int executed;\nstatic const char* failure;\n\n", out);
+    fwrite(emitter->globals_text, 1, emitter->globals_size, out);
+    fwrite(emitter->body_text, 1, emitter->body_size, out);
+    if (!empty) {
+        fputs("static bool (*const chunks[])(void) = {\n", out);
+        for (size_t i = 0; i < emitter->chunk_count; i++) {
+            fprintf(out, "    chunk_%zu,\n", i);
+        }
+        fputs("};\n\n", out);
+    }
+    fputs("int main(void) {\n", out);
+    fputs("    fputs(\"Pong Language Interpreter v1.0\\n\", stdout);\n", out);
+    fputs("    fputs(\"Loading file: \", stdout);\n", out);
+    fputs("    fputs(", out);
+    emit_string(out, filename);
+    fputs(", stdout);\n", out);
+    fputs("    fputs(\"\\n================================\\n\\n\", stdout);\n", out);
+    if (empty) {
+        fputs("    fputs(\"Warning: Source file is empty\\n\", stdout);\n", out);
+        fputs("    (void)executed;\n    (void)failure;\n", out);
+        fputs("    return EXIT_SUCCESS;\n}\n", out);
+        return;
+    }
+    fputs("    fputs(\"=== PONG INTERPRETER EXECUTION ===\\n\", stdout);\n", out);
+    fputs("    for (size_t i = 0; i < sizeof(chunks) / sizeof(chunks[0]); i++) {\n", out);
+    fputs("        if (!chunks[i]()) {\n            break;\n        }\n    }\n", out);
+    fputs("    fputs(\"=== EXECUTION COMPLETE ===\\n\", stdout);\n", out);
+    fputs("    printf(\"Executed %d statements\\n\", executed);\n", out);
+    fputs("    if (failure) {\n", out);
+    fputs("        printf(\"\\nExecution failed with error: %s\\n\", failure);\n", out);
+    fputs("        return EXIT_FAILURE;\n    }\n", out);
+    fputs("    fputs(\"\\nProgram executed successfully!\\n\", stdout);\n", out);
+    fputs("    return EXIT_SUCCESS;\n}\n", out);
+}
+
+bool emit_c_program(Interpreter* interp, const char* filename, char* source, FILE* out) {
+    if (!interp || !filename || !source || !out) {
+        return false;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    CEmitter emitter;
+    memset(&emitter, 0, sizeof(emitter));
+    emitter.interp = interp;
+    emitter.body = open_memstream(&emitter.body_text, &emitter.body_size);
+    emitter.globals = open_memstream(&emitter.globals_text, &emitter.globals_size);
+    FILE* discard = fopen("/dev/null", "w");
+    bool ok = emitter.body && emitter.globals && discard;
+    if (ok) {
+        set_interpreter_output(interp, discard);
+        bool empty = source[0] == '\0';
+        ok = empty || translate(&emitter, source);
+        set_interpreter_output(interp, NULL);
+        if (ok && fflush(emitter.body) == 0 && fflush(emitter.globals) == 0) {
+            emit_program(&emitter, filename, empty, out);
+            ok = !ferror(out);
+        } else {
+            ok = false;
+        }
+    }
+    if (!ok && !interp->has_error) {
+        snprintf(interp->error_message, sizeof(interp->error_message), "Failed to generate C code");
+        interp->has_error = true;
+    }
+    if (discard) {
+        fclose(discard);
+    }
+    if (emitter.body) {
+        fclose(emitter.body);
+    }
+    if (emitter.globals) {
+        fclose(emitter.globals);
+    }
+    free(emitter.body_text);
+    free(emitter.globals_text);
+    use_allocator(previous);
+    return ok;
+}
+
+/*
+ * The generated code is straight-line stores and printf calls that no
+ * optimisation level runs measurably faster, while -O2 inlines the
+ * setters into every call site and makes compile time grow by a large
+ * factor; -O1 without inlining keeps it proportional to the script.
+ */
+bool compile_c_program(const char* c_path, const char* binary_path) {
+    if (!c_path || !binary_path) {
+        return false;
+    }
+    const char* compiler = getenv("CC");
+    if (!compiler || compiler[0] == '\0') {
+        compiler = "cc";
+    }
+    char* argv[] = {(char*)compiler, "-O1", "-fno-inline", "-o", (char*)binary_path, (char*)c_path, NULL};
+    pid_t pid;
+    if (posix_spawnp(&pid, compiler, NULL, NULL, argv, environ) != 0) {
+        return false;
+    }
+    int status;
+    if (waitpid(pid, &status, 0) != pid) {
+        return false;
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
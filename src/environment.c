@@ -11,6 +11,11 @@
  * of existing ones. The implementation ensures proper memory cleanup and
  * provides fast existence checking for parser optimization.
  * 
+ * Frozen environments are indexed by a power-of-two open-addressed table of
+ * Variable pointers keyed by an FNV-1a hash of the name. The table is built
+ * once by freeze_env() and never written again, which is what makes reads
+ * from concurrent children safe without synchronization.
+ * 
  * ============================================================================
  */
 
@@ -18,17 +23,237 @@
 #include <stdlib.h>
 #include <string.h>
 #include "environment.h"
+#include "allocator.h"
+#include "undo_log.h"
+#include "int_array.h"
+
+static size_t hash_name(const char* name);
+static Variable* find_frozen(const Environment* env, const char* name);
+static Variable* find_variable(const Environment* env, const char* name);
+static bool ensure_strings(Environment* env);
+static size_t value_length(const Value* value);
+static Value* store_value(Environment* env, Value* src);
+static bool overwrite_array(Value* target, Value* src);
+static bool overwrite_value(Environment* env, Value* target, Value* src);
+static bool append_copy(Environment* env, char* name, const char* text, size_t length);
+
+static size_t hash_name(const char* name) {
+    size_t hash = (size_t)14695981039346656037ULL;
+    while (*name) {
+        hash ^= (unsigned char)*name++;
+        hash *= (size_t)1099511628211ULL;
+    }
+    return hash;
+}
+
+static Variable* find_frozen(const Environment* env, const char* name) {
+    size_t mask = env->frozen_capacity - 1;
+    size_t index = hash_name(name) & mask;
+    while (env->frozen_table[index]) {
+        if (strcmp(env->frozen_table[index]->name, name) == 0) {
+            return env->frozen_table[index];
+        }
+        index = (index + 1) & mask;
+    }
+    return NULL;
+}
+
+static Variable* find_variable(const Environment* env, const char* name) {
+    while (env) {
+        if (env->frozen_table) {
+            Variable* found = find_frozen(env, name);
+            if (found) {
+                return found;
+            }
+        } else {
+            VariableNode* current = env->variables;
+            while (current) {
+                if (strcmp(current->variable->name, name) == 0) {
+                    return current->variable;
+                }
+                current = current->next;
+            }
+        }
+        env = env->base;
+    }
+    return NULL;
+}
+
+static bool ensure_strings(Environment* env) {
+    if (!env->strings) {
+        env->strings = create_string_heap();
+    }
+    return env->strings != NULL;
+}
+
+static size_t value_length(const Value* value) {
+    return value->pooled ? string_heap_length(value->data.string_val)
+                         : strlen(value->data.string_val);
+}
+
+static Value* store_value(Environment* env, Value* src) {
+    if (src->type != TYPE_STRING || !src->data.string_val) {
+        return copy_value(src);
+    }
+    Value* value = mem_alloc(sizeof(Value));
+    if (!value || !ensure_strings(env)) {
+        mem_free(value);
+        return NULL;
+    }
+    value->type = TYPE_STRING;
+    value->pooled = true;
+    value->data.string_val = string_heap_alloc(env->strings, src->data.string_val,
+                                               value_length(src));
+    if (!value->data.string_val) {
+        mem_free(value);
+        return NULL;
+    }
+    return value;
+}
+
+/*
+ * An array of the same length is copied into the buffer it replaces; any
+ * other one gets a buffer of its own.
+ */
+static bool overwrite_array(Value* target, Value* src) {
+    IntArray* current = target->data.array_val;
+    IntArray* array = src->data.array_val;
+    if (current && array && current->length == array->length) {
+        int_array_copy(current, array);
+        return true;
+    }
+    IntArray* copy = NULL;
+    if (array) {
+        copy = copy_int_array(array);
+        if (!copy) {
+            return false;
+        }
+    }
+    free_int_array(current);
+    target->data.array_val = copy;
+    return true;
+}
+
+static bool overwrite_value(Environment* env, Value* target, Value* src) {
+    if (src->type == TYPE_INT_ARRAY) {
+        return overwrite_array(target, src);
+    }
+    if (src->type != TYPE_STRING) {
+        target->data = src->data;
+        return true;
+    }
+    if (!src->data.string_val) {
+        if (target->pooled) {
+            string_heap_release(target->data.string_val);
+        } else {
+            mem_free(target->data.string_val);
+        }
+        target->data.string_val = NULL;
+        target->pooled = false;
+        return true;
+    }
+    if (!ensure_strings(env)) {
+        return false;
+    }
+    char* current = target->pooled ? target->data.string_val : NULL;
+    char* text = string_heap_assign(env->strings, current, src->data.string_val,
+                                    value_length(src));
+    if (!text) {
+        return false;
+    }
+    if (!target->pooled) {
+        mem_free(target->data.string_val);
+    }
+    target->data.string_val = text;
+    target->pooled = true;
+    return true;
+}
 
 Environment* create_env(void) {
-    Environment* env = malloc(sizeof(Environment));
+    return create_child_env(NULL);
+}
+
+Environment* create_child_env(const Environment* base) {
+    Environment* env = mem_alloc(sizeof(Environment));
     if (!env) {
         return NULL;
     }
     env->variables = NULL;
     env->count = 0;
+    env->base = base;
+    env->frozen_table = NULL;
+    env->frozen_capacity = 0;
+    env->undo_log = NULL;
+    env->strings = NULL;
     return env;
 }
 
+Environment* clone_env(const Environment* env) {
+    if (!env) {
+        return NULL;
+    }
+    Environment* copy = create_child_env(env->base);
+    if (!copy) {
+        return NULL;
+    }
+    VariableNode** tail = &copy->variables;
+    for (VariableNode* current = env->variables; current; current = current->next) {
+        VariableNode* node = mem_alloc(sizeof(VariableNode));
+        Variable* variable = node ? mem_alloc(sizeof(Variable)) : NULL;
+        if (!variable) {
+            mem_free(node);
+            free_env(copy);
+            return NULL;
+        }
+        memcpy(variable->name, current->variable->name, MAX_VARIABLE_NAME);
+        variable->value = store_value(copy, current->variable->value);
+        if (!variable->value) {
+            mem_free(variable);
+            mem_free(node);
+            free_env(copy);
+            return NULL;
+        }
+        node->variable = variable;
+        node->next = NULL;
+        *tail = node;
+        tail = &node->next;
+        copy->count++;
+    }
+    return copy;
+}
+
+bool freeze_env(Environment* env) {
+    if (!env) {
+        return false;
+    }
+    if (env->frozen_table) {
+        return true;
+    }
+    size_t capacity = 8;
+    while (capacity < env->count * 2) {
+        capacity *= 2;
+    }
+    Variable** table = mem_calloc(capacity, sizeof(Variable*));
+    if (!table) {
+        return false;
+    }
+    size_t mask = capacity - 1;
+    for (VariableNode* current = env->variables; current; current = current->next) {
+        size_t index = hash_name(current->variable->name) & mask;
+        while (table[index]) {
+            index = (index + 1) & mask;
+        }
+        table[index] = current->variable;
+    }
+    env->frozen_table = table;
+    env->frozen_capacity = capacity;
+    return true;
+}
+
+bool env_is_frozen(const Environment* env) {
+    return env && env->frozen_table != NULL;
+}
+
 void free_env(Environment* env) {
     if (!env) {
         return;
@@ -39,43 +264,122 @@ void free_env(Environment* env) {
         
         if (current->variable) {
             free_value(current->variable->value);
-            free(current->variable);
+            mem_free(current->variable);
         }
-        free(current);
+        mem_free(current);
         
         current = next;
     }
-    free(env);
+    mem_free(env->frozen_table);
+    free_string_heap(env->strings);
+    mem_free(env);
 }
 
 bool set_variable(Environment* env, char* name, Value* value) {
-    if (!env || !name || !value) {
+    if (!env || !name || !value || env->frozen_table) {
         return false;
     }
     VariableNode* current = env->variables;
     while (current) {
         if (strcmp(current->variable->name, name) == 0) {
-            free_value(current->variable->value);
-            current->variable->value = copy_value(value);
-            return current->variable->value != NULL;
+            if (!env->undo_log && current->variable->value->type == value->type) {
+                return overwrite_value(env, current->variable->value, value);
+            }
+            Value* replacement = store_value(env, value);
+            if (!replacement) {
+                return false;
+            }
+            if (env->undo_log) {
+                if (!undo_log_record(env->undo_log, UNDO_OVERWRITTEN,
+                                     current->variable, current->variable->value)) {
+                    free_value(replacement);
+                    return false;
+                }
+            } else {
+                free_value(current->variable->value);
+            }
+            current->variable->value = replacement;
+            return true;
         }
         current = current->next;
     }
-    VariableNode* new_node = malloc(sizeof(VariableNode));
+    return declare_variable(env, name, value);
+}
+
+/*
+ * Appends by storing a new, longer string through set_variable(), for the
+ * cases where the current one must stay as it is.
+ */
+static bool append_copy(Environment* env, char* name, const char* text, size_t length) {
+    Value* current = get_variable(env, name);
+    if (!current || current->type != TYPE_STRING) {
+        return false;
+    }
+    size_t old_length = current->data.string_val ? value_length(current) : 0;
+    char* joined = mem_alloc(old_length + length + 1);
+    if (!joined) {
+        return false;
+    }
+    memcpy(joined, current->data.string_val ? current->data.string_val : "", old_length);
+    memcpy(joined + old_length, text, length);
+    joined[old_length + length] = '\0';
+    Value value;
+    value.type = TYPE_STRING;
+    value.pooled = false;
+    value.data.string_val = joined;
+    bool stored = set_variable(env, name, &value);
+    mem_free(joined);
+    return stored;
+}
+
+bool append_variable(Environment* env, char* name, const char* text, size_t length) {
+    if (!env || !name || !text || env->frozen_table) {
+        return false;
+    }
+    if (env->undo_log) {
+        return append_copy(env, name, text, length);
+    }
+    for (VariableNode* current = env->variables; current; current = current->next) {
+        if (strcmp(current->variable->name, name) != 0) {
+            continue;
+        }
+        Value* value = current->variable->value;
+        if (value->type != TYPE_STRING || (value->data.string_val && !value->pooled) ||
+            !ensure_strings(env)) {
+            return append_copy(env, name, text, length);
+        }
+        char* appended = string_heap_append(env->strings, value->data.string_val, text, length);
+        if (!appended) {
+            return false;
+        }
+        value->data.string_val = appended;
+        value->pooled = true;
+        return true;
+    }
+    return append_copy(env, name, text, length);
+}
+
+bool declare_variable(Environment* env, char* name, Value* value) {
+    if (!env || !name || !value || env->frozen_table) {
+        return false;
+    }
+    VariableNode* new_node = mem_alloc(sizeof(VariableNode));
     if (!new_node) {
         return false;
     }
-    Variable* new_var = malloc(sizeof(Variable));
+    Variable* new_var = mem_alloc(sizeof(Variable));
     if (!new_var) {
-        free(new_node);
+        mem_free(new_node);
         return false;
     }
     strncpy(new_var->name, name, MAX_VARIABLE_NAME - 1);
     new_var->name[MAX_VARIABLE_NAME - 1] = '\0';
-    new_var->value = copy_value(value);
-    if (!new_var->value) {
-        free(new_var);
-        free(new_node);
+    new_var->value = store_value(env, value);
+    if (!new_var->value ||
+        (env->undo_log && !undo_log_record(env->undo_log, UNDO_CREATED, new_var, NULL))) {
+        free_value(new_var->value);
+        mem_free(new_var);
+        mem_free(new_node);
         return false;
     }
     new_node->variable = new_var;
@@ -89,26 +393,56 @@ Value* get_variable(Environment* env, char* name) {
     if (!env || !name) {
         return NULL;
     }
-    VariableNode* current = env->variables;
-    while (current) {
-        if (strcmp(current->variable->name, name) == 0) {
-            return current->variable->value;
-        }
-        current = current->next;
-    }
-    return NULL;
+    Variable* variable = find_variable(env, name);
+    return variable ? variable->value : NULL;
 }
 
 bool variable_exists(Environment* env, char* name) {
     if (!env || !name) {
         return false;
     }
-    VariableNode* current = env->variables;
-    while (current) {
-        if (strcmp(current->variable->name, name) == 0) {
-            return true;
+    return find_variable(env, name) != NULL;
+}
+
+bool compact_env_strings(Environment* env) {
+    if (!env || env->undo_log || env->frozen_table) {
+        return false;
+    }
+    if (!env->strings) {
+        return true;
+    }
+    StringHeap* heap = create_string_heap();
+    char** moved = mem_alloc((env->count + 1) * sizeof(char*));
+    if (!heap || !moved) {
+        free_string_heap(heap);
+        mem_free(moved);
+        return false;
+    }
+    size_t index = 0;
+    for (VariableNode* current = env->variables; current; current = current->next, index++) {
+        Value* value = current->variable->value;
+        moved[index] = NULL;
+        if (value->type == TYPE_STRING && value->pooled && value->data.string_val) {
+            moved[index] = string_heap_alloc(heap, value->data.string_val, value_length(value));
+            if (!moved[index]) {
+                free_string_heap(heap);
+                mem_free(moved);
+                return false;
+            }
+        }
+    }
+    index = 0;
+    for (VariableNode* current = env->variables; current; current = current->next, index++) {
+        if (moved[index]) {
+            current->variable->value->data.string_val = moved[index];
         }
-        current = current->next;
     }
-    return false;
+    mem_free(moved);
+    free_string_heap(env->strings);
+    env->strings = heap;
+    return true;
+}
+
+void env_string_stats(const Environment* env, StringHeapStats* stats) {
+    string_heap_stats(env ? env->strings : NULL, stats);
 }
@@ -0,0 +1,226 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Int Array Implementation
+ * ============================================================================
+ *
+ * Implementation of the int[N] buffer and its bulk operations.
+ *
+ * The header and the items share one block from the current allocator,
+ * which has no aligned allocation of its own: the block is over-allocated
+ * by INT_ARRAY_ALIGNMENT - 1 bytes and the items start at the first
+ * aligned address past the header.
+ *
+ * The reductions keep one vector accumulator and fold its lanes once at the
+ * end. SSE2 has no 32-bit min/max instruction, so that path selects with a
+ * compare and masks instead; AVX2 uses _mm256_min_epi32/_mm256_max_epi32.
+ * Sums are accumulated as unsigned ints, which wrap exactly like the vector
+ * additions do.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "int_array.h"
+#include "allocator.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define INT_ARRAY_LANES 8
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+    #define INT_ARRAY_LANES 4
+#else
+    #define INT_ARRAY_LANES 1
+#endif
+
+static size_t vector_end(const IntArray* array);
+
+/*
+ * Returns the number of leading elements the vector loops cover; the rest
+ * is handled by the scalar tails.
+ */
+static size_t vector_end(const IntArray* array) {
+    return array->length - array->length % INT_ARRAY_LANES;
+}
+
+IntArray* create_int_array(size_t length, int value) {
+    if (length > SIZE_MAX / sizeof(int)) {
+        return NULL;
+    }
+    if (length * sizeof(int) > SIZE_MAX - sizeof(IntArray) - INT_ARRAY_ALIGNMENT) {
+        return NULL;
+    }
+    IntArray* array = mem_alloc(sizeof(IntArray) + INT_ARRAY_ALIGNMENT - 1 + length * sizeof(int));
+    if (!array) {
+        return NULL;
+    }
+    uintptr_t items = (uintptr_t)(array + 1);
+    items = (items + INT_ARRAY_ALIGNMENT - 1) & ~(uintptr_t)(INT_ARRAY_ALIGNMENT - 1);
+    array->length = length;
+    array->items = (int*)items;
+    int_array_fill(array, value);
+    return array;
+}
+
+IntArray* copy_int_array(const IntArray* src) {
+    if (!src) {
+        return NULL;
+    }
+    IntArray* copy = create_int_array(src->length, 0);
+    if (copy) {
+        int_array_copy(copy, src);
+    }
+    return copy;
+}
+
+void free_int_array(IntArray* array) {
+    if (!array) {
+        return;
+    }
+    mem_free(array);
+}
+
+void int_array_fill(IntArray* array, int value) {
+    size_t end = vector_end(array);
+    size_t i = 0;
+#if defined(__AVX2__)
+    __m256i lanes = _mm256_set1_epi32(value);
+    for (; i < end; i += INT_ARRAY_LANES) {
+        _mm256_store_si256((__m256i*)(array->items + i), lanes);
+    }
+#elif defined(__SSE2__)
+    __m128i lanes = _mm_set1_epi32(value);
+    for (; i < end; i += INT_ARRAY_LANES) {
+        _mm_store_si128((__m128i*)(array->items + i), lanes);
+    }
+#else
+    (void)end;
+#endif
+    for (; i < array->length; i++) {
+        array->items[i] = value;
+    }
+}
+
+void int_array_copy(IntArray* dst, const IntArray* src) {
+    if (dst != src && dst->length == src->length) {
+        memcpy(dst->items, src->items, src->length * sizeof(int));
+    }
+}
+
+int int_array_sum(const IntArray* array) {
+    size_t end = vector_end(array);
+    size_t i = 0;
+    unsigned total = 0;
+#if defined(__AVX2__)
+    __m256i sums = _mm256_setzero_si256();
+    for (; i < end; i += INT_ARRAY_LANES) {
+        sums = _mm256_add_epi32(sums, _mm256_load_si256((const __m256i*)(array->items + i)));
+    }
+    unsigned lanes[INT_ARRAY_LANES];
+    _mm256_storeu_si256((__m256i*)lanes, sums);
+    for (int lane = 0; lane < INT_ARRAY_LANES; lane++) {
+        total += lanes[lane];
+    }
+#elif defined(__SSE2__)
+    __m128i sums = _mm_setzero_si128();
+    for (; i < end; i += INT_ARRAY_LANES) {
+        sums = _mm_add_epi32(sums, _mm_load_si128((const __m128i*)(array->items + i)));
+    }
+    unsigned lanes[INT_ARRAY_LANES];
+    _mm_storeu_si128((__m128i*)lanes, sums);
+    for (int lane = 0; lane < INT_ARRAY_LANES; lane++) {
+        total += lanes[lane];
+    }
+#else
+    (void)end;
+#endif
+    for (; i < array->length; i++) {
+        total += (unsigned)array->items[i];
+    }
+    return (int)total;
+}
+
+/*
+ * min and max read the first element unconditionally: the language only
+ * creates arrays of at least one element.
+ */
+int int_array_min(const IntArray* array) {
+    size_t end = vector_end(array);
+    size_t i = 0;
+    int result = array->items[0];
+#if defined(__AVX2__)
+    if (end > 0) {
+        __m256i mins = _mm256_load_si256((const __m256i*)array->items);
+        for (i = INT_ARRAY_LANES; i < end; i += INT_ARRAY_LANES) {
+            mins = _mm256_min_epi32(mins, _mm256_load_si256((const __m256i*)(array->items + i)));
+        }
+        int lanes[INT_ARRAY_LANES];
+        _mm256_storeu_si256((__m256i*)lanes, mins);
+        for (int lane = 0; lane < INT_ARRAY_LANES; lane++) {
+            result = lanes[lane] < result ? lanes[lane] : result;
+        }
+    }
+#elif defined(__SSE2__)
+    if (end > 0) {
+        __m128i mins = _mm_load_si128((const __m128i*)array->items);
+        for (i = INT_ARRAY_LANES; i < end; i += INT_ARRAY_LANES) {
+            __m128i items = _mm_load_si128((const __m128i*)(array->items + i));
+            __m128i greater = _mm_cmpgt_epi32(mins, items);
+            mins = _mm_or_si128(_mm_and_si128(greater, items), _mm_andnot_si128(greater, mins));
+        }
+        int lanes[INT_ARRAY_LANES];
+        _mm_storeu_si128((__m128i*)lanes, mins);
+        for (int lane = 0; lane < INT_ARRAY_LANES; lane++) {
+            result = lanes[lane] < result ? lanes[lane] : result;
+        }
+    }
+#else
+    (void)end;
+#endif
+    for (; i < array->length; i++) {
+        result = array->items[i] < result ? array->items[i] : result;
+    }
+    return result;
+}
+
+int int_array_max(const IntArray* array) {
+    size_t end = vector_end(array);
+    size_t i = 0;
+    int result = array->items[0];
+#if defined(__AVX2__)
+    if (end > 0) {
+        __m256i maxes = _mm256_load_si256((const __m256i*)array->items);
+        for (i = INT_ARRAY_LANES; i < end; i += INT_ARRAY_LANES) {
+            maxes = _mm256_max_epi32(maxes, _mm256_load_si256((const __m256i*)(array->items + i)));
+        }
+        int lanes[INT_ARRAY_LANES];
+        _mm256_storeu_si256((__m256i*)lanes, maxes);
+        for (int lane = 0; lane < INT_ARRAY_LANES; lane++) {
+            result = lanes[lane] > result ? lanes[lane] : result;
+        }
+    }
+#elif defined(__SSE2__)
+    if (end > 0) {
+        __m128i maxes = _mm_load_si128((const __m128i*)array->items);
+        for (i = INT_ARRAY_LANES; i < end; i += INT_ARRAY_LANES) {
+            __m128i items = _mm_load_si128((const __m128i*)(array->items + i));
+            __m128i greater = _mm_cmpgt_epi32(items, maxes);
+            maxes = _mm_or_si128(_mm_and_si128(greater, items), _mm_andnot_si128(greater, maxes));
+        }
+        int lanes[INT_ARRAY_LANES];
+        _mm_storeu_si128((__m128i*)lanes, maxes);
+        for (int lane = 0; lane < INT_ARRAY_LANES; lane++) {
+            result = lanes[lane] > result ? lanes[lane] : result;
+        }
+    }
+#else
+    (void)end;
+#endif
+    for (; i < array->length; i++) {
+        result = array->items[i] > result ? array->items[i] : result;
+    }
+    return result;
+}
@@ -14,49 +14,152 @@
  * ============================================================================
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
+#include <time.h>
 #include "interpreter.h"
+#include "undo_log.h"
+#include "profiler.h"
+#include "trace.h"
+#include "int_array.h"
+
+static bool store_local(Interpreter* interp, int depth, int slot, Value* value);
+static int statement_line(Interpreter* interp, Statement* stmt);
+static bool dispatch_statement(Interpreter* interp, Statement* stmt);
+static bool repeat_each(Interpreter* interp, Statement* stmt);
+static Interpreter* create_interpreter(const Environment* base, const Allocator* allocator);
+static bool reads_variables(const Statement* stmt);
+static Value* find_reference(Interpreter* interp, const VariableReference* ref);
+static bool fail_statement(Interpreter* interp, Statement* stmt, const char* problem);
+static bool store_reduction(Interpreter* interp, Statement* stmt, IntArray* array);
+static bool write_array(Interpreter* interp, Statement* stmt, Value* array);
+static const char* operand_text(Interpreter* interp, Statement* stmt, size_t index, size_t* length);
+static char* join_operands(Interpreter* interp, Statement* stmt, size_t first, size_t* length);
+
+static bool store_local(Interpreter* interp, int depth, int slot, Value* value) {
+    Value* target = frame_slot(interp->stack, depth, slot);
+    if (!target) {
+        return false;
+    }
+    char* string_val = NULL;
+    IntArray* array_val = NULL;
+    if (value->type == TYPE_STRING && value->data.string_val) {
+        string_val = mem_strdup(value->data.string_val);
+        if (!string_val) {
+            return false;
+        }
+    } else if (value->type == TYPE_INT_ARRAY && value->data.array_val) {
+        array_val = copy_int_array(value->data.array_val);
+        if (!array_val) {
+            return false;
+        }
+    }
+    if (target->type == TYPE_STRING) {
+        release_slot_string(target);
+    } else if (target->type == TYPE_INT_ARRAY) {
+        free_int_array(target->data.array_val);
+    }
+    *target = *value;
+    if (value->type == TYPE_STRING) {
+        target->data.string_val = string_val;
+        target->pooled = false;
+    } else if (value->type == TYPE_INT_ARRAY) {
+        target->data.array_val = array_val;
+    }
+    return true;
+}
+
+static int statement_line(Interpreter* interp, Statement* stmt) {
+    if (!interp->lines && interp->source) {
+        interp->lines = create_line_index(interp->source);
+    }
+    return line_index_line(interp->lines, stmt->offset);
+}
 
 Interpreter* init_interpreter(void) {
-    Interpreter* interp = malloc(sizeof(Interpreter));
-    if (!interp) {
-        return NULL;
+    return create_interpreter(NULL, NULL);
+}
+
+Interpreter* init_interpreter_with_base(const Environment* base) {
+    return create_interpreter(base, NULL);
+}
+
+Interpreter* init_interpreter_with_allocator(const Allocator* allocator) {
+    return create_interpreter(NULL, allocator);
+}
+
+static Interpreter* create_interpreter(const Environment* base, const Allocator* allocator) {
+    const Allocator* previous = use_allocator(allocator);
+    Interpreter* interp = mem_alloc(sizeof(Interpreter));
+    if (interp) {
+        interp->global_env = create_child_env(base);
+        interp->stack = create_value_stack();
+        if (!interp->global_env || !interp->stack) {
+            free_env(interp->global_env);
+            free_value_stack(interp->stack);
+            mem_free(interp);
+            interp = NULL;
+        }
     }
-    interp->global_env = create_env();
-    if (!interp->global_env) {
-        free(interp);
+    use_allocator(previous);
+    if (!interp) {
         return NULL;
     }
+    interp->allocator = allocator;
+    interp->output = stdout;
+    interp->transactional = false;
+    interp->buffered_tokens = false;
     interp->has_error = false;
     interp->error_message[0] = '\0';
     interp->executed_statements = 0;
+    interp->source = NULL;
+    interp->lines = NULL;
+    interp->profiler = NULL;
+    interp->trace = NULL;
+    interp->step = NULL;
     return interp;
 }
 
+void set_interpreter_output(Interpreter* interp, FILE* output) {
+    if (!interp) {
+        return;
+    }
+    interp->output = output ? output : stdout;
+}
+
 bool execute_declaration(Interpreter* interp, Statement* stmt) {
     if (!interp || !stmt || stmt->type != STMT_DECLARATION) {
         return false;
     }
     DeclarationStatement* decl = &stmt->data.declaration;
-    if (variable_exists(interp->global_env, decl->var_name)) {
+    if (decl->depth == GLOBAL_DEPTH && variable_exists(interp->global_env, decl->var_name)) {
         snprintf(interp->error_message, sizeof(interp->error_message),
                 "Variable '%s' already declared at line %d",
-                decl->var_name, stmt->line);
+                decl->var_name, statement_line(interp, stmt));
         interp->has_error = true;
         return false;
     }
-    if (!set_variable(interp->global_env, decl->var_name, decl->initial_value)) {
+    bool stored = decl->depth == GLOBAL_DEPTH
+        ? set_variable(interp->global_env, decl->var_name, decl->initial_value)
+        : store_local(interp, decl->depth, decl->slot, decl->initial_value);
+    if (!stored) {
         snprintf(interp->error_message, sizeof(interp->error_message),
                 "Failed to declare variable '%s' at line %d",
-                decl->var_name, stmt->line);
+                decl->var_name, statement_line(interp, stmt));
         interp->has_error = true;
         return false;
     }
-    printf("Declared variable '%s' = ", decl->var_name);
-    print_value(decl->initial_value);
-    printf("\n");
+    if (interp->trace) {
+        trace_statement(interp->trace, TRACE_DECLARE, interp->executed_statements, stmt->offset,
+                        decl->var_name, decl->depth, decl->initial_value);
+    }
+    fprintf(interp->output, "Declared variable '%s' = ", decl->var_name);
+    fprint_value(interp->output, decl->initial_value);
+    fputc('\n', interp->output);
+    interp->executed_statements++;
     return true;
 }
 
@@ -65,23 +168,417 @@ bool execute_assignment(Interpreter* interp, Statement* stmt) {
         return false;
     }
     AssignmentStatement* assign = &stmt->data.assignment;
-    if (!variable_exists(interp->global_env, assign->var_name)) {
+    if (assign->depth == GLOBAL_DEPTH && !variable_exists(interp->global_env, assign->var_name)) {
         snprintf(interp->error_message, sizeof(interp->error_message),
                 "Undefined variable '%s' at line %d",
-                assign->var_name, stmt->line);
+                assign->var_name, statement_line(interp, stmt));
         interp->has_error = true;
         return false;
     }
-    if (!set_variable(interp->global_env, assign->var_name, assign->new_value)) {
+    bool stored = assign->depth == GLOBAL_DEPTH
+        ? set_variable(interp->global_env, assign->var_name, assign->new_value)
+        : store_local(interp, assign->depth, assign->slot, assign->new_value);
+    if (!stored) {
         snprintf(interp->error_message, sizeof(interp->error_message),
                 "Failed to assign to variable '%s' at line %d",
-                assign->var_name, stmt->line);
+                assign->var_name, statement_line(interp, stmt));
+        interp->has_error = true;
+        return false;
+    }
+    if (interp->trace) {
+        trace_statement(interp->trace, TRACE_ASSIGN, interp->executed_statements, stmt->offset,
+                        assign->var_name, assign->depth, assign->new_value);
+    }
+    fprintf(interp->output, "Assigned variable '%s' = ", assign->var_name);
+    fprint_value(interp->output, assign->new_value);
+    fputc('\n', interp->output);
+    interp->executed_statements++;
+    return true;
+}
+
+bool execute_block(Interpreter* interp, Statement* stmt) {
+    if (!interp || !stmt || stmt->type != STMT_BLOCK) {
+        return false;
+    }
+    BlockStatement* block = &stmt->data.block;
+    if (!push_frame(interp->stack, block->frame_size)) {
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                "Failed to enter block at line %d", statement_line(interp, stmt));
         interp->has_error = true;
         return false;
     }
-    printf("Assigned variable '%s' = ", assign->var_name);
-    print_value(assign->new_value);
-    printf("\n");
+    bool ok = true;
+    for (size_t i = 0; i < block->count && ok; i++) {
+        ok = execute_statement(interp, block->statements[i]);
+    }
+    pop_frame(interp->stack);
+    return ok;
+}
+
+static bool repeat_each(Interpreter* interp, Statement* stmt) {
+    bool ok = true;
+    for (int i = 0; i < stmt->data.repeat.count && ok; i++) {
+        ok = execute_block(interp, stmt->data.repeat.body);
+    }
+    return ok;
+}
+
+/*
+ * Only copy(), the reductions and a concatenation with a variable operand
+ * compute what they store from variables; every other statement stores a
+ * literal.
+ */
+static bool reads_variables(const Statement* stmt) {
+    switch (stmt->type) {
+        case STMT_BLOCK:
+            for (size_t i = 0; i < stmt->data.block.count; i++) {
+                if (reads_variables(stmt->data.block.statements[i])) {
+                    return true;
+                }
+            }
+            return false;
+        case STMT_REPEAT:
+            return reads_variables(stmt->data.repeat.body);
+        case STMT_ARRAY:
+            return stmt->data.array.operation != ARRAY_SET &&
+                   stmt->data.array.operation != ARRAY_FILL;
+        case STMT_CONCAT:
+            for (size_t i = 0; i < stmt->data.concat.count; i++) {
+                if (!stmt->data.concat.operands[i].text) {
+                    return true;
+                }
+            }
+            return false;
+        default:
+            return false;
+    }
+}
+
+/*
+ * A body that only stores literals leaves the environment after every
+ * iteration exactly as the first one did and prints the same lines: the
+ * first iteration runs with its output captured, and the rest only replay
+ * that output and add to the statement count. A body that reads variables
+ * (copy(), a reduction or `s = s + ...`) may compute something new each time, and with a
+ * profiler or trace attached each iteration must be observed, so those
+ * run every iteration in full.
+ */
+bool execute_repeat(Interpreter* interp, Statement* stmt) {
+    if (!interp || !stmt || stmt->type != STMT_REPEAT) {
+        return false;
+    }
+    RepeatStatement* loop = &stmt->data.repeat;
+    if (loop->count <= 1 || interp->profiler || interp->trace || reads_variables(loop->body)) {
+        return repeat_each(interp, stmt);
+    }
+    char* echo = NULL;
+    size_t echo_size = 0;
+    FILE* capture = open_memstream(&echo, &echo_size);
+    if (!capture) {
+        return repeat_each(interp, stmt);
+    }
+    FILE* output = interp->output;
+    int executed = interp->executed_statements;
+    interp->output = capture;
+    bool ok = execute_block(interp, loop->body);
+    interp->output = output;
+    fclose(capture);
+    fwrite(echo, 1, echo_size, output);
+    long per_iteration = interp->executed_statements - executed;
+    if (ok && per_iteration * (loop->count - 1L) > (long)INT_MAX - interp->executed_statements) {
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                "Loop at line %d executes too many statements", statement_line(interp, stmt));
+        interp->has_error = true;
+        ok = false;
+    }
+    for (int i = 1; i < loop->count && ok; i++) {
+        fwrite(echo, 1, echo_size, output);
+    }
+    if (ok) {
+        interp->executed_statements += (int)(per_iteration * (loop->count - 1L));
+    }
+    free(echo);
+    return ok;
+}
+
+static Value* find_reference(Interpreter* interp, const VariableReference* ref) {
+    return ref->depth == GLOBAL_DEPTH ? get_variable(interp->global_env, ref->name)
+                                      : frame_slot(interp->stack, ref->depth, ref->slot);
+}
+
+static bool fail_statement(Interpreter* interp, Statement* stmt, const char* problem) {
+    snprintf(interp->error_message, sizeof(interp->error_message), "%s at line %d",
+             problem, statement_line(interp, stmt));
+    interp->has_error = true;
+    return false;
+}
+
+static bool store_reduction(Interpreter* interp, Statement* stmt, IntArray* array) {
+    ArrayStatement* op = &stmt->data.array;
+    Value result;
+    result.type = TYPE_INT;
+    result.pooled = false;
+    switch (op->operation) {
+        case ARRAY_MIN:
+            result.data.int_val = int_array_min(array);
+            break;
+        case ARRAY_MAX:
+            result.data.int_val = int_array_max(array);
+            break;
+        default:
+            result.data.int_val = int_array_sum(array);
+            break;
+    }
+    Value* target = find_reference(interp, &op->other);
+    char problem[MAX_VARIABLE_NAME + 64];
+    if (!target || target->type != TYPE_INT) {
+        snprintf(problem, sizeof(problem), "Undefined variable '%s'", op->other.name);
+        return fail_statement(interp, stmt, problem);
+    }
+    bool stored = op->other.depth == GLOBAL_DEPTH
+        ? set_variable(interp->global_env, op->other.name, &result)
+        : store_local(interp, op->other.depth, op->other.slot, &result);
+    if (!stored) {
+        snprintf(problem, sizeof(problem), "Failed to assign to variable '%s'", op->other.name);
+        return fail_statement(interp, stmt, problem);
+    }
+    if (interp->trace) {
+        trace_statement(interp->trace, TRACE_ASSIGN, interp->executed_statements, stmt->offset,
+                        op->other.name, op->other.depth, &result);
+    }
+    fprintf(interp->output, "Assigned variable '%s' = %d\n", op->other.name, result.data.int_val);
+    interp->executed_statements++;
+    return true;
+}
+
+/*
+ * Locals, and globals that set_variable() would overwrite in place anyway,
+ * are modified where they are stored. A global that lives in a shared base
+ * or whose old value the undo log must keep is modified in a copy, which
+ * set_variable() then stores.
+ */
+static bool write_array(Interpreter* interp, Statement* stmt, Value* array) {
+    ArrayStatement* op = &stmt->data.array;
+    IntArray* items = array->data.array_val;
+    IntArray* source = NULL;
+    char problem[2 * MAX_VARIABLE_NAME + 96];
+    if (op->operation == ARRAY_SET && op->index >= items->length) {
+        snprintf(problem, sizeof(problem), "Index %zu out of range for array '%s' of length %zu",
+                 op->index, op->array.name, items->length);
+        return fail_statement(interp, stmt, problem);
+    }
+    if (op->operation == ARRAY_COPY) {
+        Value* other = find_reference(interp, &op->other);
+        if (!other || other->type != TYPE_INT_ARRAY || !other->data.array_val) {
+            snprintf(problem, sizeof(problem), "Undefined variable '%s'", op->other.name);
+            return fail_statement(interp, stmt, problem);
+        }
+        source = other->data.array_val;
+        if (source->length != items->length) {
+            snprintf(problem, sizeof(problem),
+                     "Cannot copy array '%s' of length %zu into '%s' of length %zu",
+                     op->other.name, source->length, op->array.name, items->length);
+            return fail_statement(interp, stmt, problem);
+        }
+    }
+    Environment* env = interp->global_env;
+    bool in_place = op->array.depth != GLOBAL_DEPTH ||
+                    (!env->base && !env_is_frozen(env) && !env->undo_log);
+    Value* copy = NULL;
+    if (!in_place) {
+        copy = copy_value(array);
+        if (!copy) {
+            snprintf(problem, sizeof(problem), "Failed to assign to variable '%s'", op->array.name);
+            return fail_statement(interp, stmt, problem);
+        }
+        array = copy;
+        items = copy->data.array_val;
+    }
+    switch (op->operation) {
+        case ARRAY_SET:
+            items->items[op->index] = op->value;
+            break;
+        case ARRAY_FILL:
+            int_array_fill(items, op->value);
+            break;
+        default:
+            int_array_copy(items, source);
+            break;
+    }
+    if (copy) {
+        bool stored = set_variable(env, op->array.name, copy);
+        free_value(copy);
+        if (!stored) {
+            snprintf(problem, sizeof(problem), "Failed to assign to variable '%s'", op->array.name);
+            return fail_statement(interp, stmt, problem);
+        }
+        array = find_reference(interp, &op->array);
+    }
+    if (interp->trace) {
+        trace_statement(interp->trace, TRACE_ASSIGN, interp->executed_statements, stmt->offset,
+                        op->array.name, op->array.depth, array);
+    }
+    switch (op->operation) {
+        case ARRAY_SET:
+            fprintf(interp->output, "Assigned variable '%s[%zu]' = %d\n",
+                    op->array.name, op->index, op->value);
+            break;
+        case ARRAY_FILL:
+            fprintf(interp->output, "Filled array '%s' with %d\n", op->array.name, op->value);
+            break;
+        default:
+            fprintf(interp->output, "Copied array '%s' into '%s'\n", op->other.name, op->array.name);
+            break;
+    }
+    interp->executed_statements++;
+    return true;
+}
+
+bool execute_array(Interpreter* interp, Statement* stmt) {
+    if (!interp || !stmt || stmt->type != STMT_ARRAY) {
+        return false;
+    }
+    ArrayStatement* op = &stmt->data.array;
+    Value* array = find_reference(interp, &op->array);
+    if (!array || array->type != TYPE_INT_ARRAY || !array->data.array_val) {
+        char problem[MAX_VARIABLE_NAME + 64];
+        snprintf(problem, sizeof(problem), "Undefined variable '%s'", op->array.name);
+        return fail_statement(interp, stmt, problem);
+    }
+    switch (op->operation) {
+        case ARRAY_SUM:
+        case ARRAY_MIN:
+        case ARRAY_MAX:
+            return store_reduction(interp, stmt, array->data.array_val);
+        default:
+            return write_array(interp, stmt, array);
+    }
+}
+
+/*
+ * Returns the text of operand `index`, or NULL after reporting an operand
+ * variable that does not hold a string.
+ */
+static const char* operand_text(Interpreter* interp, Statement* stmt, size_t index, size_t* length) {
+    ConcatOperand* operand = &stmt->data.concat.operands[index];
+    if (operand->text) {
+        *length = strlen(operand->text);
+        return operand->text;
+    }
+    Value* value = find_reference(interp, &operand->variable);
+    if (!value || value->type != TYPE_STRING) {
+        char problem[MAX_VARIABLE_NAME + 64];
+        snprintf(problem, sizeof(problem), "Undefined variable '%s'", operand->variable.name);
+        fail_statement(interp, stmt, problem);
+        return NULL;
+    }
+    if (!value->data.string_val) {
+        *length = 0;
+        return "";
+    }
+    *length = value->pooled ? string_heap_length(value->data.string_val)
+                            : strlen(value->data.string_val);
+    return value->data.string_val;
+}
+
+/*
+ * Concatenates the operands from `first` on into one malloc'd string.
+ */
+static char* join_operands(Interpreter* interp, Statement* stmt, size_t first, size_t* length) {
+    ConcatStatement* concat = &stmt->data.concat;
+    size_t total = 0;
+    for (size_t i = first; i < concat->count; i++) {
+        size_t part;
+        if (!operand_text(interp, stmt, i, &part)) {
+            return NULL;
+        }
+        total += part;
+    }
+    char* joined = mem_alloc(total + 1);
+    if (!joined) {
+        fail_statement(interp, stmt, "Out of memory joining strings");
+        return NULL;
+    }
+    size_t used = 0;
+    for (size_t i = first; i < concat->count; i++) {
+        size_t part;
+        const char* text = operand_text(interp, stmt, i, &part);
+        memcpy(joined + used, text, part);
+        used += part;
+    }
+    joined[used] = '\0';
+    *length = used;
+    return joined;
+}
+
+/*
+ * `s = s + ...;` appends the other operands to s where it is stored, so a
+ * string built in a loop costs what its pieces do; the echo line and the
+ * trace record show only the appended text. Any other concatenation is
+ * joined into a new string and assigned like a literal.
+ */
+bool execute_concat(Interpreter* interp, Statement* stmt) {
+    if (!interp || !stmt || stmt->type != STMT_CONCAT) {
+        return false;
+    }
+    ConcatStatement* concat = &stmt->data.concat;
+    VariableReference* target = &concat->target;
+    char problem[MAX_VARIABLE_NAME + 64];
+    Value* current = find_reference(interp, target);
+    if (!current || current->type != TYPE_STRING) {
+        snprintf(problem, sizeof(problem), "Undefined variable '%s'", target->name);
+        return fail_statement(interp, stmt, problem);
+    }
+    size_t first = concat->append ? 1 : 0;
+    size_t length = 0;
+    char* joined = NULL;
+    const char* text;
+    if (concat->count - first == 1) {
+        text = operand_text(interp, stmt, first, &length);
+    } else {
+        text = joined = join_operands(interp, stmt, first, &length);
+    }
+    if (!text) {
+        return false;
+    }
+    Value value;
+    value.type = TYPE_STRING;
+    value.pooled = false;
+    value.data.string_val = (char*)text;
+    bool stored;
+    if (text == current->data.string_val) {
+        /* `s = s;` would free the string it is about to copy */
+        stored = true;
+    } else if (concat->append) {
+        stored = target->depth == GLOBAL_DEPTH
+            ? append_variable(interp->global_env, target->name, text, length)
+            : append_local(interp->stack, target->depth, target->slot, text, length);
+    } else {
+        stored = target->depth == GLOBAL_DEPTH
+            ? set_variable(interp->global_env, target->name, &value)
+            : store_local(interp, target->depth, target->slot, &value);
+    }
+    if (!stored) {
+        mem_free(joined);
+        snprintf(problem, sizeof(problem), "Failed to assign to variable '%s'", target->name);
+        return fail_statement(interp, stmt, problem);
+    }
+    if (interp->trace) {
+        trace_statement(interp->trace, concat->append ? TRACE_APPEND : TRACE_ASSIGN,
+                        interp->executed_statements, stmt->offset, target->name, target->depth,
+                        &value);
+    }
+    if (concat->append) {
+        fputs("Appended ", interp->output);
+        fprint_value(interp->output, &value);
+        fprintf(interp->output, " to variable '%s'\n", target->name);
+    } else {
+        fprintf(interp->output, "Assigned variable '%s' = ", target->name);
+        fprint_value(interp->output, &value);
+        fputc('\n', interp->output);
+    }
+    mem_free(joined);
+    interp->executed_statements++;
     return true;
 }
 
@@ -89,73 +586,256 @@ bool execute_statement(Interpreter* interp, Statement* stmt) {
     if (!interp || !stmt) {
         return false;
     }
+    const Allocator* previous = use_allocator(interp->allocator);
+    bool ok;
+    if (!interp->profiler || stmt->type == STMT_BLOCK || stmt->type == STMT_REPEAT) {
+        ok = dispatch_statement(interp, stmt);
+    } else {
+        uint64_t allocated = interp->profiler->allocated;
+        uint64_t start = profile_clock();
+        ok = dispatch_statement(interp, stmt);
+        profile_execute(interp->profiler, stmt, profile_clock() - start,
+                        interp->profiler->allocated - allocated);
+    }
+    use_allocator(previous);
+    return ok;
+}
+
+static bool dispatch_statement(Interpreter* interp, Statement* stmt) {
     switch (stmt->type) {
         case STMT_DECLARATION:
             return execute_declaration(interp, stmt);
         case STMT_ASSIGNMENT:
             return execute_assignment(interp, stmt);
+        case STMT_BLOCK:
+            return execute_block(interp, stmt);
+        case STMT_REPEAT:
+            return execute_repeat(interp, stmt);
+        case STMT_ARRAY:
+            return execute_array(interp, stmt);
+        case STMT_CONCAT:
+            return execute_concat(interp, stmt);
         default:
             snprintf(interp->error_message, sizeof(interp->error_message),
-                    "Unknown statement type at line %d", stmt->line);
+                    "Unknown statement type at line %d", statement_line(interp, stmt));
             interp->has_error = true;
             return false;
     }
 }
 
-void run(Interpreter* interp, char* source) {
-    if (!interp || !source) {
-        return;
+static void release_execution(Execution* exec);
+static bool fail_execution_setup(Interpreter* interp, Execution* exec, const char* message);
+static bool open_execution(Interpreter* interp, Execution* exec, char* source, size_t offset);
+static bool next_statement(Interpreter* interp, Execution* exec);
+
+static void release_execution(Execution* exec) {
+    free_parser(exec->parser);
+    free_token_buffer(exec->tokens);
+    free_lexer(exec->lexer);
+    exec->parser = NULL;
+    exec->tokens = NULL;
+    exec->lexer = NULL;
+}
+
+static bool fail_execution_setup(Interpreter* interp, Execution* exec, const char* message) {
+    release_execution(exec);
+    snprintf(interp->error_message, sizeof(interp->error_message), "%s", message);
+    interp->has_error = true;
+    return false;
+}
+
+bool begin_execution(Interpreter* interp, Execution* exec, char* source, size_t offset) {
+    if (!interp || !exec || !source) {
+        return false;
     }
-    Lexer* lexer = init_lexer(source);
-    if (!lexer) {
-        snprintf(interp->error_message, sizeof(interp->error_message),
-                "Failed to initialize lexer");
-        interp->has_error = true;
-        return;
+    const Allocator* previous = use_allocator(interp->allocator);
+    bool ok = open_execution(interp, exec, source, offset);
+    use_allocator(previous);
+    return ok;
+}
+
+static bool open_execution(Interpreter* interp, Execution* exec, char* source, size_t offset) {
+    exec->lexer = NULL;
+    exec->tokens = NULL;
+    exec->parser = NULL;
+    exec->undo_log = NULL;
+    exec->done = false;
+    exec->failed = false;
+    free_line_index(interp->lines);
+    interp->lines = NULL;
+    interp->source = source;
+    exec->lexer = init_lexer(source);
+    if (!exec->lexer) {
+        return fail_execution_setup(interp, exec, "Failed to initialize lexer");
     }
-    Parser* parser = init_parser(lexer, interp->global_env);
-    if (!parser) {
-        free_lexer(lexer);
-        snprintf(interp->error_message, sizeof(interp->error_message),
-                "Failed to initialize parser");
-        interp->has_error = true;
-        return;
+    lexer_seek(exec->lexer, offset);
+    if (interp->buffered_tokens) {
+        exec->tokens = tokenize_source(exec->lexer);
+        if (!exec->tokens) {
+            return fail_execution_setup(interp, exec, "Failed to tokenize source");
+        }
+    }
+    exec->parser = exec->tokens
+                   ? init_parser_buffered(exec->tokens, interp->global_env)
+                   : init_parser_profiled(exec->lexer, interp->global_env, interp->profiler);
+    if (!exec->parser) {
+        return fail_execution_setup(interp, exec, "Failed to initialize parser");
     }
-    printf("=== PONG INTERPRETER EXECUTION ===\n");
-    
-    while (parser->current_token && parser->current_token->type != TOKEN_EOF) {
+    if (interp->transactional) {
+        exec->undo_log = create_undo_log();
+        if (!exec->undo_log) {
+            return fail_execution_setup(interp, exec, "Failed to initialize undo log");
+        }
+        interp->global_env->undo_log = exec->undo_log;
+    }
+    return true;
+}
+
+bool execute_next(Interpreter* interp, Execution* exec) {
+    if (!interp || !exec || exec->done) {
+        return false;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    bool more = next_statement(interp, exec);
+    use_allocator(previous);
+    return more;
+}
+
+static bool next_statement(Interpreter* interp, Execution* exec) {
+    Parser* parser = exec->parser;
+    if (!parser->current_token || parser->current_token->type == TOKEN_EOF) {
+        exec->done = true;
+        return false;
+    }
+    exec->done = true;
+    exec->failed = true;
+    if (parser->has_error) {
+        fprintf(interp->output, "Parser error: %s\n", parser->error_message);
+        return false;
+    }
+    Statement* stmt = parse_statement(parser);
+    if (!stmt) {
         if (parser->has_error) {
-            printf("Parser error: %s\n", parser->error_message);
-            break;
+            fprintf(interp->output, "Parse error: %s\n", parser->error_message);
         }
-        Statement* stmt = parse_statement(parser);
-        if (!stmt) {
-            if (parser->has_error) {
-                printf("Parse error: %s\n", parser->error_message);
-            }
-            break;
+        return false;
+    }
+    if (!execute_statement(interp, stmt)) {
+        fprintf(interp->output, "Runtime error: %s\n", interp->error_message);
+        free_statement(stmt);
+        return false;
+    }
+    free_statement(stmt);
+    exec->done = false;
+    exec->failed = false;
+    return true;
+}
+
+void end_execution(Interpreter* interp, Execution* exec) {
+    if (!interp || !exec) {
+        return;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    if (exec->undo_log) {
+        if (exec->failed) {
+            size_t undone = undo_log_rollback(exec->undo_log, interp->global_env);
+            fprintf(interp->output, "Transaction rolled back (%zu changes undone)\n", undone);
+            trace_rollback(interp->trace, undone);
+        } else {
+            undo_log_commit(exec->undo_log);
         }
-        if (!execute_statement(interp, stmt)) {
-            printf("Runtime error: %s\n", interp->error_message);
-            free_statement(stmt);
-            break;
+        interp->global_env->undo_log = NULL;
+        free_undo_log(exec->undo_log);
+        exec->undo_log = NULL;
+    }
+    trace_end(interp->trace, interp->executed_statements, exec->failed);
+    release_execution(exec);
+    free_line_index(interp->lines);
+    interp->lines = NULL;
+    interp->source = NULL;
+    use_allocator(previous);
+}
+
+static long elapsed_microseconds(const struct timespec* since);
+
+static long elapsed_microseconds(const struct timespec* since) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (long)(now.tv_sec - since->tv_sec) * 1000000L + (now.tv_nsec - since->tv_nsec) / 1000L;
+}
+
+bool start_run(Interpreter* interp, char* source) {
+    if (!interp || !source) {
+        return false;
+    }
+    if (interp->step) {
+        snprintf(interp->error_message, sizeof(interp->error_message), "A run is already in progress");
+        interp->has_error = true;
+        return false;
+    }
+    Execution* exec = malloc(sizeof(Execution));
+    if (!exec) {
+        snprintf(interp->error_message, sizeof(interp->error_message), "Failed to allocate execution");
+        interp->has_error = true;
+        return false;
+    }
+    if (!begin_execution(interp, exec, source, 0)) {
+        free(exec);
+        return false;
+    }
+    interp->step = exec;
+    fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+    return true;
+}
+
+bool run_step(Interpreter* interp, StepBudget budget) {
+    if (!interp || !interp->step) {
+        return false;
+    }
+    Execution* exec = interp->step;
+    struct timespec started;
+    if (budget.microseconds > 0) {
+        clock_gettime(CLOCK_MONOTONIC, &started);
+    }
+    int executed = 0;
+    while (execute_next(interp, exec)) {
+        executed++;
+        if ((budget.statements > 0 && executed >= budget.statements) ||
+            (budget.microseconds > 0 && elapsed_microseconds(&started) >= budget.microseconds)) {
+            return true;
         }
-        interp->executed_statements++;
-        free_statement(stmt);
     }
-    
-    printf("=== EXECUTION COMPLETE ===\n");
-    printf("Executed %d statements\n", interp->executed_statements);
-    free_parser(parser);
-    free_lexer(lexer);
+    end_execution(interp, exec);
+    free(exec);
+    interp->step = NULL;
+    fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+    return false;
+}
+
+void run(Interpreter* interp, char* source) {
+    if (!start_run(interp, source)) {
+        return;
+    }
+    StepBudget unlimited = {0, 0};
+    while (run_step(interp, unlimited)) {
+    }
 }
 
 void free_interpreter(Interpreter* interp) {
     if (!interp) {
         return;
     }
+    if (interp->step) {
+        end_execution(interp, interp->step);
+        free(interp->step);
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
     if (interp->global_env) {
         free_env(interp->global_env);
     }
-    free(interp);
+    free_value_stack(interp->stack);
+    free_line_index(interp->lines);
+    mem_free(interp);
+    use_allocator(previous);
 }
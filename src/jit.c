@@ -0,0 +1,596 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - JIT Execution Engine Implementation
+ * ============================================================================
+ *
+ * Implementation of the x86-64 batch compiler. A compiled batch is one
+ * System V function `bool code(JitProgram* program, Value** slots)`:
+ *
+ *   push rbx / r12 / r13         r12 = program, rbx = slot array
+ *   per fast assignment:
+ *     mov rax, [rbx + 8*slot]    resolved Value*, NULL before declaration
+ *     test rax, rax
+ *     jnz store
+ *     <slow call>                undeclared: let the interpreter fail
+ *     jmp next
+ *   store:
+ *     mov dword [rax + data], imm
+ *     call jit_echo(program, text, length)
+ *   next:
+ *   per other statement (<slow call>):
+ *     call jit_slow(program, index); test al, al; jz fail
+ *
+ * The echo lines of fast assignments are constant, so they are formatted
+ * once at compile time into the program's text arena; the echo routine
+ * only copies them into an output buffer that is flushed before every slow
+ * statement and at the end, which keeps the output in order.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "jit.h"
+#include "utf8.h"
+
+#if defined(__x86_64__) && defined(__linux__)
+    #define JIT_NATIVE 1
+#else
+    #define JIT_NATIVE 0
+#endif
+
+#define JIT_ECHO_BUFFER_SIZE (64 * 1024)
+#define JIT_MAX_STATEMENT_CODE 96
+#define JIT_CODE_OVERHEAD 64
+
+typedef bool (*JitFunction)(JitProgram* program, Value** slots);
+
+struct JitProgram {
+    Interpreter* interp;
+    Statement** statements;
+    size_t count;
+    Value** slots;
+    char** slot_names;
+    size_t slot_count;
+    int* buckets;
+    size_t bucket_mask;
+    int* statement_slots;
+    char* texts;
+    size_t texts_length;
+    size_t* text_offsets;
+    uint32_t* text_lengths;
+    uint8_t* code;
+    size_t code_size;
+    char* echo;
+    size_t echo_used;
+};
+
+typedef struct {
+    uint8_t* bytes;
+    size_t length;
+} CodeBuffer;
+
+static bool is_fast_assignment(const Statement* stmt);
+static bool owns_values(Environment* env);
+static uint32_t hash_name(const char* name);
+static int find_slot(JitProgram* program, char* name);
+static bool assign_slots(JitProgram* program);
+static size_t format_echo(char* text, const AssignmentStatement* assign);
+static bool format_texts(JitProgram* program);
+static void flush_echo(JitProgram* program);
+static void jit_echo(JitProgram* program, const char* text, uint32_t length);
+static bool jit_slow(JitProgram* program, uint32_t index);
+static void emit_u8(CodeBuffer* code, uint8_t byte);
+static void emit_u32(CodeBuffer* code, uint32_t value);
+static void emit_u64(CodeBuffer* code, uint64_t value);
+static void emit_call(CodeBuffer* code, const void* function);
+static void emit_slow_call(CodeBuffer* code, uint32_t index, size_t* fail_fixups, size_t* fixup_count);
+static void emit_fast_assignment(JitProgram* program, CodeBuffer* code, uint32_t index,
+                                 size_t* fail_fixups, size_t* fixup_count);
+static bool generate_code(JitProgram* program);
+static bool run_batch(Interpreter* interp, Statement** statements, size_t count);
+static void jit_source(Interpreter* interp, char* source);
+
+static bool is_fast_assignment(const Statement* stmt) {
+    return stmt->type == STMT_ASSIGNMENT &&
+           stmt->data.assignment.depth == GLOBAL_DEPTH &&
+           (stmt->data.assignment.new_value->type == TYPE_INT ||
+            stmt->data.assignment.new_value->type == TYPE_CHAR);
+}
+
+/*
+ * Values can only be stored through directly when set_variable() would
+ * overwrite them in place: the variable lives in this environment and the
+ * environment is writable.
+ */
+static bool owns_values(Environment* env) {
+    return !env->base && !env_is_frozen(env);
+}
+
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; name++) {
+        hash ^= (uint8_t)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*
+ * Returns the slot of a global, giving it the next free slot the first
+ * time it is seen. Buckets hold slot + 1 so zero marks an empty bucket.
+ */
+static int find_slot(JitProgram* program, char* name) {
+    size_t bucket = hash_name(name) & program->bucket_mask;
+    while (program->buckets[bucket] != 0) {
+        int slot = program->buckets[bucket] - 1;
+        if (strcmp(program->slot_names[slot], name) == 0) {
+            return slot;
+        }
+        bucket = (bucket + 1) & program->bucket_mask;
+    }
+    int slot = (int)program->slot_count++;
+    program->slot_names[slot] = name;
+    program->buckets[bucket] = slot + 1;
+    Environment* env = program->interp->global_env;
+    program->slots[slot] = owns_values(env) ? get_variable(env, name) : NULL;
+    return slot;
+}
+
+/*
+ * Gives every global written by a fast assignment or declared in the
+ * batch a slot. A slot starts with the variable's current Value when the
+ * global environment owns it and is filled by jit_slow() when the batch
+ * declares it; a global the environment does not own keeps an empty slot
+ * so its writes go through set_variable().
+ */
+static bool assign_slots(JitProgram* program) {
+    size_t bucket_count = 16;
+    while (bucket_count < program->count * 2) {
+        bucket_count *= 2;
+    }
+    program->buckets = calloc(bucket_count, sizeof(int));
+    if (!program->buckets) {
+        return false;
+    }
+    program->bucket_mask = bucket_count - 1;
+    for (size_t i = 0; i < program->count; i++) {
+        Statement* stmt = program->statements[i];
+        char* name = NULL;
+        if (is_fast_assignment(stmt)) {
+            name = stmt->data.assignment.var_name;
+        } else if (stmt->type == STMT_DECLARATION && stmt->data.declaration.depth == GLOBAL_DEPTH) {
+            name = stmt->data.declaration.var_name;
+        }
+        program->statement_slots[i] = -1;
+        if (!name) {
+            continue;
+        }
+        program->statement_slots[i] = find_slot(program, name);
+    }
+    return true;
+}
+
+/*
+ * Writes the line execute_assignment() prints for a constant int or char
+ * assignment. This runs for every fast assignment of every batch, so it
+ * formats by hand; snprintf() alone would cost more than the store.
+ */
+static size_t format_echo(char* text, const AssignmentStatement* assign) {
+    static const char prefix[] = "Assigned variable '";
+    char* out = text;
+    memcpy(out, prefix, sizeof(prefix) - 1);
+    out += sizeof(prefix) - 1;
+    size_t name_length = strlen(assign->var_name);
+    memcpy(out, assign->var_name, name_length);
+    out += name_length;
+    memcpy(out, "' = ", 4);
+    out += 4;
+    if (assign->new_value->type == TYPE_CHAR) {
+        *out++ = '\'';
+        out += utf8_encode(assign->new_value->data.char_val, out);
+        *out++ = '\'';
+    } else {
+        int value = assign->new_value->data.int_val;
+        unsigned int magnitude = value < 0 ? 0u - (unsigned int)value : (unsigned int)value;
+        char digits[16];
+        size_t count = 0;
+        do {
+            digits[count++] = (char)('0' + magnitude % 10);
+            magnitude /= 10;
+        } while (magnitude > 0);
+        if (value < 0) {
+            *out++ = '-';
+        }
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+    }
+    *out++ = '\n';
+    return (size_t)(out - text);
+}
+
+static bool format_texts(JitProgram* program) {
+    size_t capacity = 4096;
+    program->texts = malloc(capacity);
+    if (!program->texts) {
+        return false;
+    }
+    for (size_t i = 0; i < program->count; i++) {
+        Statement* stmt = program->statements[i];
+        if (!is_fast_assignment(stmt)) {
+            continue;
+        }
+        AssignmentStatement* assign = &stmt->data.assignment;
+        size_t needed = strlen(assign->var_name) + 64;
+        if (program->texts_length + needed > capacity) {
+            while (program->texts_length + needed > capacity) {
+                capacity *= 2;
+            }
+            char* texts = realloc(program->texts, capacity);
+            if (!texts) {
+                return false;
+            }
+            program->texts = texts;
+        }
+        char* text = program->texts + program->texts_length;
+        size_t length = format_echo(text, assign);
+        program->text_offsets[i] = program->texts_length;
+        program->text_lengths[i] = (uint32_t)length;
+        program->texts_length += length;
+    }
+    return true;
+}
+
+static void flush_echo(JitProgram* program) {
+    if (program->echo_used > 0) {
+        fwrite(program->echo, 1, program->echo_used, program->interp->output);
+        program->echo_used = 0;
+    }
+}
+
+static void jit_echo(JitProgram* program, const char* text, uint32_t length) {
+    if (program->echo_used + length > JIT_ECHO_BUFFER_SIZE) {
+        flush_echo(program);
+    }
+    memcpy(program->echo + program->echo_used, text, length);
+    program->echo_used += length;
+    program->interp->executed_statements++;
+}
+
+static bool jit_slow(JitProgram* program, uint32_t index) {
+    Interpreter* interp = program->interp;
+    Statement* stmt = program->statements[index];
+    flush_echo(program);
+    if (!execute_statement(interp, stmt)) {
+        fprintf(interp->output, "Runtime error: %s\n", interp->error_message);
+        return false;
+    }
+    int slot = program->statement_slots[index];
+    if (slot >= 0 && stmt->type == STMT_DECLARATION && owns_values(interp->global_env)) {
+        program->slots[slot] = get_variable(interp->global_env, stmt->data.declaration.var_name);
+    }
+    return true;
+}
+
+static void emit_u8(CodeBuffer* code, uint8_t byte) {
+    code->bytes[code->length++] = byte;
+}
+
+static void emit_u32(CodeBuffer* code, uint32_t value) {
+    memcpy(code->bytes + code->length, &value, sizeof(value));
+    code->length += sizeof(value);
+}
+
+static void emit_u64(CodeBuffer* code, uint64_t value) {
+    memcpy(code->bytes + code->length, &value, sizeof(value));
+    code->length += sizeof(value);
+}
+
+static void emit_call(CodeBuffer* code, const void* function) {
+    uint64_t address;
+    memcpy(&address, &function, sizeof(address));
+    emit_u8(code, 0x48);                        /* mov rax, imm64 */
+    emit_u8(code, 0xB8);
+    emit_u64(code, address);
+    emit_u8(code, 0xFF);                        /* call rax */
+    emit_u8(code, 0xD0);
+}
+
+static void emit_slow_call(CodeBuffer* code, uint32_t index, size_t* fail_fixups, size_t* fixup_count) {
+    bool (*slow)(JitProgram*, uint32_t) = jit_slow;
+    const void* target;
+    memcpy(&target, &slow, sizeof(target));
+    emit_u8(code, 0x4C);                        /* mov rdi, r12 */
+    emit_u8(code, 0x89);
+    emit_u8(code, 0xE7);
+    emit_u8(code, 0xBE);                        /* mov esi, imm32 */
+    emit_u32(code, index);
+    emit_call(code, target);
+    emit_u8(code, 0x84);                        /* test al, al */
+    emit_u8(code, 0xC0);
+    emit_u8(code, 0x0F);                        /* jz fail */
+    emit_u8(code, 0x84);
+    fail_fixups[(*fixup_count)++] = code->length;
+    emit_u32(code, 0);
+}
+
+static void emit_fast_assignment(JitProgram* program, CodeBuffer* code, uint32_t index,
+                                 size_t* fail_fixups, size_t* fixup_count) {
+    Value* value = program->statements[index]->data.assignment.new_value;
+    uint32_t slot = (uint32_t)program->statement_slots[index];
+    emit_u8(code, 0x48);                        /* mov rax, [rbx + disp32] */
+    emit_u8(code, 0x8B);
+    emit_u8(code, 0x83);
+    emit_u32(code, slot * (uint32_t)sizeof(Value*));
+    emit_u8(code, 0x48);                        /* test rax, rax */
+    emit_u8(code, 0x85);
+    emit_u8(code, 0xC0);
+    emit_u8(code, 0x75);                        /* jnz store */
+    size_t skip_slow = code->length;
+    emit_u8(code, 0);
+    emit_slow_call(code, index, fail_fixups, fixup_count);
+    emit_u8(code, 0xEB);                        /* jmp next */
+    size_t skip_store = code->length;
+    emit_u8(code, 0);
+    code->bytes[skip_slow] = (uint8_t)(code->length - skip_slow - 1);
+    emit_u8(code, 0xC7);                        /* mov dword [rax + disp8], imm32 */
+    emit_u8(code, 0x40);
+    emit_u8(code, (uint8_t)offsetof(Value, data));
+    emit_u32(code, value->type == TYPE_INT ? (uint32_t)value->data.int_val : value->data.char_val);
+    const char* text = program->texts + program->text_offsets[index];
+    uint64_t text_address;
+    memcpy(&text_address, &text, sizeof(text_address));
+    void (*echo)(JitProgram*, const char*, uint32_t) = jit_echo;
+    const void* target;
+    memcpy(&target, &echo, sizeof(target));
+    emit_u8(code, 0x4C);                        /* mov rdi, r12 */
+    emit_u8(code, 0x89);
+    emit_u8(code, 0xE7);
+    emit_u8(code, 0x48);                        /* mov rsi, imm64 */
+    emit_u8(code, 0xBE);
+    emit_u64(code, text_address);
+    emit_u8(code, 0xBA);                        /* mov edx, imm32 */
+    emit_u32(code, program->text_lengths[index]);
+    emit_call(code, target);
+    code->bytes[skip_store] = (uint8_t)(code->length - skip_store - 1);
+}
+
+static bool generate_code(JitProgram* program) {
+    long page = sysconf(_SC_PAGESIZE);
+    size_t page_size = page > 0 ? (size_t)page : 4096;
+    size_t size = program->count * JIT_MAX_STATEMENT_CODE + JIT_CODE_OVERHEAD;
+    size = (size + page_size - 1) / page_size * page_size;
+    size_t* fail_fixups = malloc((program->count + 1) * sizeof(size_t));
+    void* region = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (!fail_fixups || region == MAP_FAILED) {
+        free(fail_fixups);
+        if (region != MAP_FAILED) {
+            munmap(region, size);
+        }
+        return false;
+    }
+    CodeBuffer code = {region, 0};
+    size_t fixup_count = 0;
+    emit_u8(&code, 0x53);                       /* push rbx */
+    emit_u8(&code, 0x41);                       /* push r12 */
+    emit_u8(&code, 0x54);
+    emit_u8(&code, 0x41);                       /* push r13 */
+    emit_u8(&code, 0x55);
+    emit_u8(&code, 0x49);                       /* mov r12, rdi */
+    emit_u8(&code, 0x89);
+    emit_u8(&code, 0xFC);
+    emit_u8(&code, 0x48);                       /* mov rbx, rsi */
+    emit_u8(&code, 0x89);
+    emit_u8(&code, 0xF3);
+    for (size_t i = 0; i < program->count; i++) {
+        if (is_fast_assignment(program->statements[i])) {
+            emit_fast_assignment(program, &code, (uint32_t)i, fail_fixups, &fixup_count);
+        } else {
+            emit_slow_call(&code, (uint32_t)i, fail_fixups, &fixup_count);
+        }
+    }
+    emit_u8(&code, 0xB8);                       /* mov eax, 1 */
+    emit_u32(&code, 1);
+    size_t epilogue = code.length;
+    emit_u8(&code, 0x41);                       /* pop r13 */
+    emit_u8(&code, 0x5D);
+    emit_u8(&code, 0x41);                       /* pop r12 */
+    emit_u8(&code, 0x5C);
+    emit_u8(&code, 0x5B);                       /* pop rbx */
+    emit_u8(&code, 0xC3);                       /* ret */
+    size_t fail = code.length;
+    emit_u8(&code, 0x31);                       /* xor eax, eax */
+    emit_u8(&code, 0xC0);
+    emit_u8(&code, 0xE9);                       /* jmp epilogue */
+    emit_u32(&code, (uint32_t)(int32_t)(epilogue - (code.length + 4)));
+    for (size_t i = 0; i < fixup_count; i++) {
+        int32_t displacement = (int32_t)(fail - (fail_fixups[i] + 4));
+        memcpy(code.bytes + fail_fixups[i], &displacement, sizeof(displacement));
+    }
+    free(fail_fixups);
+    if (mprotect(region, size, PROT_READ | PROT_EXEC) != 0) {
+        munmap(region, size);
+        return false;
+    }
+    program->code = region;
+    program->code_size = size;
+    return true;
+}
+
+bool jit_available(const Interpreter* interp, char* reason, size_t reason_size) {
+    if (!JIT_NATIVE) {
+        snprintf(reason, reason_size, "only x86-64 Linux is supported");
+        return false;
+    }
+    if (interp && interp->transactional) {
+        snprintf(reason, reason_size, "transactional mode is not supported");
+        return false;
+    }
+    long page = sysconf(_SC_PAGESIZE);
+    size_t size = page > 0 ? (size_t)page : 4096;
+    void* probe = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (probe == MAP_FAILED) {
+        snprintf(reason, reason_size, "cannot map code memory");
+        return false;
+    }
+    bool executable = mprotect(probe, size, PROT_READ | PROT_EXEC) == 0;
+    munmap(probe, size);
+    if (!executable) {
+        snprintf(reason, reason_size, "the W^X policy forbids executable mappings");
+        return false;
+    }
+    return true;
+}
+
+JitProgram* jit_compile(Interpreter* interp, Statement** statements, size_t count) {
+    if (!JIT_NATIVE || !interp || !statements || count == 0 || count > UINT32_MAX) {
+        return NULL;
+    }
+    JitProgram* program = calloc(1, sizeof(JitProgram));
+    if (!program) {
+        return NULL;
+    }
+    program->interp = interp;
+    program->statements = statements;
+    program->count = count;
+    program->slots = calloc(count, sizeof(Value*));
+    program->slot_names = calloc(count, sizeof(char*));
+    program->statement_slots = calloc(count, sizeof(int));
+    program->text_offsets = calloc(count, sizeof(size_t));
+    program->text_lengths = calloc(count, sizeof(uint32_t));
+    program->echo = malloc(JIT_ECHO_BUFFER_SIZE);
+    if (!program->slots || !program->slot_names || !program->statement_slots ||
+        !program->text_offsets || !program->text_lengths || !program->echo ||
+        !assign_slots(program) || !format_texts(program) || !generate_code(program)) {
+        free_jit_program(program);
+        return NULL;
+    }
+    return program;
+}
+
+bool jit_execute(JitProgram* program) {
+    if (!program || !program->code) {
+        return false;
+    }
+    JitFunction function;
+    memcpy(&function, &program->code, sizeof(function));
+    bool ok = function(program, program->slots);
+    flush_echo(program);
+    return ok;
+}
+
+void free_jit_program(JitProgram* program) {
+    if (!program) {
+        return;
+    }
+    if (program->code) {
+        munmap(program->code, program->code_size);
+    }
+    free(program->slots);
+    free(program->slot_names);
+    free(program->buckets);
+    free(program->statement_slots);
+    free(program->texts);
+    free(program->text_offsets);
+    free(program->text_lengths);
+    free(program->echo);
+    free(program);
+}
+
+static bool run_batch(Interpreter* interp, Statement** statements, size_t count) {
+    JitProgram* program = jit_compile(interp, statements, count);
+    if (program) {
+        bool ok = jit_execute(program);
+        free_jit_program(program);
+        return ok;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (!execute_statement(interp, statements[i])) {
+            fprintf(interp->output, "Runtime error: %s\n", interp->error_message);
+            return false;
+        }
+    }
+    return true;
+}
+
+void run_jit(Interpreter* interp, char* source) {
+    if (!interp || !source) {
+        return;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    jit_source(interp, source);
+    use_allocator(previous);
+}
+
+static void jit_source(Interpreter* interp, char* source) {
+    char reason[128];
+    if (!jit_available(interp, reason, sizeof(reason))) {
+        fprintf(stderr, "Note: JIT engine unavailable (%s), using the interpreter\n", reason);
+        run(interp, source);
+        return;
+    }
+    Environment* symbols = clone_env(interp->global_env);
+    Lexer* lexer = init_lexer(source);
+    Parser* parser = symbols && lexer ? init_parser(lexer, symbols) : NULL;
+    Statement** statements = malloc(JIT_BATCH_STATEMENTS * sizeof(Statement*));
+    if (!parser || !statements) {
+        free(statements);
+        free_parser(parser);
+        free_lexer(lexer);
+        free_env(symbols);
+        snprintf(interp->error_message, sizeof(interp->error_message), "Failed to initialize JIT engine");
+        interp->has_error = true;
+        return;
+    }
+    parser->records_globals = true;
+    interp->source = source;
+    fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+    bool running = true;
+    while (running) {
+        size_t count = 0;
+        const char* error_prefix = NULL;
+        while (count < JIT_BATCH_STATEMENTS) {
+            if (!parser->current_token || parser->current_token->type == TOKEN_EOF) {
+                running = false;
+                break;
+            }
+            if (parser->has_error) {
+                error_prefix = "Parser error";
+                break;
+            }
+            Statement* stmt = parse_statement(parser);
+            if (!stmt) {
+                error_prefix = parser->has_error ? "Parse error" : NULL;
+                running = false;
+                break;
+            }
+            statements[count++] = stmt;
+        }
+        bool ok = count == 0 || run_batch(interp, statements, count);
+        for (size_t i = 0; i < count; i++) {
+            free_statement(statements[i]);
+        }
+        if (ok && error_prefix) {
+            fprintf(interp->output, "%s: %s\n", error_prefix, parser->error_message);
+        }
+        if (!ok || error_prefix) {
+            running = false;
+        }
+    }
+    free(statements);
+    free_parser(parser);
+    free_lexer(lexer);
+    free_env(symbols);
+    free_line_index(interp->lines);
+    interp->lines = NULL;
+    interp->source = NULL;
+    fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+}
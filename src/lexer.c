@@ -18,38 +18,78 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <ctype.h>
+#include <limits.h>
+#include <stdint.h>
 #include "lexer.h"
+#include "allocator.h"
+#include "utf8.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+static bool is_space_char(char c);
+static bool is_digit_char(char c);
+static bool is_alpha_char(char c);
+static bool is_alnum_char(char c);
+static size_t plain_run(const char* text, size_t length, bool* ascii);
+static size_t scan_string(Lexer* lexer, char* buffer, size_t* invalid);
+static TokenType single_char_token(char current);
+
+/*
+ * Character classes are fixed to ASCII instead of going through <ctype.h>:
+ * the ctype functions consult the process-wide locale, which another
+ * thread may change with setlocale() while an interpreter is lexing.
+ */
+static bool is_space_char(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+static bool is_digit_char(char c) {
+    return c >= '0' && c <= '9';
+}
+
+static bool is_alpha_char(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+static bool is_alnum_char(char c) {
+    return is_alpha_char(c) || is_digit_char(c);
+}
 
 Lexer* init_lexer(char* source) {
     if (!source) {
         return NULL;
     }
-    Lexer* lexer = malloc(sizeof(Lexer));
+    return init_lexer_with_length(source, strlen(source));
+}
+
+Lexer* init_lexer_with_length(char* source, size_t length) {
+    if (!source) {
+        return NULL;
+    }
+    Lexer* lexer = mem_alloc(sizeof(Lexer));
     if (!lexer) {
         return NULL;
     }
     lexer->source = source;
     lexer->position = 0;
-    lexer->length = strlen(source);
-    lexer->line = 1;
-    lexer->column = 1;
+    lexer->length = length;
     return lexer;
 }
 
+void lexer_seek(Lexer* lexer, size_t offset) {
+    if (!lexer) {
+        return;
+    }
+    lexer->position = offset < lexer->length ? offset : lexer->length;
+}
+
 char next_char(Lexer* lexer) {
     if (!lexer || lexer->position >= lexer->length) {
         return '\0';
     }
-    char current = lexer->source[lexer->position];
-    lexer->position++;
-    if (current == '\n') {
-        lexer->line++;
-        lexer->column = 1;
-    } else {
-        lexer->column++;
-    }
-    return current;
+    return lexer->source[lexer->position++];
 }
 
 void skip_whitespace(Lexer* lexer) {
@@ -58,7 +98,7 @@ void skip_whitespace(Lexer* lexer) {
     }
     while (lexer->position < lexer->length) {
         char current = lexer->source[lexer->position];
-        if (isspace(current)) {
+        if (is_space_char(current)) {
             next_char(lexer);
         } else {
             break;
@@ -66,26 +106,82 @@ void skip_whitespace(Lexer* lexer) {
     }
 }
 
-char* read_string(Lexer* lexer) {
-    if (!lexer) {
-        return NULL;
+/*
+ * Length of the run of bytes that need no escape processing: everything up
+ * to the next '"' or '\\', found 16 bytes at a time with SSE2.
+ */
+static size_t plain_run(const char* text, size_t length, bool* ascii) {
+    size_t position = 0;
+    unsigned high = 0;
+#if defined(__SSE2__)
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for (; position + 16 <= length; position += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(text + position));
+        unsigned mask = (unsigned)_mm_movemask_epi8(
+            _mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)));
+        if (mask) {
+            position += (size_t)__builtin_ctz(mask);
+            *ascii = !high && !((unsigned)_mm_movemask_epi8(chunk) & (mask - 1) & ~mask);
+            return position;
+        }
+        high |= (unsigned)_mm_movemask_epi8(chunk);
     }
-    char* buffer = malloc(MAX_STRING_LENGTH);
-    if (!buffer) {
-        return NULL;
+#endif
+    while (position < length && text[position] != '"' && text[position] != '\\') {
+        high |= (unsigned char)text[position] & 0x80;
+        position++;
     }
+    *ascii = !high;
+    return position;
+}
+
+/*
+ * Copies a string literal into buffer. Runs of plain bytes are copied with
+ * memcpy, after utf8_validate() when plain_run() saw a non-ASCII byte; a
+ * literal longer than the buffer is cut at a code point boundary. On a
+ * malformed sequence, *invalid is set to its offset and the lexer is left
+ * just past it (or at the end of the input when the sequence may simply be
+ * incomplete).
+ */
+static size_t scan_string(Lexer* lexer, char* buffer, size_t* invalid) {
     size_t index = 0;
-    char current;
+    *invalid = SIZE_MAX;
     
     next_char(lexer);
     
     while (lexer->position < lexer->length && index < MAX_STRING_LENGTH - 1) {
-        current = lexer->source[lexer->position];
+        const char* text = lexer->source + lexer->position;
+        bool ascii;
+        size_t run = plain_run(text, lexer->length - lexer->position, &ascii);
+        size_t room = MAX_STRING_LENGTH - 1 - index;
+        bool truncated = run > room;
+        if (truncated) {
+            run = room;
+            for (int back = 1; back < UTF8_MAX_SEQUENCE && run > 0 &&
+                               ((unsigned char)text[run] & 0xC0) == 0x80; back++) {
+                run--;
+            }
+        }
+        size_t valid = ascii ? run : utf8_validate(text, run);
+        if (valid < run) {
+            size_t offset = lexer->position + valid;
+            *invalid = offset;
+            lexer->position = lexer->length - offset < UTF8_MAX_SEQUENCE ? lexer->length : offset + 1;
+            break;
+        }
+        memcpy(buffer + index, text, run);
+        index += run;
+        lexer->position += run;
+        if (truncated || lexer->position >= lexer->length || index >= MAX_STRING_LENGTH - 1) {
+            break;
+        }
+        char current = lexer->source[lexer->position];
         if (current == '"') {
             next_char(lexer);
             break;
         }
-        if (current == '\\' && lexer->position + 1 < lexer->length) {
+        if (lexer->position + 1 < lexer->length) {
             next_char(lexer);
             char escaped = lexer->source[lexer->position];
             switch (escaped) {
@@ -105,6 +201,9 @@ char* read_string(Lexer* lexer) {
                     buffer[index++] = '"';
                     break;
                 default:
+                    if ((unsigned char)escaped >= 0x80) {
+                        continue;
+                    }
                     buffer[index++] = escaped;
                     break;
             }
@@ -116,111 +215,189 @@ char* read_string(Lexer* lexer) {
     }
     
     buffer[index] = '\0';
-    return buffer;
+    return index;
 }
 
-Token* next_token(Lexer* lexer) {
+char* read_string(Lexer* lexer) {
     if (!lexer) {
         return NULL;
     }
+    char* buffer = mem_alloc(MAX_STRING_LENGTH);
+    if (!buffer) {
+        return NULL;
+    }
+    size_t invalid;
+    scan_string(lexer, buffer, &invalid);
+    if (invalid != SIZE_MAX) {
+        mem_free(buffer);
+        return NULL;
+    }
+    return buffer;
+}
+
+static TokenType single_char_token(char current) {
+    switch (current) {
+        case '=':
+            return TOKEN_ASSIGN;
+        case ';':
+            return TOKEN_SEMICOLON;
+        case '+':
+            return TOKEN_PLUS;
+        case '-':
+            return TOKEN_MINUS;
+        case '*':
+            return TOKEN_MULTIPLY;
+        case '/':
+            return TOKEN_DIVIDE;
+        case '(':
+            return TOKEN_LPAREN;
+        case ')':
+            return TOKEN_RPAREN;
+        case '{':
+            return TOKEN_LBRACE;
+        case '}':
+            return TOKEN_RBRACE;
+        case '[':
+            return TOKEN_LBRACKET;
+        case ']':
+            return TOKEN_RBRACKET;
+        case ',':
+            return TOKEN_COMMA;
+        default:
+            return TOKEN_UNKNOWN;
+    }
+}
+
+bool scan_lexeme(Lexer* lexer, Lexeme* lexeme) {
+    if (!lexer || !lexeme) {
+        return false;
+    }
     skip_whitespace(lexer);
+    lexeme->offset = lexer->position;
+    lexeme->text = NULL;
+    lexeme->length = 0;
+    lexeme->int_val = 0;
+    lexeme->char_val = '\0';
     if (lexer->position >= lexer->length) {
-        return create_token(TOKEN_EOF, NULL, lexer->line, lexer->column);
+        lexeme->type = TOKEN_EOF;
+        return true;
     }
     char current = lexer->source[lexer->position];
-    int start_line = lexer->line;
-    int start_col = lexer->column;
-    if (isdigit(current)) {
-        int start_pos = lexer->position;
-        while (lexer->position < lexer->length && isdigit(lexer->source[lexer->position])) {
+    size_t start_pos = lexer->position;
+    if (is_digit_char(current)) {
+        long value = 0;
+        while (lexer->position < lexer->length && is_digit_char(lexer->source[lexer->position])) {
+            int digit = lexer->source[lexer->position] - '0';
+            value = value > (LONG_MAX - digit) / 10 ? LONG_MAX : value * 10 + digit;
             next_char(lexer);
         }
-        char* num_str = malloc(lexer->position - start_pos + 1);
-        strncpy(num_str, lexer->source + start_pos, lexer->position - start_pos);
-        num_str[lexer->position - start_pos] = '\0';
-        int value = atoi(num_str);
-        free(num_str);
-        return create_token(TOKEN_NUMBER, &value, start_line, start_col);
-    }
-    if (isalpha(current) || current == '_') {
-        int start_pos = lexer->position;
+        lexeme->type = TOKEN_NUMBER;
+        lexeme->int_val = (int)value;
+        return true;
+    }
+    if (is_alpha_char(current) || current == '_') {
         while (lexer->position < lexer->length && 
-               (isalnum(lexer->source[lexer->position]) || lexer->source[lexer->position] == '_')) {
+               (is_alnum_char(lexer->source[lexer->position]) || lexer->source[lexer->position] == '_')) {
             next_char(lexer);
         }
-        char* identifier = malloc(lexer->position - start_pos + 1);
-        strncpy(identifier, lexer->source + start_pos, lexer->position - start_pos);
-        identifier[lexer->position - start_pos] = '\0';
-        TokenType type = TOKEN_IDENTIFIER;
-        if (strcmp(identifier, "int") == 0) {
-            type = TOKEN_KEYWORD_INT;
-        } else if (strcmp(identifier, "char") == 0) {
-            type = TOKEN_KEYWORD_CHAR;
-        } else if (strcmp(identifier, "string") == 0) {
-            type = TOKEN_KEYWORD_STRING;
+        lexeme->text = lexer->source + start_pos;
+        lexeme->length = lexer->position - start_pos;
+        lexeme->type = TOKEN_IDENTIFIER;
+        if (lexeme->length == 3 && strncmp(lexeme->text, "int", 3) == 0) {
+            lexeme->type = TOKEN_KEYWORD_INT;
+        } else if (lexeme->length == 4 && strncmp(lexeme->text, "char", 4) == 0) {
+            lexeme->type = TOKEN_KEYWORD_CHAR;
+        } else if (lexeme->length == 6 && strncmp(lexeme->text, "string", 6) == 0) {
+            lexeme->type = TOKEN_KEYWORD_STRING;
+        } else if (lexeme->length == 6 && strncmp(lexeme->text, "repeat", 6) == 0) {
+            lexeme->type = TOKEN_KEYWORD_REPEAT;
         }
-        Token* token = create_token(type, identifier, start_line, start_col);
-        free(identifier);
-        return token;
+        return true;
     }
     
     if (current == '"') {
-        char* string_val = read_string(lexer);
-        Token* token = create_token(TOKEN_STRING_LITERAL, string_val, start_line, start_col);
-        free(string_val);
-        return token;
+        size_t invalid;
+        lexeme->length = scan_string(lexer, lexer->text, &invalid);
+        lexeme->text = lexer->text;
+        lexeme->type = TOKEN_STRING_LITERAL;
+        if (invalid != SIZE_MAX) {
+            lexeme->offset = invalid;
+            lexeme->length = 0;
+            lexeme->type = TOKEN_INVALID_UTF8;
+        }
+        return true;
     }
     
     if (current == '\'') {
         next_char(lexer);
         if (lexer->position < lexer->length) {
-            char char_val = lexer->source[lexer->position];
-            next_char(lexer);
+            uint32_t char_val = (unsigned char)lexer->source[lexer->position];
+            size_t size = 1;
+            if (char_val >= 0x80) {
+                size = utf8_decode(lexer->source + lexer->position, lexer->length - lexer->position,
+                                   &char_val);
+                if (size == 0) {
+                    lexeme->offset = lexer->position;
+                    lexeme->type = TOKEN_INVALID_UTF8;
+                    lexer->position = lexer->length - lexer->position < UTF8_MAX_SEQUENCE
+                        ? lexer->length : lexer->position + 1;
+                    return true;
+                }
+            }
+            lexer->position += size;
             if (lexer->position < lexer->length && lexer->source[lexer->position] == '\'') {
                 next_char(lexer);
-                return create_token(TOKEN_CHAR_LITERAL, &char_val, start_line, start_col);
+                lexeme->type = TOKEN_CHAR_LITERAL;
+                lexeme->char_val = char_val;
+                return true;
             }
         }
     }
-    switch (current) {
-        case '=':
-            next_char(lexer);
-            return create_token(TOKEN_ASSIGN, NULL, start_line, start_col);
-        case ';':
-            next_char(lexer);
-            return create_token(TOKEN_SEMICOLON, NULL, start_line, start_col);
-        case '+':
-            next_char(lexer);
-            return create_token(TOKEN_PLUS, NULL, start_line, start_col);
-        case '-':
-            next_char(lexer);
-            return create_token(TOKEN_MINUS, NULL, start_line, start_col);
-        case '*':
-            next_char(lexer);
-            return create_token(TOKEN_MULTIPLY, NULL, start_line, start_col);
-        case '/':
-            next_char(lexer);
-            return create_token(TOKEN_DIVIDE, NULL, start_line, start_col);
-        case '(':
-            next_char(lexer);
-            return create_token(TOKEN_LPAREN, NULL, start_line, start_col);
-        case ')':
-            next_char(lexer);
-            return create_token(TOKEN_RPAREN, NULL, start_line, start_col);
-        case '{':
-            next_char(lexer);
-            return create_token(TOKEN_LBRACE, NULL, start_line, start_col);
-        case '}':
-            next_char(lexer);
-            return create_token(TOKEN_RBRACE, NULL, start_line, start_col);
+    next_char(lexer);
+    lexeme->type = single_char_token(current);
+    return true;
+}
+
+Token* next_token(Lexer* lexer) {
+    Lexeme lexeme;
+    if (!scan_lexeme(lexer, &lexeme)) {
+        return NULL;
+    }
+    Token* token;
+    switch (lexeme.type) {
+        case TOKEN_NUMBER:
+            token = create_token(lexeme.type, &lexeme.int_val, lexeme.offset);
+            break;
+        case TOKEN_CHAR_LITERAL:
+            token = create_token(lexeme.type, &lexeme.char_val, lexeme.offset);
+            break;
+        case TOKEN_STRING_LITERAL:
+            token = create_token(lexeme.type, lexer->text, lexeme.offset);
+            break;
+        case TOKEN_IDENTIFIER:
+        case TOKEN_KEYWORD_INT:
+        case TOKEN_KEYWORD_CHAR:
+        case TOKEN_KEYWORD_STRING:
+        case TOKEN_KEYWORD_REPEAT: {
+            char* identifier = mem_alloc(lexeme.length + 1);
+            if (!identifier) {
+                return NULL;
+            }
+            memcpy(identifier, lexeme.text, lexeme.length);
+            identifier[lexeme.length] = '\0';
+            token = create_token(lexeme.type, identifier, lexeme.offset);
+            mem_free(identifier);
+            break;
+        }
         default:
-            next_char(lexer);
-            return create_token(TOKEN_UNKNOWN, NULL, start_line, start_col);
+            token = create_token(lexeme.type, NULL, lexeme.offset);
+            break;
     }
+    return token;
 }
 
 void free_lexer(Lexer* lexer) {
     if (lexer) {
-        free(lexer);
+        mem_free(lexer);
     }
 }
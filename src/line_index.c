@@ -0,0 +1,142 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Line Index Implementation
+ * ============================================================================
+ * 
+ * Implementation of the lazy newline offset index. scan_newlines() extends
+ * the table from the last scanned byte up to the requested offset; with
+ * SSE2 it compares 16 bytes against '\n' at once and walks the resulting
+ * bit mask, so lines of any length cost one compare per 16 bytes.
+ * 
+ * source holds the byte at offset `base`; scanning never reads before it
+ * because line_index_rebase() scans up to the new base before moving on.
+ * 
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include "line_index.h"
+#include "allocator.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+static bool add_line_start(LineIndex* index, size_t start);
+static bool scan_newlines(LineIndex* index, size_t end);
+
+LineIndex* create_line_index(const char* source) {
+    if (!source) {
+        return NULL;
+    }
+    LineIndex* index = mem_alloc(sizeof(LineIndex));
+    if (!index) {
+        return NULL;
+    }
+    index->capacity = 64;
+    index->line_starts = mem_alloc(index->capacity * sizeof(size_t));
+    if (!index->line_starts) {
+        mem_free(index);
+        return NULL;
+    }
+    index->source = source;
+    index->base = 0;
+    index->line_starts[0] = 0;
+    index->line_count = 1;
+    index->scanned = 0;
+    return index;
+}
+
+static bool add_line_start(LineIndex* index, size_t start) {
+    if (index->line_count == index->capacity) {
+        size_t capacity = index->capacity * 2;
+        size_t* line_starts = mem_realloc(index->line_starts, capacity * sizeof(size_t));
+        if (!line_starts) {
+            return false;
+        }
+        index->line_starts = line_starts;
+        index->capacity = capacity;
+    }
+    index->line_starts[index->line_count++] = start;
+    return true;
+}
+
+static bool scan_newlines(LineIndex* index, size_t end) {
+    const char* source = index->source;
+    size_t base = index->base;
+    size_t position = index->scanned;
+#if defined(__SSE2__)
+    const __m128i newline = _mm_set1_epi8('\n');
+    for (; position + 16 <= end; position += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(source + (position - base)));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, newline));
+        size_t line_count = index->line_count;
+        while (mask) {
+            if (!add_line_start(index, position + (size_t)__builtin_ctz(mask) + 1)) {
+                index->line_count = line_count;
+                return false;
+            }
+            mask &= mask - 1;
+        }
+        index->scanned = position + 16;
+    }
+#endif
+    for (; position < end; position++) {
+        if (source[position - base] == '\n' && !add_line_start(index, position + 1)) {
+            return false;
+        }
+        index->scanned = position + 1;
+    }
+    return true;
+}
+
+bool line_index_rebase(LineIndex* index, const char* source, size_t base) {
+    if (!index || base < index->base) {
+        return false;
+    }
+    if (base > index->scanned && !scan_newlines(index, base)) {
+        return false;
+    }
+    index->source = source;
+    index->base = base;
+    return true;
+}
+
+bool line_index_position(LineIndex* index, size_t offset, int* line, int* column) {
+    *line = 0;
+    *column = 0;
+    if (!index) {
+        return false;
+    }
+    if (offset > index->scanned && !scan_newlines(index, offset)) {
+        return false;
+    }
+    size_t low = 0;
+    size_t high = index->line_count;
+    while (high - low > 1) {
+        size_t mid = low + (high - low) / 2;
+        if (index->line_starts[mid] <= offset) {
+            low = mid;
+        } else {
+            high = mid;
+        }
+    }
+    *line = (int)low + 1;
+    *column = (int)(offset - index->line_starts[low]) + 1;
+    return true;
+}
+
+int line_index_line(LineIndex* index, size_t offset) {
+    int line;
+    int column;
+    line_index_position(index, offset, &line, &column);
+    return line;
+}
+
+void free_line_index(LineIndex* index) {
+    if (!index) {
+        return;
+    }
+    mem_free(index->line_starts);
+    mem_free(index);
+}
@@ -0,0 +1,408 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Linked Execution Implementation
+ * ============================================================================
+ *
+ * Implementation of `--link`. The front end runs in two fan-outs over the
+ * same worker threads, each of which takes the next unclaimed file from an
+ * atomic counter: the first reads, tokenizes and collects declarations,
+ * the second parses. The second needs every file's declarations, so it
+ * starts only once the first has finished for all of them.
+ *
+ * Workers install the interpreter's allocator, so statements parsed on
+ * any thread are released by the executing one under the same allocator.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "int_array.h"
+#include "linked.h"
+#include "parallel.h"
+#include "stream.h"
+#include "token_buffer.h"
+#include "undo_log.h"
+
+typedef struct {
+    const char* name;
+    ValueType type;
+} LinkedDeclaration;
+
+typedef struct {
+    char* filename;
+    char* source;
+    Lexer* lexer;
+    TokenBuffer* tokens;
+    LinkedDeclaration* declarations;
+    size_t declaration_count;
+    Environment* symbols;
+    Parser* parser;
+    Statement** statements;
+    size_t count;
+    const char* error_prefix;
+    size_t error_offset;
+    size_t error_start;
+    LineIndex* lines;
+    bool failed;
+} LinkedFile;
+
+struct LinkedRun;
+
+typedef void (*LinkStage)(struct LinkedRun* run, size_t index);
+
+typedef struct LinkedRun {
+    LinkedFile* files;
+    size_t count;
+    size_t next;
+    LinkStage stage;
+    const Environment* env;
+    const Allocator* allocator;
+} LinkedRun;
+
+static bool collect_declarations(LinkedFile* file);
+static void read_stage(LinkedRun* run, size_t index);
+static bool seed_symbols(LinkedRun* run, size_t index);
+static void parse_stage(LinkedRun* run, size_t index);
+static void* stage_main(void* arg);
+static void run_stage(LinkedRun* run, LinkStage stage);
+static void locate(LinkedFile* file, size_t offset, int* line, int* column);
+static void strip_position(char* message, int line, int column);
+static void report(Interpreter* interp, LinkedFile* file, const char* prefix, char* message,
+                   size_t offset);
+static bool execute_file(Interpreter* interp, LinkedFile* file);
+static void release_file(LinkedFile* file);
+static LinkStatus link_files(Interpreter* interp, char** filenames, size_t count);
+
+/*
+ * Records each global the file declares: a type keyword outside every
+ * brace, an optional `[N]`, then the name. Only the first declaration of a
+ * name counts, as in the parser.
+ */
+static bool collect_declarations(LinkedFile* file) {
+    TokenBuffer* tokens = file->tokens;
+    file->declarations = malloc((tokens->count + 1) * sizeof(LinkedDeclaration));
+    if (!file->declarations) {
+        return false;
+    }
+    int depth = 0;
+    for (size_t i = 0; i < tokens->count; i++) {
+        TokenType type = (TokenType)tokens->types[i];
+        if (type == TOKEN_LBRACE) {
+            depth++;
+        } else if (type == TOKEN_RBRACE) {
+            depth = depth > 0 ? depth - 1 : 0;
+        }
+        if (depth > 0 || (type != TOKEN_KEYWORD_INT && type != TOKEN_KEYWORD_CHAR &&
+                          type != TOKEN_KEYWORD_STRING)) {
+            continue;
+        }
+        ValueType value_type = type == TOKEN_KEYWORD_INT ? TYPE_INT
+                               : type == TOKEN_KEYWORD_CHAR ? TYPE_CHAR : TYPE_STRING;
+        size_t name = i + 1;
+        if (value_type == TYPE_INT && token_buffer_type(tokens, name) == TOKEN_LBRACKET) {
+            value_type = TYPE_INT_ARRAY;
+            name += 3;
+        }
+        if (token_buffer_type(tokens, name) == TOKEN_IDENTIFIER && name < tokens->count) {
+            LinkedDeclaration* declaration = &file->declarations[file->declaration_count++];
+            declaration->name = tokens->pool + tokens->values[name];
+            declaration->type = value_type;
+        }
+    }
+    return true;
+}
+
+static void read_stage(LinkedRun* run, size_t index) {
+    LinkedFile* file = &run->files[index];
+    file->source = read_source(file->filename);
+    file->lexer = file->source ? init_lexer(file->source) : NULL;
+    file->tokens = file->lexer ? tokenize_source(file->lexer) : NULL;
+    file->failed = !file->tokens || !collect_declarations(file);
+}
+
+/*
+ * Gives file `index` the symbols its parser would hold after parsing the
+ * files before it: the environment's variables and their declarations.
+ */
+static bool seed_symbols(LinkedRun* run, size_t index) {
+    LinkedFile* file = &run->files[index];
+    file->symbols = clone_env(run->env);
+    if (!file->symbols) {
+        return false;
+    }
+    for (size_t f = 0; f < index; f++) {
+        LinkedFile* earlier = &run->files[f];
+        for (size_t d = 0; d < earlier->declaration_count; d++) {
+            char* name = (char*)earlier->declarations[d].name;
+            if (variable_exists(file->symbols, name)) {
+                continue;
+            }
+            Value* value = init_value(earlier->declarations[d].type);
+            if (value && value->type == TYPE_INT_ARRAY) {
+                value->data.array_val = create_int_array(1, 0);
+            }
+            bool stored = value && (value->type != TYPE_INT_ARRAY || value->data.array_val) &&
+                          set_variable(file->symbols, name, value);
+            free_value(value);
+            if (!stored) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static void parse_stage(LinkedRun* run, size_t index) {
+    LinkedFile* file = &run->files[index];
+    size_t capacity = 256;
+    file->statements = malloc(capacity * sizeof(Statement*));
+    file->parser = file->statements && seed_symbols(run, index)
+                   ? init_parser_buffered(file->tokens, file->symbols) : NULL;
+    if (!file->parser) {
+        file->failed = true;
+        return;
+    }
+    Parser* parser = file->parser;
+    parser->records_globals = true;
+    while (parser->current_token && parser->current_token->type != TOKEN_EOF) {
+        if (parser->has_error) {
+            file->error_prefix = "Parser error";
+            break;
+        }
+        file->error_start = parser->current_token->offset;
+        Statement* stmt = parse_statement(parser);
+        if (!stmt) {
+            file->error_prefix = parser->has_error ? "Parse error" : NULL;
+            break;
+        }
+        if (file->count == capacity) {
+            Statement** grown = realloc(file->statements, capacity * 2 * sizeof(Statement*));
+            if (!grown) {
+                free_statement(stmt);
+                file->error_prefix = "Parse error";
+                snprintf(parser->error_message, sizeof(parser->error_message), "Out of memory");
+                break;
+            }
+            file->statements = grown;
+            capacity *= 2;
+        }
+        file->statements[file->count++] = stmt;
+    }
+    if (file->error_prefix && parser->current_token) {
+        file->error_offset = parser->current_token->offset;
+    }
+}
+
+static void* stage_main(void* arg) {
+    LinkedRun* run = arg;
+    const Allocator* previous = use_allocator(run->allocator);
+    size_t index;
+    while ((index = __atomic_fetch_add(&run->next, 1, __ATOMIC_RELAXED)) < run->count) {
+        if (!run->files[index].failed) {
+            run->stage(run, index);
+        }
+    }
+    use_allocator(previous);
+    return NULL;
+}
+
+/*
+ * Runs `stage` on every file over up to one thread per CPU; a thread that
+ * cannot be started leaves its share to the calling thread.
+ */
+static void run_stage(LinkedRun* run, LinkStage stage) {
+    run->stage = stage;
+    run->next = 0;
+    int workers = parallel_default_workers();
+    if ((size_t)workers > run->count) {
+        workers = (int)run->count;
+    }
+    pthread_t threads[PARALLEL_MAX_WORKERS];
+    bool started[PARALLEL_MAX_WORKERS];
+    for (int w = 1; w < workers; w++) {
+        started[w] = pthread_create(&threads[w], NULL, stage_main, run) == 0;
+    }
+    stage_main(run);
+    for (int w = 1; w < workers; w++) {
+        if (started[w]) {
+            pthread_join(threads[w], NULL);
+        }
+    }
+}
+
+static void locate(LinkedFile* file, size_t offset, int* line, int* column) {
+    if (!file->lines) {
+        file->lines = create_line_index(file->source);
+    }
+    *line = 0;
+    *column = 0;
+    line_index_position(file->lines, offset, line, column);
+}
+
+/*
+ * Removes the " at line N" (and ", column M") that the parser and the
+ * interpreter put in their messages, when it names the position the
+ * file:line:col prefix already gives.
+ */
+static void strip_position(char* message, int line, int column) {
+    char position[64];
+    int length = snprintf(position, sizeof(position), " at line %d", line);
+    char* found = NULL;
+    for (char* at = strstr(message, position); at; at = strstr(at + 1, position)) {
+        if (at[length] < '0' || at[length] > '9') {
+            found = at;
+        }
+    }
+    if (!found) {
+        return;
+    }
+    char* end = found + length;
+    char suffix[64];
+    int suffix_length = snprintf(suffix, sizeof(suffix), ", column %d", column);
+    if (strncmp(end, suffix, (size_t)suffix_length) == 0 &&
+        (end[suffix_length] < '0' || end[suffix_length] > '9')) {
+        end += suffix_length;
+    }
+    memmove(found, end, strlen(end) + 1);
+}
+
+/*
+ * Rewrites `message` as "file:line:col: message" for the statement or
+ * token at `offset`, and prints it after `prefix`.
+ */
+static void report(Interpreter* interp, LinkedFile* file, const char* prefix, char* message,
+                   size_t offset) {
+    char located[sizeof(interp->error_message) * 2];
+    int line;
+    int column;
+    locate(file, offset, &line, &column);
+    strip_position(message, line, column);
+    snprintf(located, sizeof(located), "%s:%d:%d: %s", file->filename, line, column, message);
+    size_t length = strnlen(located, sizeof(interp->error_message) - 1);
+    memcpy(message, located, length);
+    message[length] = '\0';
+    fprintf(interp->output, "%s: %s\n", prefix, message);
+}
+
+/*
+ * Executes the file's statements, then reports its parse error if it has
+ * one; returns false once the linked run must stop. A parse error that
+ * gives a column is located at the token the parser stopped on, one that
+ * gives only a line at the start of its statement.
+ */
+static bool execute_file(Interpreter* interp, LinkedFile* file) {
+    free_line_index(interp->lines);
+    interp->lines = NULL;
+    interp->source = file->source;
+    for (size_t i = 0; i < file->count; i++) {
+        if (!execute_statement(interp, file->statements[i])) {
+            report(interp, file, "Runtime error", interp->error_message, file->statements[i]->offset);
+            return false;
+        }
+    }
+    if (file->error_prefix) {
+        char* message = file->parser->error_message;
+        report(interp, file, file->error_prefix, message,
+               strstr(message, ", column ") ? file->error_offset : file->error_start);
+        return false;
+    }
+    return true;
+}
+
+static void release_file(LinkedFile* file) {
+    for (size_t i = 0; i < file->count; i++) {
+        free_statement(file->statements[i]);
+    }
+    free(file->statements);
+    free_parser(file->parser);
+    free_env(file->symbols);
+    free(file->declarations);
+    free_token_buffer(file->tokens);
+    free_lexer(file->lexer);
+    free_line_index(file->lines);
+    free(file->source);
+}
+
+LinkStatus run_linked(Interpreter* interp, char** filenames, size_t count) {
+    if (!interp || !filenames || count == 0) {
+        return LINK_START_FAILED;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    LinkStatus status = link_files(interp, filenames, count);
+    use_allocator(previous);
+    return status;
+}
+
+static LinkStatus link_files(Interpreter* interp, char** filenames, size_t count) {
+    LinkedRun run;
+    memset(&run, 0, sizeof(run));
+    run.files = calloc(count, sizeof(LinkedFile));
+    run.count = count;
+    run.env = interp->global_env;
+    run.allocator = interp->allocator;
+    Execution exec;
+    memset(&exec, 0, sizeof(exec));
+    if (interp->transactional) {
+        exec.undo_log = create_undo_log();
+    }
+    if (!run.files || (interp->transactional && !exec.undo_log)) {
+        free_undo_log(exec.undo_log);
+        free(run.files);
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to initialize linked run");
+        interp->has_error = true;
+        return LINK_START_FAILED;
+    }
+    for (size_t i = 0; i < count; i++) {
+        run.files[i].filename = filenames[i];
+    }
+
+    run_stage(&run, read_stage);
+    LinkStatus status = LINK_COMPLETED;
+    for (size_t i = 0; i < count && status == LINK_COMPLETED; i++) {
+        if (!run.files[i].source) {
+            status = LINK_READ_FAILED;
+        } else if (run.files[i].failed) {
+            status = LINK_START_FAILED;
+        }
+    }
+    if (status == LINK_COMPLETED) {
+        run_stage(&run, parse_stage);
+        for (size_t i = 0; i < count; i++) {
+            if (run.files[i].failed) {
+                status = LINK_START_FAILED;
+            }
+        }
+    }
+    if (status != LINK_COMPLETED) {
+        for (size_t i = 0; i < count; i++) {
+            release_file(&run.files[i]);
+        }
+        free(run.files);
+        free_undo_log(exec.undo_log);
+        if (status == LINK_START_FAILED) {
+            snprintf(interp->error_message, sizeof(interp->error_message),
+                     "Failed to prepare linked files");
+            interp->has_error = true;
+        }
+        return status;
+    }
+
+    interp->global_env->undo_log = exec.undo_log;
+    fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+    for (size_t i = 0; i < count && !exec.failed; i++) {
+        exec.failed = !execute_file(interp, &run.files[i]);
+    }
+    end_execution(interp, &exec);
+    fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+    for (size_t i = 0; i < count; i++) {
+        release_file(&run.files[i]);
+    }
+    free(run.files);
+    return LINK_COMPLETED;
+}
@@ -9,7 +9,7 @@
  * interpreter components for complete program execution.
  * 
  * Core Functionality:
- * - Command-line argument validation and processing
+ * - Command-line argument and option validation and processing
  * - Source file loading and validation
  * - Interpreter initialization and execution
  * - Comprehensive cleanup and error handling
@@ -21,16 +21,190 @@
  * ============================================================================
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "interpreter.h"
 #include "utils.h"
+#include "watch.h"
+#include "pipeline.h"
+#include "profiler.h"
+#include "trace.h"
+#include "emit_c.h"
+#include "jit.h"
+#include "parallel.h"
+#include "stream.h"
+#include "query.h"
+#include "perf_counters.h"
+#include "linked.h"
 
+typedef struct {
+    char* filename;
+    bool transactional;
+    bool buffered_tokens;
+    bool watch;
+    bool pipelined;
+    bool profile_lines;
+    bool heap_stats;
+    char* trace_path;
+    bool emit_c;
+    char* emit_path;
+    bool compile;
+    char* compile_path;
+    bool jit;
+    int parallel_workers;
+    char* query;
+    bool perf_counters;
+    char* perf_path;
+    bool link;
+    char* files[LINK_MAX_FILES];
+    size_t file_count;
+} Options;
+
+static bool parse_options(int argc, char** argv, Options* options);
 static void cleanup(Interpreter* interp, char* source_code);
+static int run_unbuffered_file(Interpreter* interp, const Options* options);
+static void print_string_stats(const char* title, Environment* env, FILE* stream);
+static void report_heap_stats(Interpreter* interp);
+static bool finish_trace(Interpreter* interp);
+static bool write_c_file(Interpreter* interp, const Options* options, char* source, const char* path);
+static int translate_file(const Options* options);
+static int query_file(const Options* options);
+static bool finish_perf_counters(PerfCounters* counters, const char* path);
+static int link_files(const Options* options);
+
+static bool parse_options(int argc, char** argv, Options* options) {
+    options->filename = NULL;
+    options->transactional = false;
+    options->buffered_tokens = false;
+    options->watch = false;
+    options->pipelined = false;
+    options->profile_lines = false;
+    options->heap_stats = false;
+    options->trace_path = NULL;
+    options->emit_c = false;
+    options->emit_path = NULL;
+    options->compile = false;
+    options->compile_path = NULL;
+    options->jit = false;
+    options->parallel_workers = 0;
+    options->query = NULL;
+    options->perf_counters = false;
+    options->perf_path = NULL;
+    options->link = false;
+    options->file_count = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--transactional") == 0) {
+            options->transactional = true;
+        } else if (strcmp(argv[i], "--token-buffer") == 0) {
+            options->buffered_tokens = true;
+        } else if (strcmp(argv[i], "--watch") == 0) {
+            options->watch = true;
+        } else if (strcmp(argv[i], "--pipeline") == 0) {
+            options->pipelined = true;
+        } else if (strcmp(argv[i], "--profile-lines") == 0) {
+            options->profile_lines = true;
+        } else if (strcmp(argv[i], "--heap-stats") == 0) {
+            options->heap_stats = true;
+        } else if (strncmp(argv[i], "--trace=", 8) == 0 && argv[i][8] != '\0') {
+            options->trace_path = argv[i] + 8;
+        } else if (strcmp(argv[i], "--emit-c") == 0) {
+            options->emit_c = true;
+        } else if (strncmp(argv[i], "--emit-c=", 9) == 0 && argv[i][9] != '\0') {
+            options->emit_c = true;
+            options->emit_path = argv[i] + 9;
+        } else if (strcmp(argv[i], "--compile") == 0) {
+            options->compile = true;
+        } else if (strncmp(argv[i], "--compile=", 10) == 0 && argv[i][10] != '\0') {
+            options->compile = true;
+            options->compile_path = argv[i] + 10;
+        } else if (strcmp(argv[i], "--engine=interp") == 0) {
+            options->jit = false;
+        } else if (strcmp(argv[i], "--engine=jit") == 0) {
+            options->jit = true;
+        } else if (strcmp(argv[i], "--parallel") == 0) {
+            options->parallel_workers = parallel_default_workers();
+        } else if (strncmp(argv[i], "--parallel=", 11) == 0) {
+            char* end;
+            long workers = strtol(argv[i] + 11, &end, 10);
+            if (end == argv[i] + 11 || *end != '\0' || workers < 1 || workers > PARALLEL_MAX_WORKERS) {
+                return false;
+            }
+            options->parallel_workers = (int)workers;
+        } else if (strncmp(argv[i], "--query=", 8) == 0 && argv[i][8] != '\0') {
+            options->query = argv[i] + 8;
+        } else if (strcmp(argv[i], "--perf-counters") == 0) {
+            options->perf_counters = true;
+        } else if (strncmp(argv[i], "--perf-counters=", 16) == 0 && argv[i][16] != '\0') {
+            options->perf_counters = true;
+            options->perf_path = argv[i] + 16;
+        } else if (strcmp(argv[i], "--link") == 0) {
+            options->link = true;
+        } else if (strncmp(argv[i], "--", 2) == 0 || options->file_count == LINK_MAX_FILES) {
+            return false;
+        } else {
+            options->files[options->file_count++] = argv[i];
+        }
+    }
+    options->filename = options->file_count > 0 ? options->files[0] : NULL;
+    if (options->file_count > 1 && !options->link) {
+        return false;
+    }
+    if (options->pipelined && (options->watch || options->buffered_tokens)) {
+        return false;
+    }
+    if ((options->heap_stats || options->trace_path) && options->watch) {
+        return false;
+    }
+    if ((options->emit_c || options->compile) &&
+        (options->transactional || options->watch || options->pipelined ||
+         options->profile_lines || options->heap_stats || options->trace_path)) {
+        return false;
+    }
+    if (options->compile && options->emit_c && !options->emit_path) {
+        return false;
+    }
+    if (options->jit &&
+        (options->watch || options->pipelined || options->buffered_tokens || options->profile_lines ||
+         options->trace_path || options->emit_c || options->compile)) {
+        return false;
+    }
+    if (options->parallel_workers > 0 &&
+        (options->jit || options->watch || options->pipelined || options->buffered_tokens ||
+         options->profile_lines || options->trace_path || options->emit_c || options->compile)) {
+        return false;
+    }
+    if (options->profile_lines && (options->pipelined || options->watch || options->buffered_tokens)) {
+        return false;
+    }
+    if (is_compressed_source_name(options->filename) && (options->watch || options->pipelined)) {
+        return false;
+    }
+    if (options->query &&
+        (options->transactional || options->buffered_tokens || options->watch || options->pipelined ||
+         options->profile_lines || options->heap_stats || options->trace_path || options->emit_c ||
+         options->compile || options->jit || options->parallel_workers > 0)) {
+        return false;
+    }
+    if (options->perf_counters &&
+        (options->watch || options->pipelined || options->profile_lines || options->emit_c ||
+         options->compile || options->jit || options->parallel_workers > 0 || options->query)) {
+        return false;
+    }
+    if (options->link &&
+        (options->watch || options->pipelined || options->profile_lines || options->trace_path ||
+         options->emit_c || options->compile || options->jit || options->parallel_workers > 0 ||
+         options->query || options->perf_counters)) {
+        return false;
+    }
+    return options->filename != NULL;
+}
 
 static void cleanup(Interpreter* interp, char* source_code) {
     if (interp) {
+        close_trace(interp->trace);
         free_interpreter(interp);
     }
     if (source_code) {
@@ -38,41 +212,358 @@ static void cleanup(Interpreter* interp, char* source_code) {
     }
 }
 
+static void print_string_stats(const char* title, Environment* env, FILE* stream) {
+    StringHeapStats stats;
+    env_string_stats(env, &stats);
+    fprintf(stream, "%s: %zu strings, %zu bytes of text in %zu bytes of blocks, "
+            "%zu bytes reserved in %zu slabs, fragmentation %.1f%%, RSS %zu bytes\n",
+            title, stats.live_strings, stats.live_bytes, stats.used_bytes,
+            stats.reserved_bytes, stats.slab_count, stats.fragmentation * 100.0,
+            resident_set_bytes());
+}
+
+static void report_heap_stats(Interpreter* interp) {
+    fprintf(stderr, "\n=== STRING HEAP ===\n");
+    print_string_stats("Before compaction", interp->global_env, stderr);
+    if (compact_env_strings(interp->global_env)) {
+        print_string_stats("After compaction ", interp->global_env, stderr);
+    }
+}
+
+static bool finish_trace(Interpreter* interp) {
+    if (!interp->trace) {
+        return true;
+    }
+    bool written = close_trace(interp->trace);
+    interp->trace = NULL;
+    if (!written) {
+        error("Failed to write trace file", 0, 0);
+    }
+    return written;
+}
+
+static bool write_c_file(Interpreter* interp, const Options* options, char* source, const char* path) {
+    FILE* out = path ? fopen(path, "w") : stdout;
+    if (!out) {
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Cannot open '%s' for writing", path);
+        interp->has_error = true;
+        return false;
+    }
+    bool written = emit_c_program(interp, options->filename, source, out);
+    if (path && fclose(out) != 0 && written) {
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to write '%s'", path);
+        interp->has_error = true;
+        written = false;
+    }
+    return written;
+}
+
+static int translate_file(const Options* options) {
+    char* source_code = read_source(options->filename);
+    if (!source_code) {
+        error("Failed to read source file", 0, 0);
+        return EXIT_FAILURE;
+    }
+    Interpreter* interp = init_interpreter();
+    if (!interp) {
+        error("Failed to initialize interpreter", 0, 0);
+        free(source_code);
+        return EXIT_FAILURE;
+    }
+    interp->buffered_tokens = options->buffered_tokens;
+    const char* c_path = options->emit_path && strcmp(options->emit_path, "-") != 0
+                         ? options->emit_path : NULL;
+    char temporary[] = "/tmp/pong-XXXXXX.c";
+    if (options->compile && !c_path) {
+        int fd = mkstemps(temporary, 2);
+        if (fd < 0) {
+            error("Cannot create temporary C file", 0, 0);
+            cleanup(interp, source_code);
+            return EXIT_FAILURE;
+        }
+        close(fd);
+        c_path = temporary;
+    }
+    bool ok = write_c_file(interp, options, source_code, c_path);
+    if (!ok) {
+        error(interp->error_message, 0, 0);
+    }
+    if (ok && options->compile) {
+        size_t length = strlen(options->filename) - source_extension_length(options->filename);
+        char* binary = options->compile_path ? strdup(options->compile_path)
+                                             : strndup(options->filename, length);
+        ok = binary && compile_c_program(c_path, binary);
+        if (ok) {
+            printf("Compiled %s to %s\n", options->filename, binary);
+        } else {
+            error("C compilation failed", 0, 0);
+        }
+        free(binary);
+    }
+    if (c_path == temporary) {
+        remove(temporary);
+    }
+    cleanup(interp, source_code);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+static int query_file(const Options* options) {
+    Query* query = create_query(options->query);
+    if (!query) {
+        error("Invalid variable list for --query", 0, 0);
+        return EXIT_FAILURE;
+    }
+    char* source_code = read_source(options->filename);
+    if (!source_code) {
+        error("Failed to read source file", 0, 0);
+        free_query(query);
+        return EXIT_FAILURE;
+    }
+    Interpreter* interp = init_interpreter();
+    if (!interp) {
+        error("Failed to initialize interpreter", 0, 0);
+        free_query(query);
+        free(source_code);
+        return EXIT_FAILURE;
+    }
+    if (run_query(interp, query, source_code) == QUERY_FAILED) {
+        error(interp->error_message, 0, 0);
+        free_query(query);
+        cleanup(interp, source_code);
+        return EXIT_FAILURE;
+    }
+    for (size_t i = 0; i < query_count(query); i++) {
+        char* name = query_name(query, i);
+        Value* value = get_variable(interp->global_env, name);
+        if (value) {
+            printf("%s = ", name);
+            fprint_value(stdout, value);
+            putchar('\n');
+        } else {
+            printf("%s is not declared\n", name);
+        }
+    }
+    free_query(query);
+    cleanup(interp, source_code);
+    return EXIT_SUCCESS;
+}
+
+static bool finish_perf_counters(PerfCounters* counters, const char* path) {
+    if (!counters) {
+        return true;
+    }
+    FILE* out = path ? fopen(path, "w") : stderr;
+    bool written = out != NULL;
+    if (out) {
+        print_perf_counters(counters, out);
+        written = !ferror(out);
+        if (path && fclose(out) != 0) {
+            written = false;
+        }
+    }
+    free_perf_counters(counters);
+    if (!written) {
+        error("Failed to write performance counters", 0, 0);
+    }
+    return written;
+}
+
+static int link_files(const Options* options) {
+    printf("Pong Language Interpreter v1.0\n");
+    for (size_t i = 0; i < options->file_count; i++) {
+        printf("Loading file: %s\n", options->files[i]);
+    }
+    printf("================================\n\n");
+    Interpreter* interp = init_interpreter();
+    if (!interp) {
+        error("Failed to initialize interpreter", 0, 0);
+        return EXIT_FAILURE;
+    }
+    interp->transactional = options->transactional;
+    LinkStatus status = run_linked(interp, (char**)options->files, options->file_count);
+    if (status == LINK_READ_FAILED) {
+        error("Failed to read source file", 0, 0);
+        cleanup(interp, NULL);
+        return EXIT_FAILURE;
+    }
+    if (options->heap_stats) {
+        report_heap_stats(interp);
+    }
+    if (interp->has_error) {
+        printf("\nExecution failed with error: %s\n", interp->error_message);
+        cleanup(interp, NULL);
+        return EXIT_FAILURE;
+    }
+    printf("\nProgram executed successfully!\n");
+    cleanup(interp, NULL);
+    return EXIT_SUCCESS;
+}
+
+static int run_unbuffered_file(Interpreter* interp, const Options* options) {
+    bool empty;
+    bool unreadable;
+    if (options->pipelined) {
+        PipelineStatus status = run_pipelined(interp, options->filename);
+        empty = status == PIPELINE_EMPTY_SOURCE;
+        unreadable = status == PIPELINE_READ_FAILED;
+    } else {
+        StreamStatus status = run_streamed(interp, options->filename);
+        empty = status == STREAM_EMPTY_SOURCE;
+        unreadable = status == STREAM_READ_FAILED;
+    }
+    if (empty) {
+        printf("Warning: Source file is empty\n");
+        trace_end(interp->trace, 0, false);
+        finish_trace(interp);
+        cleanup(interp, NULL);
+        return EXIT_SUCCESS;
+    }
+    if (unreadable) {
+        error("Failed to read source file", 0, 0);
+        cleanup(interp, NULL);
+        return EXIT_FAILURE;
+    }
+    if (options->heap_stats) {
+        report_heap_stats(interp);
+    }
+    if (!finish_trace(interp)) {
+        cleanup(interp, NULL);
+        return EXIT_FAILURE;
+    }
+    if (interp->has_error) {
+        printf("\nExecution failed with error: %s\n", interp->error_message);
+        cleanup(interp, NULL);
+        return EXIT_FAILURE;
+    }
+    printf("\nProgram executed successfully!\n");
+    cleanup(interp, NULL);
+    return EXIT_SUCCESS;
+}
+
 int main(int argc, char** argv) {
-    if (argc != 2) {
+    Options options;
+    if (!parse_options(argc, argv, &options)) {
         print_usage(argv[0]);
         return EXIT_FAILURE;
     }
-    char* filename = argv[1];
+    char* filename = options.filename;
     if (!filename || strlen(filename) == 0) {
         error("Invalid filename provided", 0, 0);
         return EXIT_FAILURE;
     }
-    size_t filename_len = strlen(filename);
-    if (filename_len < 5 || strcmp(filename + filename_len - 5, ".pong") != 0) {
-        error("File must have .pong extension", 0, 0);
-        return EXIT_FAILURE;
+    for (size_t i = 0; i < options.file_count; i++) {
+        if (source_extension_length(options.files[i]) == 0) {
+            error("File must have .pong, .pong.gz or .pong.zst extension", 0, 0);
+            return EXIT_FAILURE;
+        }
+    }
+    if (options.link) {
+        return link_files(&options);
+    }
+    if (options.emit_c || options.compile) {
+        return translate_file(&options);
+    }
+    if (options.query) {
+        return query_file(&options);
     }
     printf("Pong Language Interpreter v1.0\n");
     printf("Loading file: %s\n", filename);
     printf("================================\n\n");
-    char* source_code = read_file(filename);
+    bool streamed = is_compressed_source_name(filename) && !options.profile_lines &&
+                    !options.buffered_tokens && !options.jit && options.parallel_workers == 0 &&
+                    !options.perf_counters;
+    if (options.pipelined || streamed) {
+        Interpreter* interp = init_interpreter();
+        if (!interp) {
+            error("Failed to initialize interpreter", 0, 0);
+            return EXIT_FAILURE;
+        }
+        interp->transactional = options.transactional;
+        if (options.trace_path && !(interp->trace = open_trace(options.trace_path))) {
+            error("Failed to open trace file", 0, 0);
+            cleanup(interp, NULL);
+            return EXIT_FAILURE;
+        }
+        return run_unbuffered_file(interp, &options);
+    }
+    PerfCounters* counters = NULL;
+    if (options.perf_counters && !(counters = create_perf_counters())) {
+        error("Failed to initialize performance counters", 0, 0);
+        return EXIT_FAILURE;
+    }
+    perf_phase_begin(counters);
+    char* source_code = read_source(filename);
+    perf_phase_end(counters, PERF_PHASE_READ);
     if (!source_code) {
         error("Failed to read source file", 0, 0);
+        free_perf_counters(counters);
         return EXIT_FAILURE;
     }
     if (strlen(source_code) == 0) {
         printf("Warning: Source file is empty\n");
+        free_perf_counters(counters);
         free(source_code);
         return EXIT_SUCCESS;
     }
     Interpreter* interp = init_interpreter();
     if (!interp) {
         error("Failed to initialize interpreter", 0, 0);
+        free_perf_counters(counters);
         free(source_code);
         return EXIT_FAILURE;
     }
-    run(interp, source_code);
+    interp->transactional = options.transactional;
+    interp->buffered_tokens = options.buffered_tokens;
+    if (options.watch) {
+        int status = run_watch(interp, filename, &source_code);
+        cleanup(interp, source_code);
+        return status;
+    }
+    if (options.trace_path && !(interp->trace = open_trace(options.trace_path))) {
+        error("Failed to open trace file", 0, 0);
+        free_perf_counters(counters);
+        cleanup(interp, source_code);
+        return EXIT_FAILURE;
+    }
+    Profiler* profiler = NULL;
+    if (options.profile_lines) {
+        profiler = create_profiler(source_code);
+        if (!profiler) {
+            error("Failed to initialize line profiler", 0, 0);
+            cleanup(interp, source_code);
+            return EXIT_FAILURE;
+        }
+        interp->profiler = profiler;
+        interp->allocator = profiler_allocator(profiler, interp->allocator);
+    }
+    if (options.jit) {
+        run_jit(interp, source_code);
+    } else if (options.parallel_workers > 0) {
+        run_parallel(interp, source_code, options.parallel_workers);
+    } else if (counters) {
+        run_counted(interp, source_code, counters);
+    } else {
+        run(interp, source_code);
+    }
+    if (!finish_perf_counters(counters, options.perf_path)) {
+        cleanup(interp, source_code);
+        return EXIT_FAILURE;
+    }
+    if (profiler) {
+        print_line_profile(profiler, stderr);
+        interp->allocator = profiler->inner;
+        interp->profiler = NULL;
+        free_profiler(profiler);
+    }
+    if (options.heap_stats) {
+        report_heap_stats(interp);
+    }
+    if (!finish_trace(interp)) {
+        cleanup(interp, source_code);
+        return EXIT_FAILURE;
+    }
     if (interp->has_error) {
         printf("\nExecution failed with error: %s\n", interp->error_message);
         cleanup(interp, source_code);
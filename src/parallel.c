@@ -0,0 +1,486 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Parallel Execution Implementation
+ * ============================================================================
+ *
+ * Implementation of the partitioned executor.
+ *
+ * The whole script is parsed up front against a symbol environment, as in
+ * the pipelined mode, so partitioning can see every statement. Global
+ * names are interned into a hash table and joined with union-find when a
+ * block assigns more than one of them; a statement's worker is then the
+ * FNV-1a hash of its partition's representative name modulo the worker
+ * count, so independent variables spread over the workers.
+ *
+ * Workers only read the shared statements and write their own Interpreter,
+ * memory stream and offset array; the single shared word is the failure
+ * flag each worker checks before every statement. A worker that cannot
+ * start a thread is run on the calling thread after the others finish.
+ *
+ * On success the variables of each worker's environment list (newest
+ * first) are matched with its global declarations walked backwards, and
+ * declared in the interpreter's environment in statement order, which
+ * reproduces the list run() would have built.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "parallel.h"
+
+typedef struct {
+    char** names;
+    int* parent;
+    size_t count;
+    size_t capacity;
+    int* buckets;
+    size_t bucket_mask;
+} NameTable;
+
+struct ParallelRun;
+
+typedef struct {
+    struct ParallelRun* run;
+    Interpreter* interp;
+    FILE* stream;
+    char* output;
+    size_t output_size;
+    size_t* indices;
+    size_t* ends;
+    size_t count;
+    bool failed;
+} ParallelWorker;
+
+typedef struct ParallelRun {
+    Statement** statements;
+    size_t count;
+    int* owner;
+    ParallelWorker* workers;
+    int worker_count;
+    int failed;
+    const Allocator* allocator;
+} ParallelRun;
+
+static uint32_t hash_name(const char* name);
+static bool init_names(NameTable* table, size_t expected);
+static int intern_name(NameTable* table, char* name);
+static int find_root(NameTable* table, int id);
+static size_t count_touches(Statement* stmt);
+static bool touch_name(NameTable* table, char* name, int* key);
+static bool touch_array(NameTable* table, Statement* stmt, int* key);
+static bool touch_concat(NameTable* table, Statement* stmt, int* key);
+static bool touch_block(NameTable* table, Statement* stmt, int* key);
+static void free_names(NameTable* table);
+static bool partition_statements(ParallelRun* run);
+static void* worker_main(void* arg);
+static void merge_output(ParallelRun* run, FILE* output);
+static bool merge_environment(ParallelRun* run, Environment* env);
+static void release_workers(ParallelRun* run);
+static void parallel_source(Interpreter* interp, char* source, int workers);
+
+static uint32_t hash_name(const char* name) {
+    uint32_t hash = 2166136261u;
+    for (; *name; name++) {
+        hash ^= (uint8_t)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool init_names(NameTable* table, size_t expected) {
+    size_t bucket_count = 16;
+    while (bucket_count < expected * 2) {
+        bucket_count *= 2;
+    }
+    table->capacity = expected > 0 ? expected : 1;
+    table->count = 0;
+    table->names = malloc(table->capacity * sizeof(char*));
+    table->parent = malloc(table->capacity * sizeof(int));
+    table->buckets = calloc(bucket_count, sizeof(int));
+    table->bucket_mask = bucket_count - 1;
+    return table->names && table->parent && table->buckets;
+}
+
+/*
+ * Returns the id of a global name, adding it on first sight. There are at
+ * most as many names as statements touch, so the table never grows.
+ */
+static int intern_name(NameTable* table, char* name) {
+    size_t bucket = hash_name(name) & table->bucket_mask;
+    while (table->buckets[bucket] != 0) {
+        int id = table->buckets[bucket] - 1;
+        if (strcmp(table->names[id], name) == 0) {
+            return id;
+        }
+        bucket = (bucket + 1) & table->bucket_mask;
+    }
+    if (table->count == table->capacity) {
+        return -1;
+    }
+    int id = (int)table->count++;
+    table->names[id] = name;
+    table->parent[id] = id;
+    table->buckets[bucket] = id + 1;
+    return id;
+}
+
+static int find_root(NameTable* table, int id) {
+    while (table->parent[id] != id) {
+        table->parent[id] = table->parent[table->parent[id]];
+        id = table->parent[id];
+    }
+    return id;
+}
+
+static size_t count_touches(Statement* stmt) {
+    if (stmt->type == STMT_REPEAT) {
+        return count_touches(stmt->data.repeat.body);
+    }
+    if (stmt->type == STMT_ARRAY) {
+        return 2;
+    }
+    if (stmt->type == STMT_CONCAT) {
+        return 1 + stmt->data.concat.count;
+    }
+    if (stmt->type != STMT_BLOCK) {
+        return 1;
+    }
+    size_t count = 0;
+    for (size_t i = 0; i < stmt->data.block.count; i++) {
+        count += count_touches(stmt->data.block.statements[i]);
+    }
+    return count;
+}
+
+static bool touch_name(NameTable* table, char* name, int* key) {
+    int id = intern_name(table, name);
+    if (id < 0) {
+        return false;
+    }
+    if (*key < 0) {
+        *key = id;
+    } else {
+        table->parent[find_root(table, id)] = find_root(table, *key);
+    }
+    return true;
+}
+
+/*
+ * copy() and the reductions read one variable and write another, so both
+ * must end up on the same worker.
+ */
+static bool touch_array(NameTable* table, Statement* stmt, int* key) {
+    ArrayStatement* op = &stmt->data.array;
+    if (op->array.depth == GLOBAL_DEPTH && !touch_name(table, op->array.name, key)) {
+        return false;
+    }
+    return !op->other.name || op->other.depth != GLOBAL_DEPTH ||
+           touch_name(table, op->other.name, key);
+}
+
+/*
+ * A concatenation writes its target from its variable operands.
+ */
+static bool touch_concat(NameTable* table, Statement* stmt, int* key) {
+    ConcatStatement* concat = &stmt->data.concat;
+    if (concat->target.depth == GLOBAL_DEPTH && !touch_name(table, concat->target.name, key)) {
+        return false;
+    }
+    for (size_t i = 0; i < concat->count; i++) {
+        VariableReference* variable = &concat->operands[i].variable;
+        if (variable->name && variable->depth == GLOBAL_DEPTH &&
+            !touch_name(table, variable->name, key)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool touch_block(NameTable* table, Statement* stmt, int* key) {
+    BlockStatement* block = &stmt->data.block;
+    for (size_t i = 0; i < block->count; i++) {
+        Statement* inner = block->statements[i];
+        bool ok = true;
+        if (inner->type == STMT_BLOCK) {
+            ok = touch_block(table, inner, key);
+        } else if (inner->type == STMT_REPEAT) {
+            ok = touch_block(table, inner->data.repeat.body, key);
+        } else if (inner->type == STMT_ASSIGNMENT && inner->data.assignment.depth == GLOBAL_DEPTH) {
+            ok = touch_name(table, inner->data.assignment.var_name, key);
+        } else if (inner->type == STMT_ARRAY) {
+            ok = touch_array(table, inner, key);
+        } else if (inner->type == STMT_CONCAT) {
+            ok = touch_concat(table, inner, key);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void free_names(NameTable* table) {
+    free(table->names);
+    free(table->parent);
+    free(table->buckets);
+}
+
+static bool partition_statements(ParallelRun* run) {
+    NameTable table;
+    int* keys = malloc((run->count + 1) * sizeof(int));
+    size_t touches = 0;
+    for (size_t i = 0; i < run->count; i++) {
+        touches += count_touches(run->statements[i]);
+    }
+    bool ok = keys && init_names(&table, touches);
+    for (size_t i = 0; ok && i < run->count; i++) {
+        Statement* stmt = run->statements[i];
+        keys[i] = -1;
+        if (stmt->type == STMT_DECLARATION && stmt->data.declaration.depth == GLOBAL_DEPTH) {
+            ok = touch_name(&table, stmt->data.declaration.var_name, &keys[i]);
+        } else if (stmt->type == STMT_ASSIGNMENT && stmt->data.assignment.depth == GLOBAL_DEPTH) {
+            ok = touch_name(&table, stmt->data.assignment.var_name, &keys[i]);
+        } else if (stmt->type == STMT_BLOCK) {
+            ok = touch_block(&table, stmt, &keys[i]);
+        } else if (stmt->type == STMT_REPEAT) {
+            ok = touch_block(&table, stmt->data.repeat.body, &keys[i]);
+        } else if (stmt->type == STMT_ARRAY) {
+            ok = touch_array(&table, stmt, &keys[i]);
+        } else if (stmt->type == STMT_CONCAT) {
+            ok = touch_concat(&table, stmt, &keys[i]);
+        }
+    }
+    for (size_t i = 0; ok && i < run->count; i++) {
+        uint32_t hash = keys[i] < 0 ? (uint32_t)i
+                                    : hash_name(table.names[find_root(&table, keys[i])]);
+        int owner = (int)(hash % (uint32_t)run->worker_count);
+        run->owner[i] = owner;
+        run->workers[owner].count++;
+    }
+    for (int w = 0; ok && w < run->worker_count; w++) {
+        ParallelWorker* worker = &run->workers[w];
+        worker->indices = malloc((worker->count + 1) * sizeof(size_t));
+        worker->ends = malloc((worker->count + 1) * sizeof(size_t));
+        ok = worker->indices && worker->ends;
+        worker->count = 0;
+    }
+    for (size_t i = 0; ok && i < run->count; i++) {
+        ParallelWorker* worker = &run->workers[run->owner[i]];
+        worker->indices[worker->count++] = i;
+    }
+    if (keys) {
+        free_names(&table);
+    }
+    free(keys);
+    return ok;
+}
+
+static void* worker_main(void* arg) {
+    ParallelWorker* worker = arg;
+    ParallelRun* run = worker->run;
+    worker->interp = init_interpreter_with_allocator(run->allocator);
+    worker->stream = open_memstream(&worker->output, &worker->output_size);
+    if (!worker->interp || !worker->stream) {
+        worker->failed = true;
+        __atomic_store_n(&run->failed, 1, __ATOMIC_RELEASE);
+        return NULL;
+    }
+    set_interpreter_output(worker->interp, worker->stream);
+    for (size_t k = 0; k < worker->count; k++) {
+        if (__atomic_load_n(&run->failed, __ATOMIC_ACQUIRE)) {
+            worker->failed = true;
+            break;
+        }
+        if (!execute_statement(worker->interp, run->statements[worker->indices[k]])) {
+            worker->failed = true;
+            __atomic_store_n(&run->failed, 1, __ATOMIC_RELEASE);
+            break;
+        }
+        worker->ends[k] = (size_t)ftello(worker->stream);
+    }
+    if (fclose(worker->stream) != 0) {
+        worker->failed = true;
+        __atomic_store_n(&run->failed, 1, __ATOMIC_RELEASE);
+    }
+    worker->stream = NULL;
+    return NULL;
+}
+
+static void merge_output(ParallelRun* run, FILE* output) {
+    size_t cursors[PARALLEL_MAX_WORKERS] = {0};
+    for (size_t i = 0; i < run->count; i++) {
+        ParallelWorker* worker = &run->workers[run->owner[i]];
+        size_t k = cursors[run->owner[i]]++;
+        size_t begin = k > 0 ? worker->ends[k - 1] : 0;
+        fwrite(worker->output + begin, 1, worker->ends[k] - begin, output);
+    }
+}
+
+static bool merge_environment(ParallelRun* run, Environment* env) {
+    Variable** declared = calloc(run->count, sizeof(Variable*));
+    if (!declared) {
+        return false;
+    }
+    for (int w = 0; w < run->worker_count; w++) {
+        ParallelWorker* worker = &run->workers[w];
+        VariableNode* node = worker->interp->global_env->variables;
+        for (size_t k = worker->count; k > 0 && node; k--) {
+            Statement* stmt = run->statements[worker->indices[k - 1]];
+            if (stmt->type == STMT_DECLARATION && stmt->data.declaration.depth == GLOBAL_DEPTH) {
+                declared[worker->indices[k - 1]] = node->variable;
+                node = node->next;
+            }
+        }
+    }
+    bool ok = true;
+    for (size_t i = 0; ok && i < run->count; i++) {
+        if (declared[i]) {
+            ok = declare_variable(env, declared[i]->name, declared[i]->value);
+        }
+    }
+    free(declared);
+    return ok;
+}
+
+static void release_workers(ParallelRun* run) {
+    for (int w = 0; w < run->worker_count; w++) {
+        ParallelWorker* worker = &run->workers[w];
+        if (worker->stream) {
+            fclose(worker->stream);
+        }
+        free(worker->output);
+        free(worker->indices);
+        free(worker->ends);
+        free_interpreter(worker->interp);
+    }
+    free(run->workers);
+    free(run->owner);
+}
+
+int parallel_default_workers(void) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online < 1) {
+        return 1;
+    }
+    return online > PARALLEL_MAX_WORKERS ? PARALLEL_MAX_WORKERS : (int)online;
+}
+
+void run_parallel(Interpreter* interp, char* source, int workers) {
+    if (!interp || !source) {
+        return;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    parallel_source(interp, source, workers);
+    use_allocator(previous);
+}
+
+static void parallel_source(Interpreter* interp, char* source, int workers) {
+    if (interp->global_env->count > 0 || interp->global_env->base) {
+        run(interp, source);
+        return;
+    }
+    Environment* symbols = clone_env(interp->global_env);
+    Lexer* lexer = init_lexer(source);
+    Parser* parser = symbols && lexer ? init_parser(lexer, symbols) : NULL;
+    ParallelRun parallel;
+    memset(&parallel, 0, sizeof(parallel));
+    parallel.allocator = interp->allocator;
+    parallel.worker_count = workers < 1 ? 1 : workers > PARALLEL_MAX_WORKERS ? PARALLEL_MAX_WORKERS : workers;
+    size_t capacity = 1024;
+    parallel.statements = malloc(capacity * sizeof(Statement*));
+    bool ok = parser && parallel.statements;
+    const char* error_prefix = NULL;
+    if (ok) {
+        parser->records_globals = true;
+    }
+    while (ok) {
+        if (!parser->current_token || parser->current_token->type == TOKEN_EOF) {
+            break;
+        }
+        if (parser->has_error) {
+            error_prefix = "Parser error";
+            break;
+        }
+        Statement* stmt = parse_statement(parser);
+        if (!stmt) {
+            error_prefix = parser->has_error ? "Parse error" : NULL;
+            break;
+        }
+        if (parallel.count == capacity) {
+            Statement** statements = realloc(parallel.statements, capacity * 2 * sizeof(Statement*));
+            if (!statements) {
+                free_statement(stmt);
+                ok = false;
+                break;
+            }
+            parallel.statements = statements;
+            capacity *= 2;
+        }
+        parallel.statements[parallel.count++] = stmt;
+    }
+    parallel.owner = malloc((parallel.count + 1) * sizeof(int));
+    parallel.workers = calloc((size_t)parallel.worker_count, sizeof(ParallelWorker));
+    /* a transactional run rolls back on a parse error too; leave that to run() */
+    ok = ok && !(error_prefix && interp->transactional);
+    ok = ok && parallel.owner && parallel.workers && partition_statements(&parallel);
+
+    if (ok) {
+        pthread_t threads[PARALLEL_MAX_WORKERS];
+        bool started[PARALLEL_MAX_WORKERS];
+        for (int w = 0; w < parallel.worker_count; w++) {
+            parallel.workers[w].run = &parallel;
+            started[w] = pthread_create(&threads[w], NULL, worker_main, &parallel.workers[w]) == 0;
+        }
+        for (int w = 0; w < parallel.worker_count; w++) {
+            if (started[w]) {
+                pthread_join(threads[w], NULL);
+            } else {
+                worker_main(&parallel.workers[w]);
+            }
+        }
+        for (int w = 0; w < parallel.worker_count; w++) {
+            ok = ok && !parallel.workers[w].failed;
+        }
+    }
+
+    if (ok) {
+        interp->source = source;
+        fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+        merge_output(&parallel, interp->output);
+        ok = merge_environment(&parallel, interp->global_env);
+        for (int w = 0; w < parallel.worker_count; w++) {
+            interp->executed_statements += parallel.workers[w].interp->executed_statements;
+        }
+        if (ok && error_prefix) {
+            fprintf(interp->output, "%s: %s\n", error_prefix, parser->error_message);
+        }
+        if (!ok) {
+            snprintf(interp->error_message, sizeof(interp->error_message),
+                     "Failed to merge parallel results");
+            interp->has_error = true;
+        }
+        free_line_index(interp->lines);
+        interp->lines = NULL;
+        interp->source = NULL;
+        fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+        fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+    }
+    bool merged = ok || interp->has_error;
+    for (size_t i = 0; i < parallel.count; i++) {
+        free_statement(parallel.statements[i]);
+    }
+    free(parallel.statements);
+    release_workers(&parallel);
+    free_parser(parser);
+    free_lexer(lexer);
+    free_env(symbols);
+    if (!merged) {
+        run(interp, source);
+    }
+}
@@ -11,6 +11,10 @@
  * and build statement structures. It validates syntax according to language
  * grammar rules and provides detailed error reporting for debugging.
  * 
+ * Blocks are parsed completely before anything in them runs; their
+ * declarations are registered in the scope table as they are parsed so
+ * later statements of the block resolve them to frame slots.
+ * 
  * ============================================================================
  */
 
@@ -19,31 +23,150 @@
 #include <stdlib.h>
 #include <string.h>
 #include "parser.h"
+#include "allocator.h"
+#include "profiler.h"
+#include "int_array.h"
 
-Parser* init_parser(Lexer* lexer, Environment* env) {
-    if (!lexer || !env) {
-        return NULL;
-    }
-    Parser* parser = malloc(sizeof(Parser));
+static Parser* create_parser(Lexer* lexer, TokenBuffer* tokens, TokenSource source,
+                             void* source_context, const char* text, Environment* env,
+                             struct Profiler* profiler);
+static Token* pull_token(Parser* parser);
+static int parser_line(Parser* parser, size_t offset);
+static Statement* dispatch_statement(Parser* parser);
+static bool reject_invalid_utf8(Parser* parser);
+static bool parse_array_length(Parser* parser, size_t offset, size_t* length);
+static bool array_function(const char* name, ArrayOperation* operation);
+static bool resolve_reference(Parser* parser, char* name, size_t offset, ValueType expected,
+                              VariableReference* ref);
+static Statement* create_array_statement(ArrayOperation operation, size_t offset);
+static Statement* parse_array_call(Parser* parser, const char* function, size_t offset);
+static Statement* parse_element_assignment(Parser* parser, char* name, size_t offset);
+static bool is_reduction(Parser* parser, ArrayOperation* operation);
+static ConcatOperand* add_operand(ConcatStatement* concat);
+static bool parse_concat_operand(Parser* parser, ConcatStatement* concat, size_t offset);
+static bool same_reference(const VariableReference* a, const VariableReference* b);
+static Statement* parse_concatenation(Parser* parser, const AssignmentStatement* target,
+                                      char* first, size_t offset);
+static Statement* parse_reduction(Parser* parser, ArrayOperation operation,
+                                  const AssignmentStatement* target, size_t offset);
+
+static Parser* create_parser(Lexer* lexer, TokenBuffer* tokens, TokenSource source,
+                             void* source_context, const char* text, Environment* env,
+                             struct Profiler* profiler) {
+    Parser* parser = mem_alloc(sizeof(Parser));
     if (!parser) {
         return NULL;
     }
     parser->lexer = lexer;
+    parser->tokens = tokens;
+    parser->source = source;
+    parser->source_context = source_context;
+    parser->records_globals = source != NULL;
+    parser->text = text;
+    parser->lines = NULL;
+    parser->profiler = profiler;
+    parser->token_index = 0;
     parser->env = env;
+    parser->scopes = create_scope_table();
+    if (!parser->scopes) {
+        mem_free(parser);
+        return NULL;
+    }
     parser->has_error = false;
     parser->error_message[0] = '\0';
-    parser->current_token = next_token(lexer);
+    if (tokens) {
+        token_buffer_fill(tokens, 0, &parser->buffered_token);
+        parser->current_token = &parser->buffered_token;
+    } else {
+        parser->current_token = pull_token(parser);
+    }
     return parser;
 }
 
+static Token* pull_token(Parser* parser) {
+    if (parser->source) {
+        return parser->source(parser->source_context);
+    }
+    if (!parser->profiler) {
+        return next_token(parser->lexer);
+    }
+    uint64_t allocated = parser->profiler->allocated;
+    uint64_t start = profile_clock();
+    Token* token = next_token(parser->lexer);
+    profile_lex(parser->profiler, token, profile_clock() - start,
+                parser->profiler->allocated - allocated);
+    return token;
+}
+
+Parser* init_parser(Lexer* lexer, Environment* env) {
+    return init_parser_profiled(lexer, env, NULL);
+}
+
+/*
+ * The profiler is attached before the first token is pulled, so that
+ * token's lexing is charged like every other.
+ */
+Parser* init_parser_profiled(Lexer* lexer, Environment* env, struct Profiler* profiler) {
+    if (!lexer || !env) {
+        return NULL;
+    }
+    return create_parser(lexer, NULL, NULL, NULL, lexer->source, env, profiler);
+}
+
+Parser* init_parser_buffered(TokenBuffer* tokens, Environment* env) {
+    if (!tokens || tokens->count == 0 || !env) {
+        return NULL;
+    }
+    return create_parser(NULL, tokens, NULL, NULL, tokens->source, env, NULL);
+}
+
+Parser* init_parser_source(TokenSource source, void* context, const char* text,
+                           Environment* symbols) {
+    if (!source || !text || !symbols) {
+        return NULL;
+    }
+    return create_parser(NULL, NULL, source, context, text, symbols, NULL);
+}
+
+void parser_position(Parser* parser, size_t offset, int* line, int* column) {
+    if (!parser->lines) {
+        parser->lines = create_line_index(parser->text);
+    }
+    line_index_position(parser->lines, offset, line, column);
+}
+
+static int parser_line(Parser* parser, size_t offset) {
+    int line;
+    int column;
+    parser_position(parser, offset, &line, &column);
+    return line;
+}
+
+TokenType peek_token_type(Parser* parser, size_t ahead) {
+    if (!parser || !parser->current_token) {
+        return TOKEN_EOF;
+    }
+    if (!parser->tokens) {
+        return ahead == 0 ? parser->current_token->type : TOKEN_UNKNOWN;
+    }
+    return token_buffer_type(parser->tokens, parser->token_index + ahead);
+}
+
 void advance_token(Parser* parser) {
     if (!parser) {
         return;
     }
+    if (parser->tokens) {
+        if (parser->token_index + 1 < parser->tokens->count) {
+            parser->token_index++;
+        }
+        token_buffer_fill(parser->tokens, parser->token_index, &parser->buffered_token);
+        return;
+    }
     if (parser->current_token) {
         free_token(parser->current_token);
     }
-    parser->current_token = next_token(parser->lexer);
+    parser->current_token = pull_token(parser);
 }
 
 bool expect_token(Parser* parser, TokenType expected) {
@@ -51,10 +174,15 @@ bool expect_token(Parser* parser, TokenType expected) {
         return false;
     }
     if (parser->current_token->type != expected) {
+        if (reject_invalid_utf8(parser)) {
+            return false;
+        }
+        int line;
+        int column;
+        parser_position(parser, parser->current_token->offset, &line, &column);
         snprintf(parser->error_message, sizeof(parser->error_message),
                 "Expected token type %d, got %d at line %d, column %d",
-                expected, parser->current_token->type,
-                parser->current_token->line, parser->current_token->column);
+                expected, parser->current_token->type, line, column);
         parser->has_error = true;
         return false;
     }
@@ -65,13 +193,12 @@ Statement* parse_declaration(Parser* parser) {
     if (!parser || !parser->current_token) {
         return NULL;
     }
-    Statement* stmt = malloc(sizeof(Statement));
+    Statement* stmt = mem_alloc(sizeof(Statement));
     if (!stmt) {
         return NULL;
     }
     stmt->type = STMT_DECLARATION;
-    stmt->line = parser->current_token->line;
-    stmt->column = parser->current_token->column;
+    stmt->offset = parser->current_token->offset;
     ValueType var_type;
     switch (parser->current_token->type) {
         case TOKEN_KEYWORD_INT:
@@ -84,35 +211,62 @@ Statement* parse_declaration(Parser* parser) {
             var_type = TYPE_STRING;
             break;
         default:
-            free(stmt);
+            mem_free(stmt);
             return NULL;
     }
     advance_token(parser);
+    size_t length = 0;
+    if (var_type == TYPE_INT && parser->current_token->type == TOKEN_LBRACKET) {
+        if (!parse_array_length(parser, stmt->offset, &length)) {
+            mem_free(stmt);
+            return NULL;
+        }
+        var_type = TYPE_INT_ARRAY;
+    }
     if (!expect_token(parser, TOKEN_IDENTIFIER)) {
-        free(stmt);
+        mem_free(stmt);
         return NULL;
     }
-    stmt->data.declaration.var_name = strdup(parser->current_token->value.string_val);
+    stmt->data.declaration.var_name = mem_strdup(parser->current_token->value.string_val);
     stmt->data.declaration.var_type = var_type;
+    stmt->data.declaration.depth = GLOBAL_DEPTH;
+    stmt->data.declaration.slot = -1;
+    if (parser->scopes->depth > GLOBAL_DEPTH) {
+        ScopeEntry* entry = scope_declare(parser->scopes, stmt->data.declaration.var_name, var_type);
+        if (!entry) {
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                    "Variable '%s' already declared in this block at line %d",
+                    stmt->data.declaration.var_name, parser_line(parser, stmt->offset));
+            parser->has_error = true;
+            mem_free(stmt->data.declaration.var_name);
+            mem_free(stmt);
+            return NULL;
+        }
+        stmt->data.declaration.depth = entry->depth;
+        stmt->data.declaration.slot = entry->slot;
+    }
+    bool record_global = parser->records_globals &&
+                         stmt->data.declaration.depth == GLOBAL_DEPTH &&
+                         !variable_exists(parser->env, stmt->data.declaration.var_name);
     advance_token(parser);
     if (!expect_token(parser, TOKEN_ASSIGN)) {
-        free(stmt->data.declaration.var_name);
-        free(stmt);
+        mem_free(stmt->data.declaration.var_name);
+        mem_free(stmt);
         return NULL;
     }
     advance_token(parser);
     Value* initial_value = init_value(var_type);
     if (!initial_value) {
-        free(stmt->data.declaration.var_name);
-        free(stmt);
+        mem_free(stmt->data.declaration.var_name);
+        mem_free(stmt);
         return NULL;
     }
     switch (var_type) {
         case TYPE_INT:
             if (!expect_token(parser, TOKEN_NUMBER)) {
                 free_value(initial_value);
-                free(stmt->data.declaration.var_name);
-                free(stmt);
+                mem_free(stmt->data.declaration.var_name);
+                mem_free(stmt);
                 return NULL;
             }
             initial_value->data.int_val = parser->current_token->value.int_val;
@@ -120,8 +274,8 @@ Statement* parse_declaration(Parser* parser) {
         case TYPE_CHAR:
             if (!expect_token(parser, TOKEN_CHAR_LITERAL)) {
                 free_value(initial_value);
-                free(stmt->data.declaration.var_name);
-                free(stmt);
+                mem_free(stmt->data.declaration.var_name);
+                mem_free(stmt);
                 return NULL;
             }
             initial_value->data.char_val = parser->current_token->value.char_val;
@@ -129,19 +283,44 @@ Statement* parse_declaration(Parser* parser) {
         case TYPE_STRING:
             if (!expect_token(parser, TOKEN_STRING_LITERAL)) {
                 free_value(initial_value);
-                free(stmt->data.declaration.var_name);
-                free(stmt);
+                mem_free(stmt->data.declaration.var_name);
+                mem_free(stmt);
+                return NULL;
+            }
+            initial_value->data.string_val = mem_strdup(parser->current_token->value.string_val);
+            break;
+        case TYPE_INT_ARRAY:
+            if (!expect_token(parser, TOKEN_NUMBER)) {
+                free_value(initial_value);
+                mem_free(stmt->data.declaration.var_name);
+                mem_free(stmt);
+                return NULL;
+            }
+            initial_value->data.array_val = create_int_array(length, parser->current_token->value.int_val);
+            if (!initial_value->data.array_val) {
+                snprintf(parser->error_message, sizeof(parser->error_message),
+                        "Failed to allocate array '%s' at line %d",
+                        stmt->data.declaration.var_name, parser_line(parser, stmt->offset));
+                parser->has_error = true;
+                free_value(initial_value);
+                mem_free(stmt->data.declaration.var_name);
+                mem_free(stmt);
                 return NULL;
             }
-            initial_value->data.string_val = strdup(parser->current_token->value.string_val);
             break;
     }
     stmt->data.declaration.initial_value = initial_value;
+    if (record_global && !set_variable(parser->env, stmt->data.declaration.var_name, initial_value)) {
+        free_value(initial_value);
+        mem_free(stmt->data.declaration.var_name);
+        mem_free(stmt);
+        return NULL;
+    }
     advance_token(parser);
     if (!expect_token(parser, TOKEN_SEMICOLON)) {
         free_value(initial_value);
-        free(stmt->data.declaration.var_name);
-        free(stmt);
+        mem_free(stmt->data.declaration.var_name);
+        mem_free(stmt);
         return NULL;
     }
     advance_token(parser);
@@ -152,47 +331,74 @@ Statement* parse_assignment(Parser* parser) {
     if (!parser || !parser->current_token) {
         return NULL;
     }
-    Statement* stmt = malloc(sizeof(Statement));
+    Statement* stmt = mem_alloc(sizeof(Statement));
     if (!stmt) {
         return NULL;
     }
     stmt->type = STMT_ASSIGNMENT;
-    stmt->line = parser->current_token->line;
-    stmt->column = parser->current_token->column;
+    stmt->offset = parser->current_token->offset;
     if (!expect_token(parser, TOKEN_IDENTIFIER)) {
-        free(stmt);
+        mem_free(stmt);
         return NULL;
     }
-    stmt->data.assignment.var_name = strdup(parser->current_token->value.string_val);
+    stmt->data.assignment.var_name = mem_strdup(parser->current_token->value.string_val);
     advance_token(parser);
+    TokenType next = parser->current_token->type;
+    if (next == TOKEN_LPAREN || next == TOKEN_LBRACKET) {
+        Statement* array_stmt = next == TOKEN_LPAREN
+            ? parse_array_call(parser, stmt->data.assignment.var_name, stmt->offset)
+            : parse_element_assignment(parser, stmt->data.assignment.var_name, stmt->offset);
+        mem_free(stmt->data.assignment.var_name);
+        mem_free(stmt);
+        return array_stmt;
+    }
     if (!expect_token(parser, TOKEN_ASSIGN)) {
-        free(stmt->data.assignment.var_name);
-        free(stmt);
+        mem_free(stmt->data.assignment.var_name);
+        mem_free(stmt);
         return NULL;
     }
     advance_token(parser);
-    Value* existing_var = get_variable(parser->env, stmt->data.assignment.var_name);
-    if (!existing_var) {
-        snprintf(parser->error_message, sizeof(parser->error_message),
-                "Undefined variable '%s' at line %d", 
-                stmt->data.assignment.var_name, stmt->line);
-        parser->has_error = true;
-        free(stmt->data.assignment.var_name);
-        free(stmt);
-        return NULL;
+    ValueType target_type;
+    ScopeEntry* entry = scope_resolve(parser->scopes, stmt->data.assignment.var_name);
+    if (entry) {
+        target_type = entry->type;
+        stmt->data.assignment.depth = entry->depth;
+        stmt->data.assignment.slot = entry->slot;
+    } else {
+        Value* existing_var = get_variable(parser->env, stmt->data.assignment.var_name);
+        if (!existing_var) {
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                    "Undefined variable '%s' at line %d", 
+                    stmt->data.assignment.var_name, parser_line(parser, stmt->offset));
+            parser->has_error = true;
+            mem_free(stmt->data.assignment.var_name);
+            mem_free(stmt);
+            return NULL;
+        }
+        target_type = existing_var->type;
+        stmt->data.assignment.depth = GLOBAL_DEPTH;
+        stmt->data.assignment.slot = -1;
+    }
+    ArrayOperation operation;
+    if (target_type == TYPE_INT && is_reduction(parser, &operation)) {
+        Statement* reduction = parse_reduction(parser, operation, &stmt->data.assignment,
+                                               stmt->offset);
+        mem_free(stmt->data.assignment.var_name);
+        mem_free(stmt);
+        return reduction;
     }
-    Value* new_value = init_value(existing_var->type);
+    Value* new_value = init_value(target_type);
     if (!new_value) {
-        free(stmt->data.assignment.var_name);
-        free(stmt);
+        mem_free(stmt->data.assignment.var_name);
+        mem_free(stmt);
         return NULL;
     }
-    switch (existing_var->type) {
+    switch (target_type) {
         case TYPE_INT:
             if (!expect_token(parser, TOKEN_NUMBER)) {
                 free_value(new_value);
-                free(stmt->data.assignment.var_name);
-                free(stmt);
+                mem_free(stmt->data.assignment.var_name);
+                mem_free(stmt);
                 return NULL;
             }
             new_value->data.int_val = parser->current_token->value.int_val;
@@ -200,38 +406,176 @@ Statement* parse_assignment(Parser* parser) {
         case TYPE_CHAR:
             if (!expect_token(parser, TOKEN_CHAR_LITERAL)) {
                 free_value(new_value);
-                free(stmt->data.assignment.var_name);
-                free(stmt);
+                mem_free(stmt->data.assignment.var_name);
+                mem_free(stmt);
                 return NULL;
             }
             new_value->data.char_val = parser->current_token->value.char_val;
             break;
         case TYPE_STRING:
+            if (parser->current_token->type == TOKEN_IDENTIFIER) {
+                free_value(new_value);
+                Statement* concat = parse_concatenation(parser, &stmt->data.assignment, NULL,
+                                                        stmt->offset);
+                mem_free(stmt->data.assignment.var_name);
+                mem_free(stmt);
+                return concat;
+            }
             if (!expect_token(parser, TOKEN_STRING_LITERAL)) {
                 free_value(new_value);
-                free(stmt->data.assignment.var_name);
-                free(stmt);
+                mem_free(stmt->data.assignment.var_name);
+                mem_free(stmt);
                 return NULL;
             }
-            new_value->data.string_val = strdup(parser->current_token->value.string_val);
+            new_value->data.string_val = mem_strdup(parser->current_token->value.string_val);
             break;
+        case TYPE_INT_ARRAY:
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                    "Cannot assign to array '%s' at line %d, use fill() or copy()",
+                    stmt->data.assignment.var_name, parser_line(parser, stmt->offset));
+            parser->has_error = true;
+            free_value(new_value);
+            mem_free(stmt->data.assignment.var_name);
+            mem_free(stmt);
+            return NULL;
     }
     stmt->data.assignment.new_value = new_value;
     advance_token(parser);
+    if (target_type == TYPE_STRING && parser->current_token->type == TOKEN_PLUS) {
+        char* first = new_value->data.string_val;
+        new_value->data.string_val = NULL;
+        free_value(new_value);
+        Statement* concat = parse_concatenation(parser, &stmt->data.assignment, first,
+                                                stmt->offset);
+        mem_free(stmt->data.assignment.var_name);
+        mem_free(stmt);
+        return concat;
+    }
     if (!expect_token(parser, TOKEN_SEMICOLON)) {
         free_value(new_value);
-        free(stmt->data.assignment.var_name);
-        free(stmt);
+        mem_free(stmt->data.assignment.var_name);
+        mem_free(stmt);
         return NULL;
     }
     advance_token(parser);
     return stmt;
 }
 
+Statement* parse_block(Parser* parser) {
+    if (!parser || !parser->current_token || !expect_token(parser, TOKEN_LBRACE)) {
+        return NULL;
+    }
+    Statement* stmt = mem_alloc(sizeof(Statement));
+    if (!stmt) {
+        return NULL;
+    }
+    stmt->type = STMT_BLOCK;
+    stmt->offset = parser->current_token->offset;
+    stmt->data.block.statements = NULL;
+    stmt->data.block.count = 0;
+    stmt->data.block.frame_size = 0;
+    if (!scope_enter(parser->scopes)) {
+        int line;
+        int column;
+        parser_position(parser, stmt->offset, &line, &column);
+        snprintf(parser->error_message, sizeof(parser->error_message),
+                "Blocks nested too deeply at line %d, column %d", line, column);
+        parser->has_error = true;
+        mem_free(stmt);
+        return NULL;
+    }
+    advance_token(parser);
+    size_t capacity = 0;
+    bool complete = false;
+    while (parser->current_token) {
+        if (parser->current_token->type == TOKEN_RBRACE) {
+            complete = true;
+            break;
+        }
+        if (parser->current_token->type == TOKEN_EOF) {
+            int line;
+            int column;
+            parser_position(parser, stmt->offset, &line, &column);
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                    "Unterminated block starting at line %d, column %d", line, column);
+            parser->has_error = true;
+            break;
+        }
+        Statement* inner = parse_statement(parser);
+        if (!inner) {
+            break;
+        }
+        if (stmt->data.block.count == capacity) {
+            capacity = capacity ? capacity * 2 : 8;
+            Statement** statements = mem_realloc(stmt->data.block.statements,
+                                                 capacity * sizeof(Statement*));
+            if (!statements) {
+                snprintf(parser->error_message, sizeof(parser->error_message),
+                        "Failed to allocate block at line %d", parser_line(parser, stmt->offset));
+                parser->has_error = true;
+                free_statement(inner);
+                break;
+            }
+            stmt->data.block.statements = statements;
+        }
+        stmt->data.block.statements[stmt->data.block.count++] = inner;
+    }
+    stmt->data.block.frame_size = scope_leave(parser->scopes);
+    if (!complete) {
+        free_statement(stmt);
+        return NULL;
+    }
+    advance_token(parser);
+    return stmt;
+}
+
+Statement* parse_repeat(Parser* parser) {
+    if (!parser || !parser->current_token || !expect_token(parser, TOKEN_KEYWORD_REPEAT)) {
+        return NULL;
+    }
+    Statement* stmt = mem_alloc(sizeof(Statement));
+    if (!stmt) {
+        return NULL;
+    }
+    stmt->type = STMT_REPEAT;
+    stmt->offset = parser->current_token->offset;
+    advance_token(parser);
+    if (!expect_token(parser, TOKEN_NUMBER)) {
+        mem_free(stmt);
+        return NULL;
+    }
+    stmt->data.repeat.count = parser->current_token->value.int_val;
+    advance_token(parser);
+    stmt->data.repeat.body = parse_block(parser);
+    if (!stmt->data.repeat.body) {
+        mem_free(stmt);
+        return NULL;
+    }
+    return stmt;
+}
+
 Statement* parse_statement(Parser* parser) {
     if (!parser || !parser->current_token) {
         return NULL;
     }
+    if (!parser->profiler) {
+        return dispatch_statement(parser);
+    }
+    Profiler* profiler = parser->profiler;
+    uint64_t lex_before = profiler->lex_total;
+    uint64_t lex_bytes_before = profiler->lex_bytes;
+    uint64_t allocated = profiler->allocated;
+    uint64_t start = profile_clock();
+    Statement* stmt = dispatch_statement(parser);
+    uint64_t elapsed = profile_clock() - start;
+    if (stmt && stmt->type != STMT_BLOCK && stmt->type != STMT_REPEAT) {
+        profile_parse(profiler, stmt, elapsed - (profiler->lex_total - lex_before),
+                      profiler->allocated - allocated - (profiler->lex_bytes - lex_bytes_before));
+    }
+    return stmt;
+}
+
+static Statement* dispatch_statement(Parser* parser) {
     switch (parser->current_token->type) {
         case TOKEN_KEYWORD_INT:
         case TOKEN_KEYWORD_CHAR:
@@ -239,15 +583,373 @@ Statement* parse_statement(Parser* parser) {
             return parse_declaration(parser);
         case TOKEN_IDENTIFIER:
             return parse_assignment(parser);
-        default:
+        case TOKEN_LBRACE:
+            return parse_block(parser);
+        case TOKEN_KEYWORD_REPEAT:
+            return parse_repeat(parser);
+        default: {
+            if (reject_invalid_utf8(parser)) {
+                return NULL;
+            }
+            int line;
+            int column;
+            parser_position(parser, parser->current_token->offset, &line, &column);
             snprintf(parser->error_message, sizeof(parser->error_message),
-                    "Unexpected token at line %d, column %d",
-                    parser->current_token->line, parser->current_token->column);
+                    "Unexpected token at line %d, column %d", line, column);
             parser->has_error = true;
             return NULL;
+        }
     }
 }
 
+/*
+ * The lexer turns a malformed UTF-8 sequence in a literal into a token
+ * located at the offending byte; report it as such rather than as an
+ * unexpected token.
+ */
+static bool reject_invalid_utf8(Parser* parser) {
+    if (parser->current_token->type != TOKEN_INVALID_UTF8) {
+        return false;
+    }
+    int line;
+    int column;
+    parser_position(parser, parser->current_token->offset, &line, &column);
+    snprintf(parser->error_message, sizeof(parser->error_message),
+            "Invalid UTF-8 sequence at line %d, column %d", line, column);
+    parser->has_error = true;
+    return true;
+}
+
+/*
+ * Parses the `[N]` of an array declaration, leaving the parser on the
+ * variable name.
+ */
+static bool parse_array_length(Parser* parser, size_t offset, size_t* length) {
+    advance_token(parser);
+    if (!expect_token(parser, TOKEN_NUMBER)) {
+        return false;
+    }
+    int count = parser->current_token->value.int_val;
+    if (count < 1 || count > MAX_ARRAY_LENGTH) {
+        snprintf(parser->error_message, sizeof(parser->error_message),
+                "Array length must be between 1 and %d at line %d",
+                MAX_ARRAY_LENGTH, parser_line(parser, offset));
+        parser->has_error = true;
+        return false;
+    }
+    *length = (size_t)count;
+    advance_token(parser);
+    if (!expect_token(parser, TOKEN_RBRACKET)) {
+        return false;
+    }
+    advance_token(parser);
+    return true;
+}
+
+static bool array_function(const char* name, ArrayOperation* operation) {
+    static const struct {
+        const char* name;
+        ArrayOperation operation;
+    } functions[] = {
+        {"fill", ARRAY_FILL},
+        {"copy", ARRAY_COPY},
+        {"sum", ARRAY_SUM},
+        {"min", ARRAY_MIN},
+        {"max", ARRAY_MAX}
+    };
+    for (size_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+        if (strcmp(name, functions[i].name) == 0) {
+            *operation = functions[i].operation;
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Resolves a variable the way parse_assignment() does and checks that it
+ * holds `expected`; on success `ref` owns a copy of the name.
+ */
+static bool resolve_reference(Parser* parser, char* name, size_t offset, ValueType expected,
+                              VariableReference* ref) {
+    ValueType type;
+    ScopeEntry* entry = scope_resolve(parser->scopes, name);
+    if (entry) {
+        type = entry->type;
+        ref->depth = entry->depth;
+        ref->slot = entry->slot;
+    } else {
+        Value* existing_var = get_variable(parser->env, name);
+        if (!existing_var) {
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                    "Undefined variable '%s' at line %d", name, parser_line(parser, offset));
+            parser->has_error = true;
+            return false;
+        }
+        type = existing_var->type;
+        ref->depth = GLOBAL_DEPTH;
+        ref->slot = -1;
+    }
+    if (type != expected) {
+        snprintf(parser->error_message, sizeof(parser->error_message),
+                "Variable '%s' is not %s at line %d",
+                name, expected == TYPE_INT_ARRAY ? "an int array"
+                      : expected == TYPE_STRING ? "a string" : "an int",
+                parser_line(parser, offset));
+        parser->has_error = true;
+        return false;
+    }
+    ref->name = mem_strdup(name);
+    return ref->name != NULL;
+}
+
+static Statement* create_array_statement(ArrayOperation operation, size_t offset) {
+    Statement* stmt = mem_alloc(sizeof(Statement));
+    if (!stmt) {
+        return NULL;
+    }
+    stmt->type = STMT_ARRAY;
+    stmt->offset = offset;
+    stmt->data.array.operation = operation;
+    stmt->data.array.array.name = NULL;
+    stmt->data.array.other.name = NULL;
+    stmt->data.array.index = 0;
+    stmt->data.array.value = 0;
+    return stmt;
+}
+
+/*
+ * Parses `fill(name, V);` or `copy(dst, src);`, the parser standing on
+ * the opening parenthesis.
+ */
+static Statement* parse_array_call(Parser* parser, const char* function, size_t offset) {
+    ArrayOperation operation;
+    if (!array_function(function, &operation) ||
+        (operation != ARRAY_FILL && operation != ARRAY_COPY)) {
+        snprintf(parser->error_message, sizeof(parser->error_message),
+                "Unknown statement '%s(...)' at line %d", function, parser_line(parser, offset));
+        parser->has_error = true;
+        return NULL;
+    }
+    Statement* stmt = create_array_statement(operation, offset);
+    if (!stmt) {
+        return NULL;
+    }
+    ArrayStatement* array = &stmt->data.array;
+    advance_token(parser);
+    bool ok = expect_token(parser, TOKEN_IDENTIFIER) &&
+              resolve_reference(parser, parser->current_token->value.string_val, offset,
+                                TYPE_INT_ARRAY, &array->array);
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_COMMA);
+    }
+    if (ok) {
+        advance_token(parser);
+        if (operation == ARRAY_FILL) {
+            ok = expect_token(parser, TOKEN_NUMBER);
+            array->value = ok ? parser->current_token->value.int_val : 0;
+        } else {
+            ok = expect_token(parser, TOKEN_IDENTIFIER) &&
+                 resolve_reference(parser, parser->current_token->value.string_val, offset,
+                                   TYPE_INT_ARRAY, &array->other);
+        }
+    }
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_RPAREN);
+    }
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_SEMICOLON);
+    }
+    if (!ok) {
+        free_statement(stmt);
+        return NULL;
+    }
+    advance_token(parser);
+    return stmt;
+}
+
+/*
+ * Parses `name[i] = V;`, the parser standing on the opening bracket.
+ */
+static Statement* parse_element_assignment(Parser* parser, char* name, size_t offset) {
+    Statement* stmt = create_array_statement(ARRAY_SET, offset);
+    if (!stmt) {
+        return NULL;
+    }
+    ArrayStatement* array = &stmt->data.array;
+    bool ok = resolve_reference(parser, name, offset, TYPE_INT_ARRAY, &array->array);
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_NUMBER);
+    }
+    if (ok) {
+        int index = parser->current_token->value.int_val;
+        if (index < 0) {
+            snprintf(parser->error_message, sizeof(parser->error_message),
+                    "Negative index into array '%s' at line %d", name, parser_line(parser, offset));
+            parser->has_error = true;
+            ok = false;
+        }
+        array->index = (size_t)index;
+    }
+    TokenType expected[] = {TOKEN_RBRACKET, TOKEN_ASSIGN, TOKEN_NUMBER};
+    for (size_t i = 0; ok && i < sizeof(expected) / sizeof(expected[0]); i++) {
+        advance_token(parser);
+        ok = expect_token(parser, expected[i]);
+    }
+    if (ok) {
+        array->value = parser->current_token->value.int_val;
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_SEMICOLON);
+    }
+    if (!ok) {
+        free_statement(stmt);
+        return NULL;
+    }
+    advance_token(parser);
+    return stmt;
+}
+
+static bool is_reduction(Parser* parser, ArrayOperation* operation) {
+    return parser->current_token->type == TOKEN_IDENTIFIER &&
+           array_function(parser->current_token->value.string_val, operation) &&
+           *operation != ARRAY_FILL && *operation != ARRAY_COPY;
+}
+
+/*
+ * Parses the `sum(name);` (or min, max) of an assignment to the int
+ * `target`, the parser standing on the function name.
+ */
+static Statement* parse_reduction(Parser* parser, ArrayOperation operation,
+                                  const AssignmentStatement* target, size_t offset) {
+    Statement* stmt = create_array_statement(operation, offset);
+    if (!stmt) {
+        return NULL;
+    }
+    ArrayStatement* array = &stmt->data.array;
+    array->other.name = mem_strdup(target->var_name);
+    array->other.depth = target->depth;
+    array->other.slot = target->slot;
+    advance_token(parser);
+    bool ok = array->other.name && expect_token(parser, TOKEN_LPAREN);
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_IDENTIFIER) &&
+             resolve_reference(parser, parser->current_token->value.string_val, offset,
+                               TYPE_INT_ARRAY, &array->array);
+    }
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_RPAREN);
+    }
+    if (ok) {
+        advance_token(parser);
+        ok = expect_token(parser, TOKEN_SEMICOLON);
+    }
+    if (!ok) {
+        free_statement(stmt);
+        return NULL;
+    }
+    advance_token(parser);
+    return stmt;
+}
+
+static ConcatOperand* add_operand(ConcatStatement* concat) {
+    ConcatOperand* operands = mem_realloc(concat->operands, (concat->count + 1) * sizeof(ConcatOperand));
+    if (!operands) {
+        return NULL;
+    }
+    concat->operands = operands;
+    ConcatOperand* operand = &operands[concat->count++];
+    operand->text = NULL;
+    operand->variable.name = NULL;
+    return operand;
+}
+
+static bool parse_concat_operand(Parser* parser, ConcatStatement* concat, size_t offset) {
+    Token* token = parser->current_token;
+    ConcatOperand* operand = NULL;
+    bool ok;
+    if (token->type == TOKEN_IDENTIFIER) {
+        operand = add_operand(concat);
+        ok = operand && resolve_reference(parser, token->value.string_val, offset, TYPE_STRING,
+                                          &operand->variable);
+    } else {
+        ok = expect_token(parser, TOKEN_STRING_LITERAL) && (operand = add_operand(concat));
+        if (ok) {
+            operand->text = mem_strdup(token->value.string_val);
+            ok = operand->text != NULL;
+        }
+    }
+    if (ok) {
+        advance_token(parser);
+    }
+    return ok;
+}
+
+static bool same_reference(const VariableReference* a, const VariableReference* b) {
+    if (!a->name || !b->name || a->depth != b->depth) {
+        return false;
+    }
+    return a->depth == GLOBAL_DEPTH ? strcmp(a->name, b->name) == 0 : a->slot == b->slot;
+}
+
+/*
+ * Parses the operands of a string assignment to `target` up to the
+ * semicolon. `first` is the literal operand already read, if any (the
+ * parser then stands on the first `+`); the statement takes ownership of it.
+ */
+static Statement* parse_concatenation(Parser* parser, const AssignmentStatement* target,
+                                      char* first, size_t offset) {
+    Statement* stmt = mem_alloc(sizeof(Statement));
+    if (!stmt) {
+        mem_free(first);
+        return NULL;
+    }
+    stmt->type = STMT_CONCAT;
+    stmt->offset = offset;
+    ConcatStatement* concat = &stmt->data.concat;
+    concat->target.name = mem_strdup(target->var_name);
+    concat->target.depth = target->depth;
+    concat->target.slot = target->slot;
+    concat->operands = NULL;
+    concat->count = 0;
+    concat->append = false;
+    bool ok = concat->target.name != NULL;
+    if (first) {
+        ConcatOperand* operand = ok ? add_operand(concat) : NULL;
+        if (operand) {
+            operand->text = first;
+        } else {
+            mem_free(first);
+            ok = false;
+        }
+    } else if (ok) {
+        ok = parse_concat_operand(parser, concat, offset);
+    }
+    while (ok && parser->current_token->type == TOKEN_PLUS) {
+        advance_token(parser);
+        ok = parse_concat_operand(parser, concat, offset);
+    }
+    if (ok) {
+        ok = expect_token(parser, TOKEN_SEMICOLON);
+    }
+    if (!ok) {
+        free_statement(stmt);
+        return NULL;
+    }
+    advance_token(parser);
+    concat->append = concat->count > 1 &&
+                     same_reference(&concat->operands[0].variable, &concat->target);
+    for (size_t i = 1; i < concat->count && concat->append; i++) {
+        concat->append = !same_reference(&concat->operands[i].variable, &concat->target);
+    }
+    return stmt;
+}
+
 void free_statement(Statement* stmt) {
     if (!stmt) {
         return;
@@ -255,7 +957,7 @@ void free_statement(Statement* stmt) {
     switch (stmt->type) {
         case STMT_DECLARATION:
             if (stmt->data.declaration.var_name) {
-                free(stmt->data.declaration.var_name);
+                mem_free(stmt->data.declaration.var_name);
             }
             if (stmt->data.declaration.initial_value) {
                 free_value(stmt->data.declaration.initial_value);
@@ -263,24 +965,47 @@ void free_statement(Statement* stmt) {
             break;
         case STMT_ASSIGNMENT:
             if (stmt->data.assignment.var_name) {
-                free(stmt->data.assignment.var_name);
+                mem_free(stmt->data.assignment.var_name);
             }
             if (stmt->data.assignment.new_value) {
                 free_value(stmt->data.assignment.new_value);
             }
             break;
+        case STMT_BLOCK:
+            for (size_t i = 0; i < stmt->data.block.count; i++) {
+                free_statement(stmt->data.block.statements[i]);
+            }
+            mem_free(stmt->data.block.statements);
+            break;
+        case STMT_REPEAT:
+            free_statement(stmt->data.repeat.body);
+            break;
+        case STMT_ARRAY:
+            mem_free(stmt->data.array.array.name);
+            mem_free(stmt->data.array.other.name);
+            break;
+        case STMT_CONCAT:
+            mem_free(stmt->data.concat.target.name);
+            for (size_t i = 0; i < stmt->data.concat.count; i++) {
+                mem_free(stmt->data.concat.operands[i].text);
+                mem_free(stmt->data.concat.operands[i].variable.name);
+            }
+            mem_free(stmt->data.concat.operands);
+            break;
         default:
             break;
     }
-    free(stmt);
+    mem_free(stmt);
 }
 
 void free_parser(Parser* parser) {
     if (!parser) {
         return;
     }
-    if (parser->current_token) {
+    if (parser->current_token && !parser->tokens) {
         free_token(parser->current_token);
     }
-    free(parser);
+    free_scope_table(parser->scopes);
+    free_line_index(parser->lines);
+    mem_free(parser);
 }
@@ -0,0 +1,342 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Performance Counter Implementation
+ * ============================================================================
+ *
+ * Implementation of the per-phase counters. The events form one group
+ * opened disabled on the calling thread: a phase resets and enables the
+ * group through its leader, and ends by disabling it and reading every
+ * member with a single read() of the leader (PERF_FORMAT_GROUP).
+ *
+ * A reset clears the counts but not the enabled and running times, which
+ * only advance while the group is enabled; each phase scales by the
+ * difference from the previous read.
+ *
+ * A group the PMU cannot schedule at all opens without error but never
+ * runs; a trial read right after opening catches that case, which is then
+ * treated like a denied open.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "perf_counters.h"
+#include "token_buffer.h"
+#include "undo_log.h"
+
+typedef struct {
+    const char* name;
+    uint32_t type;
+    uint64_t config;
+} PerfEvent;
+
+typedef struct {
+    uint64_t count;
+    uint64_t time_enabled;
+    uint64_t time_running;
+    uint64_t values[PERF_MAX_EVENTS];
+} PerfGroupRead;
+
+static const PerfEvent hardware_events[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"l1d_read_misses", PERF_TYPE_HW_CACHE,
+     PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+     (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+};
+
+static const PerfEvent software_events[] = {
+    {"task_clock_ns", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK},
+    {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    {"context_switches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+    {"cpu_migrations", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CPU_MIGRATIONS},
+};
+
+static const char* const phase_names[PERF_PHASE_COUNT] = {"read", "lex", "parse", "execute"};
+
+static uint64_t wall_clock_ns(void);
+static int open_event(const PerfEvent* event, int group);
+static bool read_group(const PerfCounters* counters, PerfGroupRead* result);
+static void close_group(PerfCounters* counters);
+static bool open_group(PerfCounters* counters, const PerfEvent* events, size_t count);
+static const char* unavailable_reason(int error);
+static void counted_source(Interpreter* interp, char* source, PerfCounters* counters);
+
+static uint64_t wall_clock_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static int open_event(const PerfEvent* event, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = event->type;
+    attr.config = event->config;
+    attr.disabled = group < 0;
+    attr.exclude_kernel = event->type != PERF_TYPE_SOFTWARE;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                       PERF_FORMAT_TOTAL_TIME_RUNNING;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, PERF_FLAG_FD_CLOEXEC);
+}
+
+static bool read_group(const PerfCounters* counters, PerfGroupRead* result) {
+    ssize_t length = read(counters->leader, result, sizeof(*result));
+    return length >= (ssize_t)(3 * sizeof(uint64_t)) && result->count == counters->event_count;
+}
+
+static void close_group(PerfCounters* counters) {
+    for (size_t i = 0; i < counters->event_count; i++) {
+        close(counters->fds[i]);
+    }
+    counters->event_count = 0;
+    counters->leader = -1;
+}
+
+/*
+ * Opens the first event as the group leader and adds the others that the
+ * kernel accepts; fails with errno set when the leader is refused or the
+ * group cannot be made to count.
+ */
+static bool open_group(PerfCounters* counters, const PerfEvent* events, size_t count) {
+    int leader = open_event(&events[0], -1);
+    if (leader < 0) {
+        return false;
+    }
+    counters->leader = leader;
+    counters->fds[0] = leader;
+    counters->names[0] = events[0].name;
+    counters->event_count = 1;
+    for (size_t i = 1; i < count; i++) {
+        int fd = open_event(&events[i], leader);
+        if (fd >= 0) {
+            counters->fds[counters->event_count] = fd;
+            counters->names[counters->event_count] = events[i].name;
+            counters->event_count++;
+        }
+    }
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    PerfGroupRead trial;
+    if (!read_group(counters, &trial) || trial.time_running == 0) {
+        close_group(counters);
+        errno = EOPNOTSUPP;
+        return false;
+    }
+    counters->time_enabled = trial.time_enabled;
+    counters->time_running = trial.time_running;
+    return true;
+}
+
+PerfCounters* create_perf_counters(void) {
+    PerfCounters* counters = calloc(1, sizeof(PerfCounters));
+    if (!counters) {
+        return NULL;
+    }
+    counters->leader = -1;
+    counters->source = PERF_SOURCE_HARDWARE;
+    if (open_group(counters, hardware_events, sizeof(hardware_events) / sizeof(hardware_events[0]))) {
+        return counters;
+    }
+    counters->hardware_error = errno;
+    counters->source = PERF_SOURCE_SOFTWARE;
+    if (open_group(counters, software_events, sizeof(software_events) / sizeof(software_events[0]))) {
+        return counters;
+    }
+    counters->source = PERF_SOURCE_NONE;
+    return counters;
+}
+
+void perf_phase_begin(PerfCounters* counters) {
+    if (!counters) {
+        return;
+    }
+    if (counters->leader >= 0) {
+        ioctl(counters->leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(counters->leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+    counters->started_ns = wall_clock_ns();
+}
+
+/*
+ * Adds what the group counted since perf_phase_begin() to `phase`, so a
+ * phase may be measured in several pieces.
+ */
+void perf_phase_end(PerfCounters* counters, PerfPhase phase) {
+    if (!counters || phase >= PERF_PHASE_COUNT) {
+        return;
+    }
+    uint64_t now = wall_clock_ns();
+    PerfGroupRead result;
+    if (counters->leader >= 0) {
+        ioctl(counters->leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+    }
+    counters->wall_ns[phase] += now - counters->started_ns;
+    if (counters->leader < 0 || !read_group(counters, &result)) {
+        return;
+    }
+    uint64_t enabled = result.time_enabled - counters->time_enabled;
+    uint64_t running = result.time_running - counters->time_running;
+    counters->time_enabled = result.time_enabled;
+    counters->time_running = result.time_running;
+    if (running == 0) {
+        return;
+    }
+    double scale = (double)enabled / (double)running;
+    for (size_t i = 0; i < counters->event_count; i++) {
+        counters->values[phase][i] += running < enabled
+                                      ? (uint64_t)((double)result.values[i] * scale)
+                                      : result.values[i];
+    }
+}
+
+static const char* unavailable_reason(int error) {
+    switch (error) {
+        case EACCES:
+        case EPERM:
+            return "access denied, see /proc/sys/kernel/perf_event_paranoid";
+        case ENOENT:
+        case ENODEV:
+        case EOPNOTSUPP:
+            return "no hardware counters on this CPU or virtual machine";
+        case ENOSYS:
+            return "perf_event_open is not supported by this kernel";
+        default:
+            return strerror(error);
+    }
+}
+
+void print_perf_counters(const PerfCounters* counters, FILE* stream) {
+    if (!counters || !stream) {
+        return;
+    }
+    static const char* const source_names[] = {"hardware", "software", "none"};
+    fprintf(stream, "{\n  \"counters\": \"%s\",\n", source_names[counters->source]);
+    if (counters->source != PERF_SOURCE_HARDWARE) {
+        fprintf(stream, "  \"hardware_unavailable\": \"%s\",\n", unavailable_reason(counters->hardware_error));
+    }
+    fputs("  \"phases\": {\n", stream);
+    for (int phase = 0; phase < PERF_PHASE_COUNT; phase++) {
+        fprintf(stream, "    \"%s\": {\"wall_ns\": %llu", phase_names[phase],
+                (unsigned long long)counters->wall_ns[phase]);
+        for (size_t i = 0; i < counters->event_count; i++) {
+            fprintf(stream, ", \"%s\": %llu", counters->names[i],
+                    (unsigned long long)counters->values[phase][i]);
+        }
+        fputs(phase + 1 < PERF_PHASE_COUNT ? "},\n" : "}\n", stream);
+    }
+    fputs("  }\n}\n", stream);
+}
+
+void free_perf_counters(PerfCounters* counters) {
+    if (!counters) {
+        return;
+    }
+    close_group(counters);
+    free(counters);
+}
+
+void run_counted(Interpreter* interp, char* source, PerfCounters* counters) {
+    if (!interp || !source || !counters) {
+        return;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    counted_source(interp, source, counters);
+    use_allocator(previous);
+}
+
+static void counted_source(Interpreter* interp, char* source, PerfCounters* counters) {
+    Execution exec;
+    memset(&exec, 0, sizeof(exec));
+    Environment* symbols = clone_env(interp->global_env);
+    size_t capacity = 1024;
+    size_t count = 0;
+    Statement** statements = malloc(capacity * sizeof(Statement*));
+
+    perf_phase_begin(counters);
+    exec.lexer = init_lexer(source);
+    exec.tokens = exec.lexer ? tokenize_source(exec.lexer) : NULL;
+    perf_phase_end(counters, PERF_PHASE_LEX);
+
+    exec.parser = exec.tokens && symbols ? init_parser_buffered(exec.tokens, symbols) : NULL;
+    if (interp->transactional) {
+        exec.undo_log = create_undo_log();
+    }
+    if (!statements || !exec.parser || (interp->transactional && !exec.undo_log)) {
+        free_undo_log(exec.undo_log);
+        free_parser(exec.parser);
+        free_token_buffer(exec.tokens);
+        free_lexer(exec.lexer);
+        free_env(symbols);
+        free(statements);
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to initialize counted run");
+        interp->has_error = true;
+        return;
+    }
+    exec.parser->records_globals = true;
+    const char* error_prefix = NULL;
+    perf_phase_begin(counters);
+    while (exec.parser->current_token && exec.parser->current_token->type != TOKEN_EOF) {
+        if (exec.parser->has_error) {
+            error_prefix = "Parser error";
+            break;
+        }
+        Statement* stmt = parse_statement(exec.parser);
+        if (!stmt) {
+            error_prefix = exec.parser->has_error ? "Parse error" : NULL;
+            break;
+        }
+        if (count == capacity) {
+            Statement** grown = realloc(statements, capacity * 2 * sizeof(Statement*));
+            if (!grown) {
+                free_statement(stmt);
+                error_prefix = "Parse error";
+                snprintf(exec.parser->error_message, sizeof(exec.parser->error_message),
+                         "Out of memory");
+                break;
+            }
+            statements = grown;
+            capacity *= 2;
+        }
+        statements[count++] = stmt;
+    }
+    perf_phase_end(counters, PERF_PHASE_PARSE);
+
+    interp->source = source;
+    interp->global_env->undo_log = exec.undo_log;
+    fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+    perf_phase_begin(counters);
+    for (size_t i = 0; i < count && !exec.failed; i++) {
+        if (!execute_statement(interp, statements[i])) {
+            fprintf(interp->output, "Runtime error: %s\n", interp->error_message);
+            exec.failed = true;
+        }
+    }
+    perf_phase_end(counters, PERF_PHASE_EXECUTE);
+    if (!exec.failed && error_prefix) {
+        fprintf(interp->output, "%s: %s\n", error_prefix, exec.parser->error_message);
+        exec.failed = true;
+    }
+    for (size_t i = 0; i < count; i++) {
+        free_statement(statements[i]);
+    }
+    free(statements);
+    end_execution(interp, &exec);
+    free_env(symbols);
+    fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+}
@@ -0,0 +1,406 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Pipelined Execution Implementation
+ * ============================================================================
+ * 
+ * Implementation of the threaded read → lex → parse → execute pipeline.
+ * 
+ * The reader fills a buffer sized from fstat() and publishes the filled
+ * length with a release store; the lexer runs over that prefix only. A
+ * token that reaches the end of the prefix before the file is fully read
+ * may be incomplete ("12" of "123"), so it is discarded, the lexer is
+ * rewound to its start and the lexer waits for more bytes. Like
+ * read_file() + strlen(), the source ends at the first NUL byte.
+ * 
+ * The parser runs ahead of execution and therefore parses against its own
+ * symbol environment, seeded with a copy of the interpreter's globals
+ * (see init_parser_source()). Partial batches are flushed whenever the
+ * next stage would otherwise have to wait for them.
+ * 
+ * Each stage closes its output ring when it stops, and the consumer side
+ * closes its input ring to make the producer stop early; items still
+ * queued are freed once every thread has been joined.
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "pipeline.h"
+#include "ring.h"
+#include "undo_log.h"
+
+typedef struct {
+    Token* tokens[PIPELINE_BATCH_SIZE];
+    size_t count;
+} TokenBatch;
+
+typedef struct {
+    Statement* statements[PIPELINE_BATCH_SIZE];
+    size_t count;
+    const char* error_prefix;
+    char error_message[256];
+} StatementBatch;
+
+typedef struct {
+    int fd;
+    char* source;
+    size_t capacity;
+    size_t available;
+    int read_done;
+    int cancelled;
+    SpscRing* token_ring;
+    SpscRing* statement_ring;
+    Environment* symbols;
+    TokenBatch* input;
+    size_t input_index;
+    StatementBatch* output;
+    bool stopped;
+    const Allocator* allocator;
+} Pipeline;
+
+static void* reader_main(void* arg);
+static void* lexer_main(void* arg);
+static void* parser_main(void* arg);
+static Token* pull_token_batch(void* context);
+static bool flush_statements(Pipeline* pipeline);
+static bool emit_statement(Pipeline* pipeline, Statement* stmt);
+static void emit_error(Pipeline* pipeline, const char* prefix, const char* message);
+static bool execute_batches(Interpreter* interp, Pipeline* pipeline);
+static void free_token_batch(void* item);
+static void free_statement_batch(void* item);
+static void release_pipeline(Pipeline* pipeline);
+static PipelineStatus pipeline_file(Interpreter* interp, const char* filename);
+
+static void* reader_main(void* arg) {
+    Pipeline* pipeline = arg;
+    size_t filled = 0;
+    while (filled < pipeline->capacity && !__atomic_load_n(&pipeline->cancelled, __ATOMIC_ACQUIRE)) {
+        size_t wanted = pipeline->capacity - filled;
+        if (wanted > PIPELINE_READ_CHUNK) {
+            wanted = PIPELINE_READ_CHUNK;
+        }
+        ssize_t bytes = read(pipeline->fd, pipeline->source + filled, wanted);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes <= 0) {
+            break;
+        }
+        char* terminator = memchr(pipeline->source + filled, '\0', (size_t)bytes);
+        if (terminator) {
+            filled = (size_t)(terminator - pipeline->source);
+            break;
+        }
+        filled += (size_t)bytes;
+        __atomic_store_n(&pipeline->available, filled, __ATOMIC_RELEASE);
+    }
+    pipeline->source[filled] = '\0';
+    __atomic_store_n(&pipeline->available, filled, __ATOMIC_RELEASE);
+    __atomic_store_n(&pipeline->read_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static void* lexer_main(void* arg) {
+    Pipeline* pipeline = arg;
+    use_allocator(pipeline->allocator);
+    Lexer* lexer = init_lexer_with_length(pipeline->source, 0);
+    TokenBatch* batch = NULL;
+    bool running = lexer != NULL;
+    while (running) {
+        bool read_done = __atomic_load_n(&pipeline->read_done, __ATOMIC_ACQUIRE);
+        lexer->length = __atomic_load_n(&pipeline->available, __ATOMIC_ACQUIRE);
+        if (!read_done && lexer->position == lexer->length) {
+            sched_yield();
+            continue;
+        }
+        size_t position = lexer->position;
+        Token* token = next_token(lexer);
+        if (!token) {
+            break;
+        }
+        if (!read_done && lexer->position >= lexer->length) {
+            free_token(token);
+            lexer_seek(lexer, position);
+            if (batch && batch->count > 0) {
+                running = ring_push(pipeline->token_ring, batch);
+                batch = running ? NULL : batch;
+            }
+            sched_yield();
+            continue;
+        }
+        if (!batch) {
+            batch = malloc(sizeof(TokenBatch));
+            if (!batch) {
+                free_token(token);
+                break;
+            }
+            batch->count = 0;
+        }
+        batch->tokens[batch->count++] = token;
+        running = token->type != TOKEN_EOF;
+        if (batch->count == PIPELINE_BATCH_SIZE || !running) {
+            if (!ring_push(pipeline->token_ring, batch)) {
+                break;
+            }
+            batch = NULL;
+        }
+    }
+    free_token_batch(batch);
+    free_lexer(lexer);
+    ring_close(pipeline->token_ring);
+    __atomic_store_n(&pipeline->cancelled, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+static Token* pull_token_batch(void* context) {
+    Pipeline* pipeline = context;
+    if (pipeline->input && pipeline->input_index == pipeline->input->count) {
+        free(pipeline->input);
+        pipeline->input = NULL;
+    }
+    if (!pipeline->input) {
+        void* item;
+        if (!ring_try_pop(pipeline->token_ring, &item)) {
+            if (!flush_statements(pipeline)) {
+                return NULL;
+            }
+            item = ring_pop(pipeline->token_ring);
+        }
+        if (!item) {
+            return NULL;
+        }
+        pipeline->input = item;
+        pipeline->input_index = 0;
+    }
+    return pipeline->input->tokens[pipeline->input_index++];
+}
+
+static bool flush_statements(Pipeline* pipeline) {
+    if (pipeline->stopped) {
+        return false;
+    }
+    if (!pipeline->output || pipeline->output->count == 0) {
+        return true;
+    }
+    if (!ring_push(pipeline->statement_ring, pipeline->output)) {
+        pipeline->stopped = true;
+        return false;
+    }
+    pipeline->output = NULL;
+    return true;
+}
+
+static bool emit_statement(Pipeline* pipeline, Statement* stmt) {
+    if (!pipeline->output) {
+        pipeline->output = malloc(sizeof(StatementBatch));
+        if (!pipeline->output) {
+            free_statement(stmt);
+            return false;
+        }
+        pipeline->output->count = 0;
+        pipeline->output->error_prefix = NULL;
+    }
+    pipeline->output->statements[pipeline->output->count++] = stmt;
+    if (pipeline->output->count == PIPELINE_BATCH_SIZE) {
+        return flush_statements(pipeline);
+    }
+    return true;
+}
+
+static void emit_error(Pipeline* pipeline, const char* prefix, const char* message) {
+    if (!pipeline->output) {
+        pipeline->output = malloc(sizeof(StatementBatch));
+        if (!pipeline->output) {
+            return;
+        }
+        pipeline->output->count = 0;
+    }
+    pipeline->output->error_prefix = prefix;
+    snprintf(pipeline->output->error_message, sizeof(pipeline->output->error_message),
+             "%s", message);
+}
+
+static void* parser_main(void* arg) {
+    Pipeline* pipeline = arg;
+    use_allocator(pipeline->allocator);
+    Parser* parser = init_parser_source(pull_token_batch, pipeline, pipeline->source,
+                                        pipeline->symbols);
+    while (parser && !pipeline->stopped) {
+        if (!parser->current_token || parser->current_token->type == TOKEN_EOF) {
+            break;
+        }
+        if (parser->has_error) {
+            emit_error(pipeline, "Parser error", parser->error_message);
+            break;
+        }
+        Statement* stmt = parse_statement(parser);
+        if (!stmt) {
+            if (parser->has_error) {
+                emit_error(pipeline, "Parse error", parser->error_message);
+            }
+            break;
+        }
+        if (!emit_statement(pipeline, stmt)) {
+            break;
+        }
+    }
+    if (pipeline->output && !pipeline->stopped &&
+        ring_push(pipeline->statement_ring, pipeline->output)) {
+        pipeline->output = NULL;
+    }
+    ring_close(pipeline->statement_ring);
+    ring_close(pipeline->token_ring);
+    free_parser(parser);
+    return NULL;
+}
+
+static bool execute_batches(Interpreter* interp, Pipeline* pipeline) {
+    bool failed = false;
+    StatementBatch* batch;
+    while (!failed && (batch = ring_pop(pipeline->statement_ring)) != NULL) {
+        for (size_t i = 0; i < batch->count; i++) {
+            if (!failed && !execute_statement(interp, batch->statements[i])) {
+                fprintf(interp->output, "Runtime error: %s\n", interp->error_message);
+                failed = true;
+            }
+            free_statement(batch->statements[i]);
+        }
+        if (!failed && batch->error_prefix) {
+            fprintf(interp->output, "%s: %s\n", batch->error_prefix, batch->error_message);
+            failed = true;
+        }
+        free(batch);
+    }
+    ring_close(pipeline->statement_ring);
+    return !failed;
+}
+
+static void free_token_batch(void* item) {
+    TokenBatch* batch = item;
+    if (!batch) {
+        return;
+    }
+    for (size_t i = 0; i < batch->count; i++) {
+        free_token(batch->tokens[i]);
+    }
+    free(batch);
+}
+
+static void free_statement_batch(void* item) {
+    StatementBatch* batch = item;
+    if (!batch) {
+        return;
+    }
+    for (size_t i = 0; i < batch->count; i++) {
+        free_statement(batch->statements[i]);
+    }
+    free(batch);
+}
+
+static void release_pipeline(Pipeline* pipeline) {
+    if (pipeline->input) {
+        for (size_t i = pipeline->input_index; i < pipeline->input->count; i++) {
+            free_token(pipeline->input->tokens[i]);
+        }
+        free(pipeline->input);
+    }
+    free_statement_batch(pipeline->output);
+    free_ring(pipeline->token_ring, free_token_batch);
+    free_ring(pipeline->statement_ring, free_statement_batch);
+    free_env(pipeline->symbols);
+    free(pipeline->source);
+    close(pipeline->fd);
+}
+
+PipelineStatus run_pipelined(Interpreter* interp, const char* filename) {
+    if (!interp || !filename) {
+        return PIPELINE_START_FAILED;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    PipelineStatus status = pipeline_file(interp, filename);
+    use_allocator(previous);
+    return status;
+}
+
+static PipelineStatus pipeline_file(Interpreter* interp, const char* filename) {
+    Pipeline pipeline;
+    memset(&pipeline, 0, sizeof(pipeline));
+    pipeline.allocator = interp->allocator;
+    pipeline.fd = open(filename, O_RDONLY);
+    if (pipeline.fd < 0) {
+        fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
+        return PIPELINE_READ_FAILED;
+    }
+    struct stat info;
+    if (fstat(pipeline.fd, &info) != 0 || info.st_size == 0) {
+        close(pipeline.fd);
+        return info.st_size == 0 ? PIPELINE_EMPTY_SOURCE : PIPELINE_READ_FAILED;
+    }
+    posix_fadvise(pipeline.fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    pipeline.capacity = (size_t)info.st_size;
+    pipeline.source = malloc(pipeline.capacity + 1);
+    pipeline.token_ring = create_ring(PIPELINE_RING_CAPACITY);
+    pipeline.statement_ring = create_ring(PIPELINE_RING_CAPACITY);
+    pipeline.symbols = clone_env(interp->global_env);
+    Execution exec;
+    memset(&exec, 0, sizeof(exec));
+    if (interp->transactional) {
+        exec.undo_log = create_undo_log();
+    }
+    if (!pipeline.source || !pipeline.token_ring || !pipeline.statement_ring ||
+        !pipeline.symbols || (interp->transactional && !exec.undo_log)) {
+        free_undo_log(exec.undo_log);
+        release_pipeline(&pipeline);
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to initialize pipeline");
+        interp->has_error = true;
+        return PIPELINE_START_FAILED;
+    }
+
+    pthread_t reader;
+    pthread_t lexer;
+    pthread_t parser;
+    bool reader_started = pthread_create(&reader, NULL, reader_main, &pipeline) == 0;
+    bool lexer_started = reader_started &&
+                         pthread_create(&lexer, NULL, lexer_main, &pipeline) == 0;
+    bool parser_started = lexer_started &&
+                          pthread_create(&parser, NULL, parser_main, &pipeline) == 0;
+    if (!parser_started) {
+        __atomic_store_n(&pipeline.cancelled, 1, __ATOMIC_RELEASE);
+        ring_close(pipeline.token_ring);
+        if (lexer_started) {
+            pthread_join(lexer, NULL);
+        }
+        if (reader_started) {
+            pthread_join(reader, NULL);
+        }
+        free_undo_log(exec.undo_log);
+        release_pipeline(&pipeline);
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to start pipeline threads");
+        interp->has_error = true;
+        return PIPELINE_START_FAILED;
+    }
+
+    interp->global_env->undo_log = exec.undo_log;
+    interp->source = pipeline.source;
+    fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+    exec.failed = !execute_batches(interp, &pipeline);
+    pthread_join(parser, NULL);
+    pthread_join(lexer, NULL);
+    pthread_join(reader, NULL);
+    end_execution(interp, &exec);
+    fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+    release_pipeline(&pipeline);
+    return PIPELINE_COMPLETED;
+}
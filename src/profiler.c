@@ -0,0 +1,253 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Line Profiler Implementation
+ * ============================================================================
+ * 
+ * Implementation of the per-source-line profiler. The LineIndex is scanned
+ * to the end of the source when the profiler is created so the number of
+ * lines is known and every counter can live in one flat array; line_of()
+ * then answers most lookups from the cached line range of the previous
+ * one and only falls back to a binary search on a backward or long jump.
+ *
+ * The counting allocator forwards every call to the allocator it wraps, or
+ * to libc when that is NULL, so memory allocated before it was installed
+ * can be freed through it and the other way round.
+ * 
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "profiler.h"
+
+#define PROFILE_SOURCE_WIDTH 48
+
+typedef struct {
+    size_t line;
+    uint64_t total;
+} HotLine;
+
+static void* counted_alloc(void* context, size_t size);
+static void* counted_realloc(void* context, void* pointer, size_t size);
+static void counted_free(void* context, void* pointer);
+static size_t line_of(Profiler* profiler, size_t offset);
+static uint64_t line_total(const LineProfile* profile);
+static int compare_hot_lines(const void* a, const void* b);
+static void print_source_line(Profiler* profiler, size_t line, FILE* stream);
+
+Profiler* create_profiler(const char* source) {
+    if (!source) {
+        return NULL;
+    }
+    Profiler* profiler = malloc(sizeof(Profiler));
+    if (!profiler) {
+        return NULL;
+    }
+    profiler->source = source;
+    profiler->lines = create_line_index(source);
+    int line;
+    int column;
+    if (!profiler->lines || !line_index_position(profiler->lines, strlen(source), &line, &column)) {
+        free_line_index(profiler->lines);
+        free(profiler);
+        return NULL;
+    }
+    profiler->line_count = profiler->lines->line_count;
+    profiler->profiles = calloc(profiler->line_count, sizeof(LineProfile));
+    if (!profiler->profiles) {
+        free_line_index(profiler->lines);
+        free(profiler);
+        return NULL;
+    }
+    profiler->cursor = 0;
+    profiler->lex_total = 0;
+    profiler->lex_bytes = 0;
+    profiler->allocated = 0;
+    profiler->allocator.alloc = counted_alloc;
+    profiler->allocator.realloc = counted_realloc;
+    profiler->allocator.free = counted_free;
+    profiler->allocator.context = profiler;
+    profiler->inner = NULL;
+    return profiler;
+}
+
+static void* counted_alloc(void* context, size_t size) {
+    Profiler* profiler = context;
+    profiler->allocated += size;
+    const Allocator* inner = profiler->inner;
+    return inner ? inner->alloc(inner->context, size) : malloc(size);
+}
+
+static void* counted_realloc(void* context, void* pointer, size_t size) {
+    Profiler* profiler = context;
+    profiler->allocated += size;
+    const Allocator* inner = profiler->inner;
+    return inner ? inner->realloc(inner->context, pointer, size) : realloc(pointer, size);
+}
+
+static void counted_free(void* context, void* pointer) {
+    Profiler* profiler = context;
+    const Allocator* inner = profiler->inner;
+    if (!inner) {
+        free(pointer);
+    } else if (pointer) {
+        inner->free(inner->context, pointer);
+    }
+}
+
+/*
+ * Returns the allocator to install on the interpreter in place of `inner`
+ * for the profiled run; put `inner` back before freeing the profiler.
+ */
+const Allocator* profiler_allocator(Profiler* profiler, const Allocator* inner) {
+    if (!profiler) {
+        return inner;
+    }
+    profiler->inner = inner;
+    return &profiler->allocator;
+}
+
+static size_t line_of(Profiler* profiler, size_t offset) {
+    const size_t* starts = profiler->lines->line_starts;
+    size_t cursor = profiler->cursor;
+    while (cursor + 1 < profiler->line_count && starts[cursor + 1] <= offset &&
+           cursor < profiler->cursor + 4) {
+        cursor++;
+    }
+    if (starts[cursor] > offset ||
+        (cursor + 1 < profiler->line_count && starts[cursor + 1] <= offset)) {
+        int line;
+        int column;
+        line_index_position(profiler->lines, offset, &line, &column);
+        cursor = (size_t)line - 1;
+    }
+    profiler->cursor = cursor;
+    return cursor;
+}
+
+void profile_lex(Profiler* profiler, Token* token, uint64_t elapsed, uint64_t bytes) {
+    if (!profiler || !token) {
+        return;
+    }
+    LineProfile* profile = &profiler->profiles[line_of(profiler, token->offset)];
+    profile->lex += elapsed;
+    profile->bytes += bytes;
+    profiler->lex_total += elapsed;
+    profiler->lex_bytes += bytes;
+}
+
+void profile_parse(Profiler* profiler, Statement* stmt, uint64_t elapsed, uint64_t bytes) {
+    if (!profiler || !stmt) {
+        return;
+    }
+    LineProfile* profile = &profiler->profiles[line_of(profiler, stmt->offset)];
+    profile->parse += elapsed;
+    profile->bytes += bytes;
+}
+
+void profile_execute(Profiler* profiler, Statement* stmt, uint64_t elapsed, uint64_t bytes) {
+    if (!profiler || !stmt) {
+        return;
+    }
+    LineProfile* profile = &profiler->profiles[line_of(profiler, stmt->offset)];
+    profile->exec += elapsed;
+    profile->statements++;
+    profile->bytes += bytes;
+}
+
+static uint64_t line_total(const LineProfile* profile) {
+    return profile->lex + profile->parse + profile->exec;
+}
+
+static int compare_hot_lines(const void* a, const void* b) {
+    const HotLine* left = a;
+    const HotLine* right = b;
+    if (left->total != right->total) {
+        return left->total < right->total ? 1 : -1;
+    }
+    return left->line < right->line ? -1 : (left->line > right->line);
+}
+
+static void print_source_line(Profiler* profiler, size_t line, FILE* stream) {
+    const char* start = profiler->source + profiler->lines->line_starts[line];
+    size_t length = 0;
+    while (start[length] && start[length] != '\n' && length < PROFILE_SOURCE_WIDTH) {
+        length++;
+    }
+    fprintf(stream, "%.*s%s\n", (int)length, start,
+            start[length] && start[length] != '\n' ? "..." : "");
+}
+
+void print_line_profile(Profiler* profiler, FILE* stream) {
+    if (!profiler || !stream) {
+        return;
+    }
+    LineProfile sum = {0, 0, 0, 0, 0};
+    size_t active = 0;
+    for (size_t i = 0; i < profiler->line_count; i++) {
+        const LineProfile* profile = &profiler->profiles[i];
+        sum.lex += profile->lex;
+        sum.parse += profile->parse;
+        sum.exec += profile->exec;
+        sum.bytes += profile->bytes;
+        sum.statements += profile->statements;
+        active += line_total(profile) > 0;
+    }
+    uint64_t total = line_total(&sum);
+    double scale = total > 0 ? 100.0 / (double)total : 0.0;
+    fprintf(stream, "\n=== LINE PROFILE (%s) ===\n", PROFILE_CLOCK_UNIT);
+    fprintf(stream, "Lex %llu, parse %llu, execute %llu %s; %llu bytes allocated; "
+            "%u statements on %zu lines\n",
+            (unsigned long long)sum.lex, (unsigned long long)sum.parse,
+            (unsigned long long)sum.exec, PROFILE_CLOCK_UNIT,
+            (unsigned long long)sum.bytes, sum.statements, active);
+
+    HotLine* hot = malloc(profiler->line_count * sizeof(HotLine));
+    if (hot) {
+        for (size_t i = 0; i < profiler->line_count; i++) {
+            hot[i].line = i;
+            hot[i].total = line_total(&profiler->profiles[i]);
+        }
+        qsort(hot, profiler->line_count, sizeof(HotLine), compare_hot_lines);
+        fprintf(stream, "\nHot lines:\n");
+        fprintf(stream, "%8s %7s %12s %12s %12s %12s %6s  %s\n",
+                "line", "share", "lex", "parse", "execute", "bytes", "stmts", "source");
+        for (size_t i = 0; i < profiler->line_count && i < PROFILE_HOT_LINES && hot[i].total > 0; i++) {
+            const LineProfile* profile = &profiler->profiles[hot[i].line];
+            fprintf(stream, "%8zu %6.1f%% %12llu %12llu %12llu %12llu %6u  ",
+                    hot[i].line + 1, (double)hot[i].total * scale,
+                    (unsigned long long)profile->lex, (unsigned long long)profile->parse,
+                    (unsigned long long)profile->exec, (unsigned long long)profile->bytes,
+                    profile->statements);
+            print_source_line(profiler, hot[i].line, stream);
+        }
+        free(hot);
+    }
+
+    bool complete = profiler->line_count <= PROFILE_LISTING_MAX_LINES;
+    fprintf(stream, "\nAnnotated listing%s:\n",
+            complete ? "" : " (lines with at least 1% of the total)");
+    for (size_t i = 0; i < profiler->line_count; i++) {
+        const LineProfile* profile = &profiler->profiles[i];
+        double share = (double)line_total(profile) * scale;
+        if (!complete && share < 1.0) {
+            continue;
+        }
+        if (line_total(profile) > 0) {
+            fprintf(stream, "%6.1f%% %12llu B %6zu | ", share,
+                    (unsigned long long)profile->bytes, i + 1);
+        } else {
+            fprintf(stream, "%7s %12s   %6zu | ", "", "", i + 1);
+        }
+        print_source_line(profiler, i, stream);
+    }
+}
+
+void free_profiler(Profiler* profiler) {
+    if (!profiler) {
+        return;
+    }
+    free_line_index(profiler->lines);
+    free(profiler->profiles);
+    free(profiler);
+}
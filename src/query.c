@@ -0,0 +1,715 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Query Implementation
+ * ============================================================================
+ *
+ * Implementation of the statement index and the backward scan.
+ *
+ * The index is an array of statement start offsets. While building it,
+ * the forward pass keeps every declared name in a chained hash table whose
+ * entries form a stack of scopes: a declaration pushes an entry at the head
+ * of its bucket, so a lookup finds the innermost declaration first, and a
+ * closing brace pops the entries of its depth. Any statement the parser or
+ * the interpreter would stop at (an undefined name, a redeclaration in the
+ * same scope, a literal of another type) fails the index.
+ *
+ * The backward scan
+ * feeds every write to a queried name, last first, to note_write(): the
+ * first one seen fixes the value and type, later ones (earlier in the
+ * source) must match that type, and the declaration must be the earliest
+ * of them. A write seen after the declaration is either an assignment
+ * before it (an undefined variable) or a second declaration, both errors.
+ *
+ * Inside a block, each queried name keeps the type it was declared with
+ * at every open depth, or -1: an assignment resolves to the innermost
+ * declaration and is type checked against it, or is a global write when
+ * there is none. The block's global writes are collected in source order
+ * and noted in reverse. A `repeat` body is scanned as a block.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "query.h"
+#include "allocator.h"
+
+#define QUERY_INITIAL_STATEMENTS 1024
+#define QUERY_INITIAL_BUCKETS 256
+
+typedef struct {
+    char* name;
+    size_t length;
+    size_t value_offset;
+    ValueType type;
+    bool typed;
+    bool written;
+    bool declared;
+    signed char locals[MAX_BLOCK_DEPTH + 1];
+} QueryName;
+
+typedef struct {
+    size_t name;
+    ValueType type;
+    size_t offset;
+    bool runs;
+} BlockWrite;
+
+typedef struct {
+    const char* text;
+    size_t length;
+    ValueType type;
+    int depth;
+    size_t next;
+} QuerySymbol;
+
+struct Query {
+    QueryName* names;
+    size_t count;
+    size_t* starts;
+    size_t statements;
+    size_t capacity;
+    BlockWrite* writes;
+    size_t write_count;
+    size_t write_capacity;
+    QuerySymbol* symbols;
+    size_t symbol_count;
+    size_t symbol_capacity;
+    size_t* buckets;
+    size_t bucket_mask;
+};
+
+typedef enum {
+    SHAPE_START,
+    SHAPE_TYPE,
+    SHAPE_NAME,
+    SHAPE_ASSIGN,
+    SHAPE_VALUE,
+    SHAPE_COUNT,
+    SHAPE_BODY
+} ShapeState;
+
+static bool is_name_start(char c);
+static bool is_name_char(char c);
+static bool add_name(Query* query, const char* name, size_t length);
+static bool literal_type(TokenType token, ValueType* type);
+static bool push_start(Query* query, size_t offset);
+static size_t hash_name(const char* text, size_t length);
+static bool rehash_symbols(Query* query, size_t bucket_count);
+static QuerySymbol* lookup_symbol(Query* query, const Lexeme* name);
+static bool check_write(Query* query, const Lexeme* name, bool declaration, ValueType type, int depth);
+static void close_scope(Query* query, int depth);
+static bool index_statements(Query* query, Lexer* lexer);
+static QueryName* find_name(Query* query, const Lexeme* lexeme);
+static bool note_write(QueryName* name, ValueType type, size_t offset, bool runs, bool declaration);
+static bool scan_write(Query* query, Lexer* lexer, bool declaration);
+static bool block_mentions(Query* query, const char* text, size_t length);
+static bool push_block_write(Query* query, size_t name, ValueType type, size_t offset, bool runs);
+static bool scan_block(Query* query, Lexer* lexer, bool runs);
+static bool scan_backwards(Query* query, Lexer* lexer);
+static bool store_answers(Query* query, Lexer* lexer, Environment* env);
+static bool execute_quietly(Interpreter* interp, char* source);
+static QueryMethod answer_query(Interpreter* interp, Query* query, char* source);
+
+static bool is_name_start(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+static bool is_name_char(char c) {
+    return is_name_start(c) || (c >= '0' && c <= '9');
+}
+
+static bool add_name(Query* query, const char* name, size_t length) {
+    for (size_t i = 0; i < query->count; i++) {
+        if (query->names[i].length == length && memcmp(query->names[i].name, name, length) == 0) {
+            return true;
+        }
+    }
+    QueryName* names = realloc(query->names, (query->count + 1) * sizeof(QueryName));
+    if (!names) {
+        return false;
+    }
+    query->names = names;
+    QueryName* entry = &names[query->count];
+    entry->name = strndup(name, length);
+    if (!entry->name) {
+        return false;
+    }
+    entry->length = length;
+    query->count++;
+    return true;
+}
+
+/*
+ * Splits a comma-separated list of identifiers; a repeated name is kept
+ * once. Returns NULL for an empty list or entry, or a malformed name.
+ */
+Query* create_query(const char* names) {
+    if (!names) {
+        return NULL;
+    }
+    Query* query = calloc(1, sizeof(Query));
+    if (!query) {
+        return NULL;
+    }
+    const char* cursor = names;
+    for (;;) {
+        size_t length = 0;
+        if (!is_name_start(cursor[0])) {
+            free_query(query);
+            return NULL;
+        }
+        while (is_name_char(cursor[length])) {
+            length++;
+        }
+        if ((cursor[length] != ',' && cursor[length] != '\0') || !add_name(query, cursor, length)) {
+            free_query(query);
+            return NULL;
+        }
+        if (cursor[length] == '\0') {
+            return query;
+        }
+        cursor += length + 1;
+    }
+}
+
+size_t query_count(const Query* query) {
+    return query ? query->count : 0;
+}
+
+char* query_name(const Query* query, size_t index) {
+    return query && index < query->count ? query->names[index].name : NULL;
+}
+
+static bool literal_type(TokenType token, ValueType* type) {
+    switch (token) {
+        case TOKEN_NUMBER:
+            *type = TYPE_INT;
+            return true;
+        case TOKEN_CHAR_LITERAL:
+            *type = TYPE_CHAR;
+            return true;
+        case TOKEN_STRING_LITERAL:
+            *type = TYPE_STRING;
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool push_start(Query* query, size_t offset) {
+    if (query->statements == query->capacity) {
+        size_t capacity = query->capacity ? query->capacity * 2 : QUERY_INITIAL_STATEMENTS;
+        size_t* starts = realloc(query->starts, capacity * sizeof(size_t));
+        if (!starts) {
+            return false;
+        }
+        query->starts = starts;
+        query->capacity = capacity;
+    }
+    query->starts[query->statements++] = offset;
+    return true;
+}
+
+static size_t hash_name(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*
+ * Rebuilds the bucket chains in declaration order, so each chain still
+ * lists the innermost declaration of a name before the ones it shadows.
+ * Bucket heads and `next` links hold an entry index plus one, 0 ending
+ * the chain.
+ */
+static bool rehash_symbols(Query* query, size_t bucket_count) {
+    size_t* buckets = calloc(bucket_count, sizeof(size_t));
+    if (!buckets) {
+        return false;
+    }
+    free(query->buckets);
+    query->buckets = buckets;
+    query->bucket_mask = bucket_count - 1;
+    for (size_t i = 0; i < query->symbol_count; i++) {
+        QuerySymbol* symbol = &query->symbols[i];
+        size_t bucket = hash_name(symbol->text, symbol->length) & query->bucket_mask;
+        symbol->next = buckets[bucket];
+        buckets[bucket] = i + 1;
+    }
+    return true;
+}
+
+static QuerySymbol* lookup_symbol(Query* query, const Lexeme* name) {
+    size_t entry = query->buckets[hash_name(name->text, name->length) & query->bucket_mask];
+    while (entry != 0) {
+        QuerySymbol* symbol = &query->symbols[entry - 1];
+        if (symbol->length == name->length && memcmp(symbol->text, name->text, name->length) == 0) {
+            return symbol;
+        }
+        entry = symbol->next;
+    }
+    return NULL;
+}
+
+/*
+ * Checks one write against the names in scope, as the parser and the
+ * interpreter would: an assignment needs a declaration of its literal's
+ * type, a declaration must not repeat one of its own scope.
+ */
+static bool check_write(Query* query, const Lexeme* name, bool declaration, ValueType type, int depth) {
+    QuerySymbol* symbol = lookup_symbol(query, name);
+    if (!declaration) {
+        return symbol && symbol->type == type;
+    }
+    if (symbol && symbol->depth == depth) {
+        return false;
+    }
+    if (query->symbol_count == query->symbol_capacity) {
+        size_t capacity = query->symbol_capacity ? query->symbol_capacity * 2 : QUERY_INITIAL_BUCKETS;
+        QuerySymbol* symbols = realloc(query->symbols, capacity * sizeof(QuerySymbol));
+        if (!symbols) {
+            return false;
+        }
+        query->symbols = symbols;
+        query->symbol_capacity = capacity;
+    }
+    if (query->symbol_count > query->bucket_mask &&
+        !rehash_symbols(query, (query->bucket_mask + 1) * 2)) {
+        return false;
+    }
+    size_t bucket = hash_name(name->text, name->length) & query->bucket_mask;
+    query->symbols[query->symbol_count] = (QuerySymbol){name->text, name->length, type, depth,
+                                                        query->buckets[bucket]};
+    query->buckets[bucket] = ++query->symbol_count;
+    return true;
+}
+
+/*
+ * Forgets the declarations of a block being closed. They are the newest
+ * entries, each at the head of its bucket.
+ */
+static void close_scope(Query* query, int depth) {
+    while (query->symbol_count > 0 && query->symbols[query->symbol_count - 1].depth == depth) {
+        QuerySymbol* symbol = &query->symbols[--query->symbol_count];
+        query->buckets[hash_name(symbol->text, symbol->length) & query->bucket_mask] = symbol->next;
+    }
+}
+
+/*
+ * The forward pass: records the offset of every top-level statement and
+ * fails on anything the parser would reject by its shape alone, or that
+ * would stop the run: a name assigned before it is declared or with a
+ * literal of another type, or declared twice in one scope.
+ */
+static bool index_statements(Query* query, Lexer* lexer) {
+    Lexeme lexeme;
+    Lexeme name = {0};
+    ShapeState state = SHAPE_START;
+    ValueType expected = TYPE_INT;
+    bool typed = false;
+    int depth = GLOBAL_DEPTH;
+    query->statements = 0;
+    query->symbol_count = 0;
+    if (!rehash_symbols(query, QUERY_INITIAL_BUCKETS)) {
+        return false;
+    }
+    for (;;) {
+        scan_lexeme(lexer, &lexeme);
+        if (lexeme.type == TOKEN_EOF) {
+            return state == SHAPE_START && depth == GLOBAL_DEPTH;
+        }
+        ValueType type;
+        switch (state) {
+            case SHAPE_START:
+                if (depth == GLOBAL_DEPTH && !push_start(query, lexeme.offset)) {
+                    return false;
+                }
+                switch (lexeme.type) {
+                    case TOKEN_KEYWORD_INT:
+                    case TOKEN_KEYWORD_CHAR:
+                    case TOKEN_KEYWORD_STRING:
+                        expected = lexeme.type == TOKEN_KEYWORD_INT ? TYPE_INT
+                                 : lexeme.type == TOKEN_KEYWORD_CHAR ? TYPE_CHAR : TYPE_STRING;
+                        typed = true;
+                        state = SHAPE_TYPE;
+                        break;
+                    case TOKEN_IDENTIFIER:
+                        name = lexeme;
+                        typed = false;
+                        state = SHAPE_NAME;
+                        break;
+                    case TOKEN_KEYWORD_REPEAT:
+                        state = SHAPE_COUNT;
+                        break;
+                    case TOKEN_LBRACE:
+                        if (depth >= MAX_BLOCK_DEPTH) {
+                            return false;
+                        }
+                        depth++;
+                        break;
+                    case TOKEN_RBRACE:
+                        if (depth == GLOBAL_DEPTH) {
+                            return false;
+                        }
+                        close_scope(query, depth);
+                        depth--;
+                        break;
+                    default:
+                        return false;
+                }
+                break;
+            case SHAPE_TYPE:
+                if (lexeme.type != TOKEN_IDENTIFIER) {
+                    return false;
+                }
+                name = lexeme;
+                state = SHAPE_NAME;
+                break;
+            case SHAPE_NAME:
+                if (lexeme.type != TOKEN_ASSIGN) {
+                    return false;
+                }
+                state = SHAPE_ASSIGN;
+                break;
+            case SHAPE_ASSIGN:
+                if (!literal_type(lexeme.type, &type) || (typed && type != expected) ||
+                    !check_write(query, &name, typed, type, depth)) {
+                    return false;
+                }
+                state = SHAPE_VALUE;
+                break;
+            case SHAPE_VALUE:
+                if (lexeme.type != TOKEN_SEMICOLON) {
+                    return false;
+                }
+                state = SHAPE_START;
+                break;
+            case SHAPE_COUNT:
+                if (lexeme.type != TOKEN_NUMBER) {
+                    return false;
+                }
+                state = SHAPE_BODY;
+                break;
+            case SHAPE_BODY:
+                if (lexeme.type != TOKEN_LBRACE || depth >= MAX_BLOCK_DEPTH) {
+                    return false;
+                }
+                depth++;
+                state = SHAPE_START;
+                break;
+        }
+    }
+}
+
+static QueryName* find_name(Query* query, const Lexeme* lexeme) {
+    for (size_t i = 0; i < query->count; i++) {
+        QueryName* name = &query->names[i];
+        if (name->length == lexeme->length && memcmp(name->name, lexeme->text, lexeme->length) == 0) {
+            return name;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * A write that never runs (in a loop repeated zero times) is still parsed,
+ * so it is type checked and needs the declaration, but supplies no value.
+ */
+static bool note_write(QueryName* name, ValueType type, size_t offset, bool runs, bool declaration) {
+    if (name->declared) {
+        return false;
+    }
+    if (!name->typed) {
+        name->typed = true;
+        name->type = type;
+    } else if (type != name->type) {
+        return false;
+    }
+    if (runs && !name->written) {
+        name->written = true;
+        name->value_offset = offset;
+    }
+    name->declared = declaration;
+    return true;
+}
+
+/*
+ * With the lexer past the name of a top-level declaration or assignment,
+ * reads its literal and notes the write when the name is queried.
+ */
+static bool scan_write(Query* query, Lexer* lexer, bool declaration) {
+    Lexeme lexeme;
+    scan_lexeme(lexer, &lexeme);
+    QueryName* name = find_name(query, &lexeme);
+    if (!name) {
+        return true;
+    }
+    ValueType type;
+    scan_lexeme(lexer, &lexeme);
+    scan_lexeme(lexer, &lexeme);
+    return literal_type(lexeme.type, &type) && note_write(name, type, lexeme.offset, true, declaration);
+}
+
+static bool block_mentions(Query* query, const char* text, size_t length) {
+    for (size_t i = 0; i < query->count; i++) {
+        if (memmem(text, length, query->names[i].name, query->names[i].length)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool push_block_write(Query* query, size_t name, ValueType type, size_t offset, bool runs) {
+    if (query->write_count == query->write_capacity) {
+        size_t capacity = query->write_capacity ? query->write_capacity * 2 : 8;
+        BlockWrite* writes = realloc(query->writes, capacity * sizeof(BlockWrite));
+        if (!writes) {
+            return false;
+        }
+        query->writes = writes;
+        query->write_capacity = capacity;
+    }
+    query->writes[query->write_count++] = (BlockWrite){name, type, offset, runs};
+    return true;
+}
+
+/*
+ * Lexes a block from its opening brace (already consumed) to the matching
+ * closing one and notes its writes to queried globals, last first. Every
+ * iteration of a loop writes the same values, so a loop body counts as a
+ * block, and not at all (beyond its checks) when it runs zero times.
+ */
+static bool scan_block(Query* query, Lexer* lexer, bool runs) {
+    Lexeme lexeme;
+    int depth = GLOBAL_DEPTH + 1;
+    int skipped = runs ? GLOBAL_DEPTH : depth;
+    query->write_count = 0;
+    for (size_t i = 0; i < query->count; i++) {
+        query->names[i].locals[depth] = -1;
+    }
+    while (depth > GLOBAL_DEPTH) {
+        scan_lexeme(lexer, &lexeme);
+        if (lexeme.type == TOKEN_RBRACE) {
+            if (skipped == depth) {
+                skipped = GLOBAL_DEPTH;
+            }
+            depth--;
+            continue;
+        }
+        if (lexeme.type == TOKEN_KEYWORD_REPEAT) {
+            scan_lexeme(lexer, &lexeme);
+            if (lexeme.int_val <= 0 && skipped == GLOBAL_DEPTH) {
+                skipped = depth + 1;
+            }
+            scan_lexeme(lexer, &lexeme);
+        }
+        if (lexeme.type == TOKEN_LBRACE) {
+            depth++;
+            for (size_t i = 0; i < query->count; i++) {
+                query->names[i].locals[depth] = -1;
+            }
+            continue;
+        }
+        bool declaration = lexeme.type != TOKEN_IDENTIFIER;
+        if (declaration) {
+            scan_lexeme(lexer, &lexeme);
+        }
+        QueryName* name = find_name(query, &lexeme);
+        scan_lexeme(lexer, &lexeme);
+        scan_lexeme(lexer, &lexeme);
+        ValueType type = TYPE_INT;
+        literal_type(lexeme.type, &type);
+        if (name && declaration) {
+            if (name->locals[depth] >= 0) {
+                return false;
+            }
+            name->locals[depth] = (signed char)type;
+        } else if (name) {
+            int scope = depth;
+            while (scope > GLOBAL_DEPTH && name->locals[scope] < 0) {
+                scope--;
+            }
+            if (scope > GLOBAL_DEPTH && name->locals[scope] != (signed char)type) {
+                return false;
+            }
+            if (scope == GLOBAL_DEPTH &&
+                !push_block_write(query, (size_t)(name - query->names), type, lexeme.offset,
+                                  skipped == GLOBAL_DEPTH)) {
+                return false;
+            }
+        }
+        scan_lexeme(lexer, &lexeme);
+    }
+    for (size_t i = query->write_count; i-- > 0;) {
+        BlockWrite* write = &query->writes[i];
+        if (!note_write(&query->names[write->name], write->type, write->offset, write->runs, false)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool scan_backwards(Query* query, Lexer* lexer) {
+    for (size_t i = 0; i < query->count; i++) {
+        query->names[i].typed = false;
+        query->names[i].written = false;
+        query->names[i].declared = false;
+    }
+    Lexeme lexeme;
+    for (size_t i = query->statements; i-- > 0;) {
+        lexer_seek(lexer, query->starts[i]);
+        scan_lexeme(lexer, &lexeme);
+        bool ok = true;
+        if (lexeme.type == TOKEN_LBRACE || lexeme.type == TOKEN_KEYWORD_REPEAT) {
+            size_t end = i + 1 < query->statements ? query->starts[i + 1] : lexer->length;
+            bool runs = true;
+            if (block_mentions(query, lexer->source + lexeme.offset, end - lexeme.offset)) {
+                if (lexeme.type == TOKEN_KEYWORD_REPEAT) {
+                    scan_lexeme(lexer, &lexeme);
+                    runs = lexeme.int_val > 0;
+                    scan_lexeme(lexer, &lexeme);
+                }
+                ok = scan_block(query, lexer, runs);
+            }
+        } else if (lexeme.type == TOKEN_IDENTIFIER) {
+            lexer_seek(lexer, lexeme.offset);
+            ok = scan_write(query, lexer, false);
+        } else {
+            ok = scan_write(query, lexer, true);
+        }
+        if (!ok) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < query->count; i++) {
+        if (query->names[i].typed && !query->names[i].declared) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Lexes the literal of each answer again, as a heap Token so the value is
+ * built exactly as the parser would build it, and declares it.
+ */
+static bool store_answers(Query* query, Lexer* lexer, Environment* env) {
+    for (size_t i = 0; i < query->count; i++) {
+        QueryName* name = &query->names[i];
+        if (!name->written) {
+            continue;
+        }
+        lexer_seek(lexer, name->value_offset);
+        Token* token = next_token(lexer);
+        Value* value = token ? init_value(name->type) : NULL;
+        bool stored = value != NULL;
+        if (stored) {
+            switch (name->type) {
+                case TYPE_INT:
+                    value->data.int_val = token->value.int_val;
+                    break;
+                case TYPE_CHAR:
+                    value->data.char_val = token->value.char_val;
+                    break;
+                case TYPE_STRING:
+                    value->data.string_val = mem_strdup(token->value.string_val);
+                    stored = value->data.string_val != NULL;
+                    break;
+                case TYPE_INT_ARRAY:
+                    stored = false;
+                    break;
+            }
+        }
+        stored = stored && declare_variable(env, name->name, value);
+        free_value(value);
+        free_token(token);
+        if (!stored) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * Runs the whole script as run() would, minus its output; a parse error,
+ * which run() only prints, is recorded as the interpreter's error.
+ */
+static bool execute_quietly(Interpreter* interp, char* source) {
+    FILE* sink = fopen("/dev/null", "w");
+    if (!sink) {
+        snprintf(interp->error_message, sizeof(interp->error_message), "Cannot open /dev/null");
+        interp->has_error = true;
+        return false;
+    }
+    FILE* output = interp->output;
+    interp->output = sink;
+    Execution exec;
+    if (begin_execution(interp, &exec, source, 0)) {
+        while (execute_next(interp, &exec)) {
+        }
+        if (exec.failed && !interp->has_error) {
+            snprintf(interp->error_message, sizeof(interp->error_message), "%s",
+                     exec.parser->has_error ? exec.parser->error_message : "Failed to parse statement");
+            interp->has_error = true;
+        }
+        end_execution(interp, &exec);
+    }
+    interp->output = output;
+    fclose(sink);
+    return !interp->has_error;
+}
+
+QueryMethod run_query(Interpreter* interp, Query* query, char* source) {
+    if (!interp || !query || !source) {
+        return QUERY_FAILED;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    QueryMethod method = answer_query(interp, query, source);
+    use_allocator(previous);
+    return method;
+}
+
+static QueryMethod answer_query(Interpreter* interp, Query* query, char* source) {
+    Lexer* lexer = init_lexer(source);
+    if (!lexer) {
+        snprintf(interp->error_message, sizeof(interp->error_message), "Failed to initialize lexer");
+        interp->has_error = true;
+        return QUERY_FAILED;
+    }
+    Environment* env = interp->global_env;
+    bool indexed = env->count == 0 && !env->base && index_statements(query, lexer) &&
+                   scan_backwards(query, lexer);
+    if (indexed && !store_answers(query, lexer, env)) {
+        snprintf(interp->error_message, sizeof(interp->error_message), "Failed to store query answers");
+        interp->has_error = true;
+        free_lexer(lexer);
+        return QUERY_FAILED;
+    }
+    free_lexer(lexer);
+    if (indexed) {
+        return QUERY_INDEXED;
+    }
+    return execute_quietly(interp, source) ? QUERY_EXECUTED : QUERY_FAILED;
+}
+
+void free_query(Query* query) {
+    if (!query) {
+        return;
+    }
+    for (size_t i = 0; i < query->count; i++) {
+        free(query->names[i].name);
+    }
+    free(query->names);
+    free(query->starts);
+    free(query->writes);
+    free(query->symbols);
+    free(query->buckets);
+    free(query);
+}
@@ -0,0 +1,106 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Single-Producer/Single-Consumer Ring
+ * ============================================================================
+ * 
+ * Implementation of the bounded SPSC ring. head and tail grow without
+ * wrapping and are reduced with the mask on access, so `tail - head` is
+ * always the number of queued items. Each index lives on its own cache
+ * line to keep the producer and the consumer from invalidating each other.
+ * 
+ * Waiting threads call sched_yield() between attempts: a pipeline stage
+ * always has another stage that can make progress, including on a
+ * single core.
+ * 
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <sched.h>
+#include "ring.h"
+
+SpscRing* create_ring(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    SpscRing* ring = malloc(sizeof(SpscRing));
+    if (!ring) {
+        return NULL;
+    }
+    ring->slots = malloc(size * sizeof(void*));
+    if (!ring->slots) {
+        free(ring);
+        return NULL;
+    }
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->closed = 0;
+    return ring;
+}
+
+bool ring_try_push(SpscRing* ring, void* item) {
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head > ring->mask) {
+        return false;
+    }
+    ring->slots[tail & ring->mask] = item;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool ring_try_pop(SpscRing* ring, void** item) {
+    size_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    size_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head == tail) {
+        return false;
+    }
+    *item = ring->slots[head & ring->mask];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool ring_push(SpscRing* ring, void* item) {
+    while (!ring_is_closed(ring)) {
+        if (ring_try_push(ring, item)) {
+            return true;
+        }
+        sched_yield();
+    }
+    return false;
+}
+
+void* ring_pop(SpscRing* ring) {
+    void* item;
+    while (!ring_try_pop(ring, &item)) {
+        if (ring_is_closed(ring)) {
+            return ring_try_pop(ring, &item) ? item : NULL;
+        }
+        sched_yield();
+    }
+    return item;
+}
+
+void ring_close(SpscRing* ring) {
+    __atomic_store_n(&ring->closed, 1, __ATOMIC_RELEASE);
+}
+
+bool ring_is_closed(SpscRing* ring) {
+    return __atomic_load_n(&ring->closed, __ATOMIC_ACQUIRE) != 0;
+}
+
+void free_ring(SpscRing* ring, void (*free_item)(void* item)) {
+    if (!ring) {
+        return;
+    }
+    void* item;
+    while (ring_try_pop(ring, &item)) {
+        if (free_item) {
+            free_item(item);
+        }
+    }
+    free(ring->slots);
+    free(ring);
+}
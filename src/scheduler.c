@@ -0,0 +1,94 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Round-Robin Scheduler
+ * ============================================================================
+ *
+ * Implementation of the round-robin scheduler. The queue is an array of
+ * interpreters with a cursor on the next one to run; a finished run is
+ * removed by shifting the rest down, which keeps the order of the others.
+ *
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "scheduler.h"
+
+#define SCHEDULER_INITIAL_CAPACITY 8
+
+struct Scheduler {
+    StepBudget slice;
+    Interpreter** runs;
+    size_t count;
+    size_t capacity;
+    size_t cursor;
+};
+
+Scheduler* create_scheduler(StepBudget slice) {
+    Scheduler* scheduler = malloc(sizeof(Scheduler));
+    if (!scheduler) {
+        return NULL;
+    }
+    scheduler->slice = slice;
+    scheduler->runs = NULL;
+    scheduler->count = 0;
+    scheduler->capacity = 0;
+    scheduler->cursor = 0;
+    return scheduler;
+}
+
+bool scheduler_add(Scheduler* scheduler, Interpreter* interp, char* source) {
+    if (!scheduler || !interp || !source) {
+        return false;
+    }
+    if (scheduler->count == scheduler->capacity) {
+        size_t capacity = scheduler->capacity ? scheduler->capacity * 2 : SCHEDULER_INITIAL_CAPACITY;
+        Interpreter** runs = realloc(scheduler->runs, capacity * sizeof(Interpreter*));
+        if (!runs) {
+            return false;
+        }
+        scheduler->runs = runs;
+        scheduler->capacity = capacity;
+    }
+    if (!start_run(interp, source)) {
+        return false;
+    }
+    scheduler->runs[scheduler->count++] = interp;
+    return true;
+}
+
+size_t scheduler_pending(const Scheduler* scheduler) {
+    return scheduler ? scheduler->count : 0;
+}
+
+Interpreter* scheduler_tick(Scheduler* scheduler) {
+    if (!scheduler || scheduler->count == 0) {
+        return NULL;
+    }
+    if (scheduler->cursor >= scheduler->count) {
+        scheduler->cursor = 0;
+    }
+    size_t index = scheduler->cursor;
+    Interpreter* interp = scheduler->runs[index];
+    if (run_step(interp, scheduler->slice)) {
+        scheduler->cursor = index + 1;
+    } else {
+        memmove(scheduler->runs + index, scheduler->runs + index + 1,
+                (scheduler->count - index - 1) * sizeof(Interpreter*));
+        scheduler->count--;
+    }
+    return interp;
+}
+
+void scheduler_run(Scheduler* scheduler) {
+    while (scheduler_tick(scheduler)) {
+    }
+}
+
+void free_scheduler(Scheduler* scheduler) {
+    if (!scheduler) {
+        return;
+    }
+    free(scheduler->runs);
+    free(scheduler);
+}
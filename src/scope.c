@@ -0,0 +1,224 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Block Scope Implementation
+ * ============================================================================
+ * 
+ * Implementation of the parse-time scope table and the runtime value stack
+ * used for block scoping.
+ * 
+ * The scope table is a single array of entries ordered by declaration, so
+ * leaving a block pops its entries off the end and resolution scans from
+ * the innermost declaration outwards. The value stack stores Values inline;
+ * a frame is zero-initialized on entry and only its string slots need to be
+ * released on exit.
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "scope.h"
+#include "int_array.h"
+#include "allocator.h"
+
+ScopeTable* create_scope_table(void) {
+    ScopeTable* table = mem_alloc(sizeof(ScopeTable));
+    if (!table) {
+        return NULL;
+    }
+    table->entries = NULL;
+    table->count = 0;
+    table->capacity = 0;
+    table->depth = GLOBAL_DEPTH;
+    table->frame_sizes[GLOBAL_DEPTH] = 0;
+    return table;
+}
+
+bool scope_enter(ScopeTable* table) {
+    if (!table || table->depth >= MAX_BLOCK_DEPTH) {
+        return false;
+    }
+    table->depth++;
+    table->frame_sizes[table->depth] = 0;
+    return true;
+}
+
+int scope_leave(ScopeTable* table) {
+    if (!table || table->depth == GLOBAL_DEPTH) {
+        return 0;
+    }
+    while (table->count > 0 && table->entries[table->count - 1].depth == table->depth) {
+        mem_free(table->entries[--table->count].name);
+    }
+    return table->frame_sizes[table->depth--];
+}
+
+ScopeEntry* scope_declare(ScopeTable* table, char* name, ValueType type) {
+    if (!table || !name || table->depth == GLOBAL_DEPTH) {
+        return NULL;
+    }
+    for (size_t i = table->count; i > 0; i--) {
+        ScopeEntry* entry = &table->entries[i - 1];
+        if (entry->depth != table->depth) {
+            break;
+        }
+        if (strcmp(entry->name, name) == 0) {
+            return NULL;
+        }
+    }
+    if (table->count == table->capacity) {
+        size_t capacity = table->capacity ? table->capacity * 2 : 16;
+        ScopeEntry* entries = mem_realloc(table->entries, capacity * sizeof(ScopeEntry));
+        if (!entries) {
+            return NULL;
+        }
+        table->entries = entries;
+        table->capacity = capacity;
+    }
+    char* copy = mem_strdup(name);
+    if (!copy) {
+        return NULL;
+    }
+    ScopeEntry* entry = &table->entries[table->count++];
+    entry->name = copy;
+    entry->type = type;
+    entry->depth = table->depth;
+    entry->slot = table->frame_sizes[table->depth]++;
+    return entry;
+}
+
+ScopeEntry* scope_resolve(ScopeTable* table, char* name) {
+    if (!table || !name) {
+        return NULL;
+    }
+    for (size_t i = table->count; i > 0; i--) {
+        if (strcmp(table->entries[i - 1].name, name) == 0) {
+            return &table->entries[i - 1];
+        }
+    }
+    return NULL;
+}
+
+void free_scope_table(ScopeTable* table) {
+    if (!table) {
+        return;
+    }
+    for (size_t i = 0; i < table->count; i++) {
+        mem_free(table->entries[i].name);
+    }
+    mem_free(table->entries);
+    mem_free(table);
+}
+
+ValueStack* create_value_stack(void) {
+    ValueStack* stack = mem_alloc(sizeof(ValueStack));
+    if (!stack) {
+        return NULL;
+    }
+    stack->slots = NULL;
+    stack->top = 0;
+    stack->capacity = 0;
+    stack->depth = GLOBAL_DEPTH;
+    stack->frame_bases[GLOBAL_DEPTH] = 0;
+    stack->strings = NULL;
+    return stack;
+}
+
+bool push_frame(ValueStack* stack, int frame_size) {
+    if (!stack || frame_size < 0 || stack->depth >= MAX_BLOCK_DEPTH) {
+        return false;
+    }
+    size_t needed = stack->top + (size_t)frame_size;
+    if (needed > stack->capacity) {
+        size_t capacity = stack->capacity ? stack->capacity : 64;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        Value* slots = mem_realloc(stack->slots, capacity * sizeof(Value));
+        if (!slots) {
+            return false;
+        }
+        stack->slots = slots;
+        stack->capacity = capacity;
+    }
+    memset(stack->slots + stack->top, 0, (size_t)frame_size * sizeof(Value));
+    stack->frame_bases[++stack->depth] = stack->top;
+    stack->top = needed;
+    return true;
+}
+
+void pop_frame(ValueStack* stack) {
+    if (!stack || stack->depth == GLOBAL_DEPTH) {
+        return;
+    }
+    size_t base = stack->frame_bases[stack->depth--];
+    for (size_t i = base; i < stack->top; i++) {
+        if (stack->slots[i].type == TYPE_STRING) {
+            release_slot_string(&stack->slots[i]);
+        } else if (stack->slots[i].type == TYPE_INT_ARRAY) {
+            free_int_array(stack->slots[i].data.array_val);
+        }
+    }
+    stack->top = base;
+}
+
+Value* frame_slot(ValueStack* stack, int depth, int slot) {
+    if (!stack || depth <= GLOBAL_DEPTH || depth > stack->depth || slot < 0) {
+        return NULL;
+    }
+    return &stack->slots[stack->frame_bases[depth] + (size_t)slot];
+}
+
+bool append_local(ValueStack* stack, int depth, int slot, const char* text, size_t length) {
+    Value* target = frame_slot(stack, depth, slot);
+    if (!target || target->type != TYPE_STRING || !text) {
+        return false;
+    }
+    if (!stack->strings) {
+        stack->strings = create_string_heap();
+        if (!stack->strings) {
+            return false;
+        }
+    }
+    if (target->data.string_val && !target->pooled) {
+        char* moved = string_heap_alloc(stack->strings, target->data.string_val,
+                                        strlen(target->data.string_val));
+        if (!moved) {
+            return false;
+        }
+        mem_free(target->data.string_val);
+        target->data.string_val = moved;
+        target->pooled = true;
+    }
+    char* appended = string_heap_append(stack->strings, target->data.string_val, text, length);
+    if (!appended) {
+        return false;
+    }
+    target->data.string_val = appended;
+    target->pooled = true;
+    return true;
+}
+
+void release_slot_string(Value* slot) {
+    if (slot->pooled) {
+        string_heap_release(slot->data.string_val);
+    } else {
+        mem_free(slot->data.string_val);
+    }
+    slot->data.string_val = NULL;
+    slot->pooled = false;
+}
+
+void free_value_stack(ValueStack* stack) {
+    if (!stack) {
+        return;
+    }
+    while (stack->depth > GLOBAL_DEPTH) {
+        pop_frame(stack);
+    }
+    mem_free(stack->slots);
+    free_string_heap(stack->strings);
+    mem_free(stack);
+}
@@ -0,0 +1,610 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Streaming Input Implementation
+ * ============================================================================
+ *
+ * Implementation of compressed input and of the sliding-window front end.
+ *
+ * A SourceStream keeps up to STREAM_INPUT_CHUNK bytes of raw file input and
+ * hands them to zlib's inflate() (gzip framing, concatenated members
+ * accepted as gzip(1) does) or to ZSTD_decompressStream() (any number of
+ * frames); plain files are read straight into the caller's buffer. Input
+ * that ends inside a member or frame is reported as truncated.
+ *
+ * The window keeps the decompressed text from the start of the token being
+ * lexed to the end of what has been read. Sliding it first rebases the
+ * line index, which scans the lines that are about to be dropped, then
+ * moves the kept bytes to the front and reads one more chunk behind them.
+ * The parser pulls its tokens through pull_streamed_token() and, like the
+ * pipelined parser, resolves globals against its own symbol environment
+ * seeded from the interpreter's globals. It borrows the line index, which
+ * belongs to the interpreter for the duration of the run.
+ *
+ * As with read_file() + strlen(), the source ends at the first NUL byte.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "stream.h"
+#include "utils.h"
+#include "undo_log.h"
+
+#if defined(HAVE_ZLIB)
+    #include <zlib.h>
+#endif
+#if defined(HAVE_ZSTD)
+    #include <zstd.h>
+#endif
+
+struct SourceStream {
+    const char* filename;
+    int fd;
+    SourceFormat format;
+    unsigned char* input;
+    size_t input_length;
+    size_t input_position;
+    bool input_done;
+    bool frame_done;
+    bool finished;
+#if defined(HAVE_ZLIB)
+    z_stream zlib;
+    bool zlib_ready;
+#endif
+#if defined(HAVE_ZSTD)
+    ZSTD_DStream* zstd;
+#endif
+    bool has_error;
+    char error_message[256];
+};
+
+typedef struct {
+    SourceStream* input;
+    char* text;
+    size_t capacity;
+    size_t length;
+    size_t base;
+    bool at_end;
+    Lexer* lexer;
+    LineIndex* lines;
+} StreamWindow;
+
+static bool has_suffix(const char* name, const char* suffix);
+static bool fill_input(SourceStream* stream);
+static bool start_decoder(SourceStream* stream);
+static bool read_plain(SourceStream* stream, char* buffer, size_t size, size_t* produced);
+static bool read_gzip(SourceStream* stream, char* buffer, size_t size, size_t* produced);
+static bool read_zstd(SourceStream* stream, char* buffer, size_t size, size_t* produced);
+static bool fill_window(StreamWindow* window);
+static bool slide_window(StreamWindow* window, size_t keep);
+static Token* pull_streamed_token(void* context);
+static void report_read_error(Interpreter* interp, Execution* exec, SourceStream* input);
+static void execute_streamed(Interpreter* interp, Execution* exec, Parser* parser, SourceStream* input);
+static StreamStatus stream_file(Interpreter* interp, const char* filename);
+
+static bool has_suffix(const char* name, const char* suffix) {
+    size_t name_length = strlen(name);
+    size_t suffix_length = strlen(suffix);
+    return name_length >= suffix_length && strcmp(name + name_length - suffix_length, suffix) == 0;
+}
+
+size_t source_extension_length(const char* filename) {
+    if (!filename) {
+        return 0;
+    }
+    const char* extensions[] = {".pong", ".pong.gz", ".pong.zst"};
+    for (size_t i = 0; i < sizeof(extensions) / sizeof(extensions[0]); i++) {
+        if (has_suffix(filename, extensions[i])) {
+            return strlen(extensions[i]);
+        }
+    }
+    return 0;
+}
+
+bool is_compressed_source_name(const char* filename) {
+    return source_extension_length(filename) > strlen(".pong");
+}
+
+/*
+ * Moves the unread input to the front of the buffer and appends one read
+ * of raw file bytes behind it; end of file sets input_done.
+ */
+static bool fill_input(SourceStream* stream) {
+    if (stream->input_position > 0) {
+        memmove(stream->input, stream->input + stream->input_position,
+                stream->input_length - stream->input_position);
+        stream->input_length -= stream->input_position;
+        stream->input_position = 0;
+    }
+    while (stream->input_length < STREAM_INPUT_CHUNK) {
+        ssize_t bytes = read(stream->fd, stream->input + stream->input_length,
+                             STREAM_INPUT_CHUNK - stream->input_length);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes < 0) {
+            snprintf(stream->error_message, sizeof(stream->error_message),
+                     "Cannot read file '%s'", stream->filename);
+            stream->has_error = true;
+            return false;
+        }
+        if (bytes == 0) {
+            stream->input_done = true;
+        }
+        stream->input_length += (size_t)bytes;
+        break;
+    }
+    return true;
+}
+
+static bool start_decoder(SourceStream* stream) {
+    const unsigned char* magic = stream->input;
+    size_t length = stream->input_length;
+    if (length >= 2 && magic[0] == 0x1F && magic[1] == 0x8B) {
+        stream->format = SOURCE_GZIP;
+#if defined(HAVE_ZLIB)
+        memset(&stream->zlib, 0, sizeof(stream->zlib));
+        stream->zlib_ready = inflateInit2(&stream->zlib, 15 + 16) == Z_OK;
+        if (stream->zlib_ready) {
+            return true;
+        }
+        snprintf(stream->error_message, sizeof(stream->error_message),
+                 "Cannot initialize gzip decompression for '%s'", stream->filename);
+#else
+        snprintf(stream->error_message, sizeof(stream->error_message),
+                 "'%s' is gzip-compressed but this build has no zlib support", stream->filename);
+#endif
+        stream->has_error = true;
+        return false;
+    }
+    if (length >= 4 && magic[0] == 0x28 && magic[1] == 0xB5 && magic[2] == 0x2F && magic[3] == 0xFD) {
+        stream->format = SOURCE_ZSTD;
+#if defined(HAVE_ZSTD)
+        stream->zstd = ZSTD_createDStream();
+        if (stream->zstd && !ZSTD_isError(ZSTD_initDStream(stream->zstd))) {
+            return true;
+        }
+        snprintf(stream->error_message, sizeof(stream->error_message),
+                 "Cannot initialize zstd decompression for '%s'", stream->filename);
+#else
+        snprintf(stream->error_message, sizeof(stream->error_message),
+                 "'%s' is zstd-compressed but this build has no zstd support", stream->filename);
+#endif
+        stream->has_error = true;
+        return false;
+    }
+    stream->format = SOURCE_PLAIN;
+    return true;
+}
+
+SourceStream* open_source_stream(const char* filename) {
+    if (!filename) {
+        return NULL;
+    }
+    SourceStream* stream = malloc(sizeof(SourceStream));
+    if (!stream) {
+        return NULL;
+    }
+    memset(stream, 0, sizeof(SourceStream));
+    stream->filename = filename;
+    stream->format = SOURCE_PLAIN;
+    stream->input = malloc(STREAM_INPUT_CHUNK);
+    if (!stream->input) {
+        free(stream);
+        return NULL;
+    }
+    stream->fd = open(filename, O_RDONLY);
+    if (stream->fd < 0) {
+        snprintf(stream->error_message, sizeof(stream->error_message),
+                 "Cannot open file '%s'", filename);
+        stream->has_error = true;
+        return stream;
+    }
+    posix_fadvise(stream->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    while (stream->input_length < 4 && !stream->input_done) {
+        if (!fill_input(stream)) {
+            return stream;
+        }
+    }
+    start_decoder(stream);
+    return stream;
+}
+
+SourceFormat source_stream_format(const SourceStream* stream) {
+    return stream ? stream->format : SOURCE_PLAIN;
+}
+
+static bool read_plain(SourceStream* stream, char* buffer, size_t size, size_t* produced) {
+    if (stream->input_position < stream->input_length) {
+        size_t pending = stream->input_length - stream->input_position;
+        *produced = pending < size ? pending : size;
+        memcpy(buffer, stream->input + stream->input_position, *produced);
+        stream->input_position += *produced;
+        return true;
+    }
+    for (;;) {
+        ssize_t bytes = read(stream->fd, buffer, size);
+        if (bytes < 0 && errno == EINTR) {
+            continue;
+        }
+        if (bytes < 0) {
+            snprintf(stream->error_message, sizeof(stream->error_message),
+                     "Cannot read file '%s'", stream->filename);
+            stream->has_error = true;
+            return false;
+        }
+        *produced = (size_t)bytes;
+        stream->finished = bytes == 0;
+        return true;
+    }
+}
+
+static bool read_gzip(SourceStream* stream, char* buffer, size_t size, size_t* produced) {
+#if defined(HAVE_ZLIB)
+    z_stream* zlib = &stream->zlib;
+    while (*produced == 0 && !stream->finished) {
+        if (stream->input_position == stream->input_length && !stream->input_done &&
+            !fill_input(stream)) {
+            return false;
+        }
+        bool drained = stream->input_position == stream->input_length && stream->input_done;
+        if (stream->frame_done) {
+            if (drained) {
+                stream->finished = true;
+                break;
+            }
+            inflateReset(zlib);
+            stream->frame_done = false;
+        }
+        zlib->next_in = stream->input + stream->input_position;
+        zlib->avail_in = (uInt)(stream->input_length - stream->input_position);
+        zlib->next_out = (Bytef*)buffer;
+        zlib->avail_out = (uInt)size;
+        int status = inflate(zlib, Z_NO_FLUSH);
+        stream->input_position = stream->input_length - zlib->avail_in;
+        *produced = size - zlib->avail_out;
+        if (status == Z_STREAM_END) {
+            stream->frame_done = true;
+        } else if (status == Z_BUF_ERROR && *produced == 0 && drained) {
+            snprintf(stream->error_message, sizeof(stream->error_message),
+                     "Truncated gzip data in '%s'", stream->filename);
+            stream->has_error = true;
+            return false;
+        } else if (status != Z_OK && status != Z_BUF_ERROR) {
+            snprintf(stream->error_message, sizeof(stream->error_message),
+                     "Corrupt gzip data in '%s' (%s)", stream->filename,
+                     zlib->msg ? zlib->msg : "inflate failed");
+            stream->has_error = true;
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)buffer;
+    (void)size;
+    (void)produced;
+    stream->has_error = true;
+    return false;
+#endif
+}
+
+static bool read_zstd(SourceStream* stream, char* buffer, size_t size, size_t* produced) {
+#if defined(HAVE_ZSTD)
+    while (*produced == 0 && !stream->finished) {
+        if (stream->input_position == stream->input_length && !stream->input_done &&
+            !fill_input(stream)) {
+            return false;
+        }
+        bool drained = stream->input_position == stream->input_length && stream->input_done;
+        if (stream->frame_done && drained) {
+            stream->finished = true;
+            break;
+        }
+        ZSTD_inBuffer in = {stream->input, stream->input_length, stream->input_position};
+        ZSTD_outBuffer out = {buffer, size, 0};
+        size_t hint = ZSTD_decompressStream(stream->zstd, &out, &in);
+        stream->input_position = in.pos;
+        *produced = out.pos;
+        if (ZSTD_isError(hint)) {
+            snprintf(stream->error_message, sizeof(stream->error_message),
+                     "Corrupt zstd data in '%s' (%s)", stream->filename, ZSTD_getErrorName(hint));
+            stream->has_error = true;
+            return false;
+        }
+        stream->frame_done = hint == 0;
+        if (*produced == 0 && drained && !stream->frame_done) {
+            snprintf(stream->error_message, sizeof(stream->error_message),
+                     "Truncated zstd data in '%s'", stream->filename);
+            stream->has_error = true;
+            return false;
+        }
+    }
+    return true;
+#else
+    (void)buffer;
+    (void)size;
+    (void)produced;
+    stream->has_error = true;
+    return false;
+#endif
+}
+
+bool read_source_stream(SourceStream* stream, char* buffer, size_t size, size_t* produced) {
+    *produced = 0;
+    if (!stream || stream->has_error) {
+        return false;
+    }
+    if (stream->finished || size == 0) {
+        return true;
+    }
+    switch (stream->format) {
+        case SOURCE_GZIP:
+            return read_gzip(stream, buffer, size, produced);
+        case SOURCE_ZSTD:
+            return read_zstd(stream, buffer, size, produced);
+        default:
+            return read_plain(stream, buffer, size, produced);
+    }
+}
+
+const char* source_stream_error(const SourceStream* stream) {
+    return stream && stream->has_error ? stream->error_message : NULL;
+}
+
+void close_source_stream(SourceStream* stream) {
+    if (!stream) {
+        return;
+    }
+#if defined(HAVE_ZLIB)
+    if (stream->zlib_ready) {
+        inflateEnd(&stream->zlib);
+    }
+#endif
+#if defined(HAVE_ZSTD)
+    ZSTD_freeDStream(stream->zstd);
+#endif
+    if (stream->fd >= 0) {
+        close(stream->fd);
+    }
+    free(stream->input);
+    free(stream);
+}
+
+char* read_source(char* filename) {
+    SourceStream* stream = open_source_stream(filename);
+    if (!stream) {
+        fprintf(stderr, "Error: Memory allocation failed for file '%s'\n", filename);
+        return NULL;
+    }
+    if (stream->has_error || stream->format == SOURCE_PLAIN) {
+        if (stream->has_error) {
+            fprintf(stderr, "Error: %s\n", stream->error_message);
+        }
+        bool plain = !stream->has_error;
+        close_source_stream(stream);
+        return plain ? read_file(filename) : NULL;
+    }
+    size_t capacity = STREAM_WINDOW;
+    size_t length = 0;
+    char* text = malloc(capacity + 1);
+    size_t produced = 1;
+    while (text && produced > 0) {
+        if (length == capacity) {
+            char* grown = realloc(text, capacity * 2 + 1);
+            if (!grown) {
+                free(text);
+                text = NULL;
+                break;
+            }
+            text = grown;
+            capacity *= 2;
+        }
+        if (!read_source_stream(stream, text + length, capacity - length, &produced)) {
+            fprintf(stderr, "Error: %s\n", stream->error_message);
+            free(text);
+            text = NULL;
+            break;
+        }
+        length += produced;
+    }
+    if (text) {
+        text[length] = '\0';
+    } else if (!stream->has_error) {
+        fprintf(stderr, "Error: Memory allocation failed for file '%s'\n", filename);
+    }
+    close_source_stream(stream);
+    return text;
+}
+
+/*
+ * Reads one chunk into the free end of the window; a NUL byte or the end
+ * of the input sets at_end.
+ */
+static bool fill_window(StreamWindow* window) {
+    size_t produced;
+    if (!read_source_stream(window->input, window->text + window->length,
+                            window->capacity - window->length, &produced)) {
+        return false;
+    }
+    char* terminator = memchr(window->text + window->length, '\0', produced);
+    if (terminator) {
+        produced = (size_t)(terminator - (window->text + window->length));
+        window->at_end = true;
+    }
+    window->length += produced;
+    window->at_end = window->at_end || produced == 0;
+    window->text[window->length] = '\0';
+    return true;
+}
+
+/*
+ * Drops the bytes before `keep` (or doubles the window when there are none
+ * to drop), refills it and points the lexer at `keep`'s new place.
+ */
+static bool slide_window(StreamWindow* window, size_t keep) {
+    if (!line_index_rebase(window->lines, window->text, window->base + keep)) {
+        return false;
+    }
+    memmove(window->text, window->text + keep, window->length - keep);
+    window->length -= keep;
+    window->base += keep;
+    if (window->length == window->capacity) {
+        char* grown = realloc(window->text, window->capacity * 2 + 1);
+        if (!grown || !line_index_rebase(window->lines, grown, window->base)) {
+            window->text = grown ? grown : window->text;
+            return false;
+        }
+        window->text = grown;
+        window->capacity *= 2;
+    }
+    if (!fill_window(window)) {
+        return false;
+    }
+    window->lexer->source = window->text;
+    window->lexer->length = window->length;
+    lexer_seek(window->lexer, 0);
+    return true;
+}
+
+static Token* pull_streamed_token(void* context) {
+    StreamWindow* window = context;
+    Lexer* lexer = window->lexer;
+    for (;;) {
+        size_t position = lexer->position;
+        Token* token = next_token(lexer);
+        if (!token) {
+            return NULL;
+        }
+        if (window->at_end || lexer->position < lexer->length) {
+            token->offset += window->base;
+            return token;
+        }
+        free_token(token);
+        if (!slide_window(window, position)) {
+            return NULL;
+        }
+    }
+}
+
+static void report_read_error(Interpreter* interp, Execution* exec, SourceStream* input) {
+    const char* message = source_stream_error(input);
+    fprintf(interp->output, "Read error: %s\n", message ? message : "Failed to read source");
+    snprintf(interp->error_message, sizeof(interp->error_message), "%s",
+             message ? message : "Failed to read source");
+    interp->has_error = true;
+    exec->failed = true;
+}
+
+static void execute_streamed(Interpreter* interp, Execution* exec, Parser* parser, SourceStream* input) {
+    for (;;) {
+        if (!parser->current_token) {
+            report_read_error(interp, exec, input);
+            return;
+        }
+        if (parser->current_token->type == TOKEN_EOF) {
+            return;
+        }
+        exec->failed = true;
+        if (parser->has_error) {
+            fprintf(interp->output, "Parser error: %s\n", parser->error_message);
+            return;
+        }
+        Statement* stmt = parse_statement(parser);
+        if (!stmt) {
+            if (source_stream_error(input)) {
+                report_read_error(interp, exec, input);
+            } else if (parser->has_error) {
+                fprintf(interp->output, "Parse error: %s\n", parser->error_message);
+            }
+            return;
+        }
+        if (!execute_statement(interp, stmt)) {
+            fprintf(interp->output, "Runtime error: %s\n", interp->error_message);
+            free_statement(stmt);
+            return;
+        }
+        free_statement(stmt);
+        exec->failed = false;
+    }
+}
+
+StreamStatus run_streamed(Interpreter* interp, const char* filename) {
+    if (!interp || !filename) {
+        return STREAM_START_FAILED;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    StreamStatus status = stream_file(interp, filename);
+    use_allocator(previous);
+    return status;
+}
+
+static StreamStatus stream_file(Interpreter* interp, const char* filename) {
+    StreamWindow window;
+    memset(&window, 0, sizeof(window));
+    window.input = open_source_stream(filename);
+    if (window.input && window.input->has_error) {
+        fprintf(stderr, "Error: %s\n", window.input->error_message);
+        close_source_stream(window.input);
+        return STREAM_READ_FAILED;
+    }
+    window.capacity = STREAM_WINDOW;
+    window.text = window.input ? malloc(window.capacity + 1) : NULL;
+    if (window.text && !fill_window(&window)) {
+        fprintf(stderr, "Error: %s\n", window.input->error_message);
+        free(window.text);
+        close_source_stream(window.input);
+        return STREAM_READ_FAILED;
+    }
+    if (window.text && window.length == 0) {
+        free(window.text);
+        close_source_stream(window.input);
+        return STREAM_EMPTY_SOURCE;
+    }
+    Environment* symbols = clone_env(interp->global_env);
+    window.lexer = window.text ? init_lexer_with_length(window.text, window.length) : NULL;
+    window.lines = create_line_index(window.text);
+    Execution exec;
+    memset(&exec, 0, sizeof(exec));
+    if (interp->transactional) {
+        exec.undo_log = create_undo_log();
+    }
+    Parser* parser = window.lexer && window.lines && symbols
+                     ? init_parser_source(pull_streamed_token, &window, window.text, symbols)
+                     : NULL;
+    if (!parser || (interp->transactional && !exec.undo_log)) {
+        free_parser(parser);
+        free_undo_log(exec.undo_log);
+        free_env(symbols);
+        free_line_index(window.lines);
+        free_lexer(window.lexer);
+        free(window.text);
+        close_source_stream(window.input);
+        snprintf(interp->error_message, sizeof(interp->error_message),
+                 "Failed to initialize streaming input");
+        interp->has_error = true;
+        return STREAM_START_FAILED;
+    }
+    parser->lines = window.lines;
+
+    interp->global_env->undo_log = exec.undo_log;
+    free_line_index(interp->lines);
+    interp->lines = window.lines;
+    fprintf(interp->output, "=== PONG INTERPRETER EXECUTION ===\n");
+    execute_streamed(interp, &exec, parser, window.input);
+    end_execution(interp, &exec);
+    fprintf(interp->output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(interp->output, "Executed %d statements\n", interp->executed_statements);
+    parser->lines = NULL;
+    free_parser(parser);
+    free_env(symbols);
+    free_lexer(window.lexer);
+    free(window.text);
+    close_source_stream(window.input);
+    return STREAM_COMPLETED;
+}
@@ -0,0 +1,313 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - String Heap Implementation
+ * ============================================================================
+ * 
+ * Implementation of the size-classed string heap. A block is a StringHeader
+ * followed by `capacity` bytes of text; for slab blocks the capacity is the
+ * size class, and a freed block stores the free-list link in its text.
+ * Blocks too large for any class are preceded by a StringLarge link so the
+ * heap can free them all when it is destroyed.
+ * 
+ * Appends grow a block geometrically: a slab string moves to the class
+ * that fits it (each class doubles the previous one) and a large block is
+ * realloc'd to at least twice its capacity, so building a string from n
+ * pieces copies O(n) bytes in total. A large block can therefore carry
+ * spare capacity; the assignment path keeps reusing it, since all large
+ * blocks count as one size class.
+ * 
+ * Slabs are never returned one by one, since their free blocks are spread
+ * over the class free list: memory goes back to the system when the heap
+ * is destroyed, typically by compaction (see compact_env_strings()), which
+ * copies the live strings into a fresh heap.
+ * 
+ * Counters: live_bytes is the text actually stored (length + 1), used_bytes
+ * the capacity of the blocks holding it, and reserved_bytes everything
+ * obtained from the allocator. Fragmentation is the share of reserved bytes that
+ * holds no live text.
+ * 
+ * ============================================================================
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "string_heap.h"
+#include "allocator.h"
+
+static int size_class_of(size_t size);
+static size_t class_capacity(int size_class);
+static char* take_block(StringHeap* heap, int size_class);
+static char* new_block(StringHeap* heap, size_t capacity);
+static char* place_text(StringHeap* heap, char* block, const char* text, size_t length);
+static size_t grown_capacity(size_t capacity, size_t needed);
+static char* grow_large(StringHeap* heap, char* current, size_t capacity);
+static char* header_text(StringHeader* header);
+static StringHeader* text_header(const char* text);
+
+static int size_class_of(size_t size) {
+    size_t capacity = STRING_HEAP_MIN_CLASS;
+    for (int size_class = 0; size_class < STRING_HEAP_CLASS_COUNT; size_class++) {
+        if (size <= capacity) {
+            return size_class;
+        }
+        capacity <<= 1;
+    }
+    return -1;
+}
+
+static size_t class_capacity(int size_class) {
+    return (size_t)STRING_HEAP_MIN_CLASS << size_class;
+}
+
+static char* header_text(StringHeader* header) {
+    return (char*)(header + 1);
+}
+
+static StringHeader* text_header(const char* text) {
+    return (StringHeader*)text - 1;
+}
+
+StringHeap* create_string_heap(void) {
+    return mem_calloc(1, sizeof(StringHeap));
+}
+
+static char* take_block(StringHeap* heap, int size_class) {
+    char* text = heap->free_lists[size_class];
+    if (text) {
+        memcpy(&heap->free_lists[size_class], text, sizeof(char*));
+        return text;
+    }
+    size_t block_size = sizeof(StringHeader) + class_capacity(size_class);
+    if (heap->carve_left[size_class] < block_size) {
+        StringSlab* slab = mem_alloc(STRING_HEAP_SLAB_SIZE);
+        if (!slab) {
+            return NULL;
+        }
+        slab->next = heap->slabs;
+        slab->size = STRING_HEAP_SLAB_SIZE;
+        heap->slabs = slab;
+        heap->slab_count++;
+        heap->reserved_bytes += STRING_HEAP_SLAB_SIZE;
+        heap->carve[size_class] = (char*)(slab + 1);
+        heap->carve_left[size_class] = STRING_HEAP_SLAB_SIZE - sizeof(StringSlab);
+    }
+    StringHeader* header = (StringHeader*)heap->carve[size_class];
+    heap->carve[size_class] += block_size;
+    heap->carve_left[size_class] -= block_size;
+    header->capacity = (uint32_t)class_capacity(size_class);
+    header->heap = heap;
+    return header_text(header);
+}
+
+/*
+ * Returns a block of at least `capacity` bytes with its header's capacity
+ * and heap set; the caller fills in the text and the counters.
+ */
+static char* new_block(StringHeap* heap, size_t capacity) {
+    int size_class = size_class_of(capacity);
+    if (size_class >= 0) {
+        return take_block(heap, size_class);
+    }
+    StringLarge* large = mem_alloc(sizeof(StringLarge) + sizeof(StringHeader) + capacity);
+    if (!large) {
+        return NULL;
+    }
+    large->prev = NULL;
+    large->next = heap->large_blocks;
+    if (large->next) {
+        large->next->prev = large;
+    }
+    heap->large_blocks = large;
+    StringHeader* header = (StringHeader*)(large + 1);
+    header->capacity = (uint32_t)capacity;
+    header->heap = heap;
+    heap->reserved_bytes += sizeof(StringLarge) + sizeof(StringHeader) + capacity;
+    return header_text(header);
+}
+
+static char* place_text(StringHeap* heap, char* block, const char* text, size_t length) {
+    StringHeader* header = text_header(block);
+    header->length = (uint32_t)length;
+    memcpy(block, text, length);
+    block[length] = '\0';
+    heap->live_strings++;
+    heap->live_bytes += length + 1;
+    heap->used_bytes += header->capacity;
+    return block;
+}
+
+char* string_heap_alloc(StringHeap* heap, const char* text, size_t length) {
+    if (!heap || !text || length >= UINT32_MAX - 1) {
+        return NULL;
+    }
+    char* block = new_block(heap, length + 1);
+    return block ? place_text(heap, block, text, length) : NULL;
+}
+
+char* string_heap_assign(StringHeap* heap, char* current, const char* text, size_t length) {
+    if (!heap || !text) {
+        return NULL;
+    }
+    if (current) {
+        StringHeader* header = text_header(current);
+        if (header->heap == heap && length + 1 <= header->capacity &&
+            size_class_of(length + 1) == size_class_of(header->capacity)) {
+            heap->live_bytes = heap->live_bytes - (header->length + 1) + (length + 1);
+            memmove(current, text, length);
+            current[length] = '\0';
+            header->length = (uint32_t)length;
+            return current;
+        }
+    }
+    char* replacement = string_heap_alloc(heap, text, length);
+    if (replacement && current) {
+        string_heap_release(current);
+    }
+    return replacement;
+}
+
+/*
+ * Slab strings grow into the class that fits them; large ones at least
+ * double, up to what the 32-bit header can record.
+ */
+static size_t grown_capacity(size_t capacity, size_t needed) {
+    if (size_class_of(needed) >= 0) {
+        return needed;
+    }
+    size_t grown = capacity * 2;
+    if (grown < needed) {
+        grown = needed;
+    }
+    return grown < UINT32_MAX ? grown : needed;
+}
+
+/*
+ * Resizes a large block with mem_realloc(), which can often extend it where it
+ * is, and relinks its neighbours in case it moved.
+ */
+static char* grow_large(StringHeap* heap, char* current, size_t capacity) {
+    StringHeader* header = text_header(current);
+    size_t old_capacity = header->capacity;
+    StringLarge* large = mem_realloc((StringLarge*)header - 1,
+                                     sizeof(StringLarge) + sizeof(StringHeader) + capacity);
+    if (!large) {
+        return NULL;
+    }
+    if (large->prev) {
+        large->prev->next = large;
+    } else {
+        heap->large_blocks = large;
+    }
+    if (large->next) {
+        large->next->prev = large;
+    }
+    header = (StringHeader*)(large + 1);
+    header->capacity = (uint32_t)capacity;
+    heap->reserved_bytes += capacity - old_capacity;
+    heap->used_bytes += capacity - old_capacity;
+    return header_text(header);
+}
+
+char* string_heap_append(StringHeap* heap, char* current, const char* text, size_t length) {
+    if (!heap || !text) {
+        return NULL;
+    }
+    if (!current) {
+        return string_heap_alloc(heap, text, length);
+    }
+    StringHeader* header = text_header(current);
+    size_t old_length = header->length;
+    size_t needed = old_length + length + 1;
+    if (header->heap != heap || needed >= UINT32_MAX) {
+        return NULL;
+    }
+    if (needed > header->capacity) {
+        size_t capacity = grown_capacity(header->capacity, needed);
+        char* block;
+        if (size_class_of(header->capacity) < 0) {
+            block = grow_large(heap, current, capacity);
+        } else {
+            block = new_block(heap, capacity);
+            if (block) {
+                place_text(heap, block, current, old_length);
+                string_heap_release(current);
+            }
+        }
+        if (!block) {
+            return NULL;
+        }
+        current = block;
+        header = text_header(block);
+    }
+    memcpy(current + old_length, text, length);
+    current[old_length + length] = '\0';
+    header->length = (uint32_t)(old_length + length);
+    heap->live_bytes += length;
+    return current;
+}
+
+void string_heap_release(char* string) {
+    if (!string) {
+        return;
+    }
+    StringHeader* header = text_header(string);
+    StringHeap* heap = header->heap;
+    heap->live_strings--;
+    heap->live_bytes -= header->length + 1;
+    heap->used_bytes -= header->capacity;
+    int size_class = size_class_of(header->capacity);
+    if (size_class < 0) {
+        StringLarge* large = (StringLarge*)header - 1;
+        if (large->prev) {
+            large->prev->next = large->next;
+        } else {
+            heap->large_blocks = large->next;
+        }
+        if (large->next) {
+            large->next->prev = large->prev;
+        }
+        heap->reserved_bytes -= sizeof(StringLarge) + sizeof(StringHeader) + header->capacity;
+        mem_free(large);
+        return;
+    }
+    memcpy(string, &heap->free_lists[size_class], sizeof(char*));
+    heap->free_lists[size_class] = string;
+}
+
+size_t string_heap_length(const char* string) {
+    return string ? text_header(string)->length : 0;
+}
+
+void string_heap_stats(const StringHeap* heap, StringHeapStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    if (!heap) {
+        return;
+    }
+    stats->live_strings = heap->live_strings;
+    stats->live_bytes = heap->live_bytes;
+    stats->used_bytes = heap->used_bytes;
+    stats->reserved_bytes = heap->reserved_bytes;
+    stats->slab_count = heap->slab_count;
+    if (heap->reserved_bytes > 0) {
+        stats->fragmentation = 1.0 - (double)heap->live_bytes / (double)heap->reserved_bytes;
+    }
+}
+
+void free_string_heap(StringHeap* heap) {
+    if (!heap) {
+        return;
+    }
+    StringSlab* slab = heap->slabs;
+    while (slab) {
+        StringSlab* next = slab->next;
+        mem_free(slab);
+        slab = next;
+    }
+    StringLarge* large = heap->large_blocks;
+    while (large) {
+        StringLarge* next = large->next;
+        mem_free(large);
+        large = next;
+    }
+    mem_free(heap);
+}
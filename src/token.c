@@ -19,15 +19,15 @@
 #include <stdlib.h>
 #include <string.h>
 #include "token.h"
+#include "allocator.h"
 
-Token* create_token(TokenType type, void* value, int line, int col) {
-    Token* token = malloc(sizeof(Token));
+Token* create_token(TokenType type, void* value, size_t offset) {
+    Token* token = mem_alloc(sizeof(Token));
     if (!token) {
         return NULL;
     }
     token->type = type;
-    token->line = line;
-    token->column = col;
+    token->offset = offset;
     switch (type) {
         case TOKEN_NUMBER:
         case TOKEN_INT:
@@ -40,7 +40,7 @@ Token* create_token(TokenType type, void* value, int line, int col) {
         case TOKEN_CHAR_LITERAL:
         case TOKEN_CHAR:
             if (value) {
-                token->value.char_val = *(char*)value;
+                token->value.char_val = *(uint32_t*)value;
             } else {
                 token->value.char_val = '\0';
             }
@@ -49,9 +49,9 @@ Token* create_token(TokenType type, void* value, int line, int col) {
         case TOKEN_STRING:
         case TOKEN_IDENTIFIER:
             if (value) {
-                token->value.string_val = strdup((char*)value);
+                token->value.string_val = mem_strdup((char*)value);
                 if (!token->value.string_val) {
-                    free(token);
+                    mem_free(token);
                     return NULL;
                 }
             } else {
@@ -74,13 +74,13 @@ void free_token(Token* token) {
         case TOKEN_STRING:
         case TOKEN_IDENTIFIER:
             if (token->value.string_val) {
-                free(token->value.string_val);
+                mem_free(token->value.string_val);
             }
             break;
         default:
             break;
     }
-    free(token);
+    mem_free(token);
 }
 
 void print_token(Token* token) {
@@ -96,7 +96,9 @@ void print_token(Token* token) {
             break;
         case TOKEN_CHAR:
         case TOKEN_CHAR_LITERAL:
-            printf("CHAR:'%c'", token->value.char_val);
+            printf("CHAR:'");
+            print_code_point(stdout, token->value.char_val);
+            putchar('\'');
             break;
         case TOKEN_STRING:
         case TOKEN_STRING_LITERAL:
@@ -123,6 +125,9 @@ void print_token(Token* token) {
         case TOKEN_KEYWORD_STRING:
             printf("KEYWORD:string");
             break;
+        case TOKEN_KEYWORD_REPEAT:
+            printf("KEYWORD:repeat");
+            break;
         case TOKEN_EOF:
             printf("EOF");
             break;
@@ -130,7 +135,7 @@ void print_token(Token* token) {
             printf("UNKNOWN");
             break;
     }
-    printf("@%d:%d", token->line, token->column);
+    printf("@%zu", token->offset);
 }
 
 bool is_keyword(char* str) {
@@ -139,5 +144,6 @@ bool is_keyword(char* str) {
     }
     return (strcmp(str, "int") == 0 || 
             strcmp(str, "char") == 0 || 
-            strcmp(str, "string") == 0);
+            strcmp(str, "string") == 0 ||
+            strcmp(str, "repeat") == 0);
 }
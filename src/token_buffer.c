@@ -0,0 +1,160 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Token Buffer Implementation
+ * ============================================================================
+ * 
+ * Implementation of whole-file tokenization into a structure-of-arrays
+ * token buffer. Tokens are produced by the lexer's allocation-free
+ * scan_lexeme() and appended to geometrically grown parallel arrays.
+ * 
+ * Filling a Token from the buffer is a copy of its type, offset and value;
+ * no position is computed unless an error needs one.
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "token_buffer.h"
+
+static bool reserve_tokens(TokenBuffer* buffer);
+static bool intern_text(TokenBuffer* buffer, const char* text, size_t length, uint32_t* offset);
+
+static bool reserve_tokens(TokenBuffer* buffer) {
+    if (buffer->count < buffer->capacity) {
+        return true;
+    }
+    size_t capacity = buffer->capacity ? buffer->capacity * 2 : 1024;
+    uint8_t* types = realloc(buffer->types, capacity * sizeof(uint8_t));
+    if (!types) {
+        return false;
+    }
+    buffer->types = types;
+    uint32_t* offsets = realloc(buffer->offsets, capacity * sizeof(uint32_t));
+    if (!offsets) {
+        return false;
+    }
+    buffer->offsets = offsets;
+    uint32_t* values = realloc(buffer->values, capacity * sizeof(uint32_t));
+    if (!values) {
+        return false;
+    }
+    buffer->values = values;
+    buffer->capacity = capacity;
+    return true;
+}
+
+static bool intern_text(TokenBuffer* buffer, const char* text, size_t length, uint32_t* offset) {
+    size_t needed = buffer->pool_length + length + 1;
+    if (needed > UINT32_MAX) {
+        return false;
+    }
+    if (needed > buffer->pool_capacity) {
+        size_t capacity = buffer->pool_capacity ? buffer->pool_capacity : 4096;
+        while (capacity < needed) {
+            capacity *= 2;
+        }
+        char* pool = realloc(buffer->pool, capacity);
+        if (!pool) {
+            return false;
+        }
+        buffer->pool = pool;
+        buffer->pool_capacity = capacity;
+    }
+    *offset = (uint32_t)buffer->pool_length;
+    memcpy(buffer->pool + buffer->pool_length, text, length);
+    buffer->pool[buffer->pool_length + length] = '\0';
+    buffer->pool_length = needed;
+    return true;
+}
+
+TokenBuffer* tokenize_source(Lexer* lexer) {
+    if (!lexer || lexer->length > UINT32_MAX) {
+        return NULL;
+    }
+    TokenBuffer* buffer = calloc(1, sizeof(TokenBuffer));
+    if (!buffer) {
+        return NULL;
+    }
+    buffer->source = lexer->source;
+    Lexeme lexeme;
+    do {
+        if (!scan_lexeme(lexer, &lexeme) || !reserve_tokens(buffer)) {
+            free_token_buffer(buffer);
+            return NULL;
+        }
+        uint32_t value = 0;
+        switch (lexeme.type) {
+            case TOKEN_NUMBER:
+                value = (uint32_t)lexeme.int_val;
+                break;
+            case TOKEN_CHAR_LITERAL:
+                value = lexeme.char_val;
+                break;
+            case TOKEN_IDENTIFIER:
+            case TOKEN_STRING_LITERAL:
+                if (!intern_text(buffer, lexeme.text, lexeme.length, &value)) {
+                    free_token_buffer(buffer);
+                    return NULL;
+                }
+                break;
+            default:
+                break;
+        }
+        buffer->types[buffer->count] = (uint8_t)lexeme.type;
+        buffer->offsets[buffer->count] = (uint32_t)lexeme.offset;
+        buffer->values[buffer->count] = value;
+        buffer->count++;
+    } while (lexeme.type != TOKEN_EOF);
+    return buffer;
+}
+
+TokenType token_buffer_type(const TokenBuffer* buffer, size_t index) {
+    if (!buffer || buffer->count == 0) {
+        return TOKEN_EOF;
+    }
+    if (index >= buffer->count) {
+        index = buffer->count - 1;
+    }
+    return (TokenType)buffer->types[index];
+}
+
+bool token_buffer_fill(const TokenBuffer* buffer, size_t index, Token* token) {
+    if (!buffer || !token || buffer->count == 0) {
+        return false;
+    }
+    if (index >= buffer->count) {
+        index = buffer->count - 1;
+    }
+    token->type = (TokenType)buffer->types[index];
+    token->offset = buffer->offsets[index];
+    uint32_t value = buffer->values[index];
+    switch (token->type) {
+        case TOKEN_NUMBER:
+            token->value.int_val = (int)value;
+            break;
+        case TOKEN_CHAR_LITERAL:
+            token->value.char_val = value;
+            break;
+        case TOKEN_IDENTIFIER:
+        case TOKEN_STRING_LITERAL:
+            token->value.string_val = buffer->pool + value;
+            break;
+        default:
+            token->value.int_val = 0;
+            break;
+    }
+    return true;
+}
+
+void free_token_buffer(TokenBuffer* buffer) {
+    if (!buffer) {
+        return;
+    }
+    free(buffer->types);
+    free(buffer->offsets);
+    free(buffer->values);
+    free(buffer->pool);
+    free(buffer);
+}
@@ -0,0 +1,502 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Execution Trace Implementation
+ * ============================================================================
+ *
+ * Implementation of the binary execution trace writer and reader. Both
+ * sides keep the same name and literal pools in the same order, so ids
+ * never need to be written next to the pool records that define them.
+ *
+ * The writer's pools are hashed (FNV-1a, open addressing) because every
+ * traced statement looks its variable up; the reader's pools are plain
+ * arrays indexed by id.
+ *
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "trace.h"
+#include "int_array.h"
+
+#define TRACE_MAX_RECORD 32
+
+static uint32_t hash_text(const char* text, size_t length);
+static bool pool_append(TracePool* pool, const char* text, size_t length);
+static bool pool_rehash(TracePool* pool);
+static bool pool_intern(TracePool* pool, const char* text, size_t length, uint32_t* id, bool* added);
+static void free_pool(TracePool* pool);
+static bool flush_trace(TraceWriter* trace);
+static uint8_t* reserve_record(TraceWriter* trace, size_t size);
+static size_t put_varint(uint8_t* out, uint64_t value);
+static uint64_t zigzag_encode(int64_t value);
+static int64_t zigzag_decode(uint64_t value);
+static bool write_pool_record(TraceWriter* trace, uint8_t tag, const char* text, size_t length);
+static bool intern_reference(TraceWriter* trace, TracePool* pool, uint8_t tag, const char* text, uint32_t* id);
+static bool read_varint(TraceReader* reader, uint64_t* value);
+static bool read_pool_record(TraceReader* reader, TracePool* pool);
+static bool read_statement(TraceReader* reader, uint8_t tag, TraceEvent* event);
+static bool fail_read(TraceReader* reader, const char* message);
+
+static uint32_t hash_text(const char* text, size_t length) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (uint8_t)text[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+static bool pool_append(TracePool* pool, const char* text, size_t length) {
+    if (pool->count == pool->capacity) {
+        size_t capacity = pool->capacity ? pool->capacity * 2 : 64;
+        TracePoolEntry* entries = realloc(pool->entries, capacity * sizeof(TracePoolEntry));
+        if (!entries) {
+            return false;
+        }
+        pool->entries = entries;
+        pool->capacity = capacity;
+    }
+    char* copy = malloc(length + 1);
+    if (!copy) {
+        return false;
+    }
+    memcpy(copy, text, length);
+    copy[length] = '\0';
+    pool->entries[pool->count].text = copy;
+    pool->entries[pool->count].length = length;
+    pool->count++;
+    return true;
+}
+
+static bool pool_rehash(TracePool* pool) {
+    size_t bucket_count = pool->bucket_count ? pool->bucket_count * 2 : 128;
+    uint32_t* buckets = calloc(bucket_count, sizeof(uint32_t));
+    if (!buckets) {
+        return false;
+    }
+    for (size_t id = 0; id < pool->count; id++) {
+        TracePoolEntry* entry = &pool->entries[id];
+        size_t bucket = hash_text(entry->text, entry->length) & (bucket_count - 1);
+        while (buckets[bucket]) {
+            bucket = (bucket + 1) & (bucket_count - 1);
+        }
+        buckets[bucket] = (uint32_t)id + 1;
+    }
+    free(pool->buckets);
+    pool->buckets = buckets;
+    pool->bucket_count = bucket_count;
+    return true;
+}
+
+static bool pool_intern(TracePool* pool, const char* text, size_t length, uint32_t* id, bool* added) {
+    if ((pool->count + 1) * 2 > pool->bucket_count && !pool_rehash(pool)) {
+        return false;
+    }
+    size_t mask = pool->bucket_count - 1;
+    size_t bucket = hash_text(text, length) & mask;
+    while (pool->buckets[bucket]) {
+        TracePoolEntry* entry = &pool->entries[pool->buckets[bucket] - 1];
+        if (entry->length == length && memcmp(entry->text, text, length) == 0) {
+            *id = pool->buckets[bucket] - 1;
+            *added = false;
+            return true;
+        }
+        bucket = (bucket + 1) & mask;
+    }
+    if (pool->count >= UINT32_MAX || !pool_append(pool, text, length)) {
+        return false;
+    }
+    *id = (uint32_t)(pool->count - 1);
+    pool->buckets[bucket] = (uint32_t)pool->count;
+    *added = true;
+    return true;
+}
+
+static void free_pool(TracePool* pool) {
+    for (size_t i = 0; i < pool->count; i++) {
+        free(pool->entries[i].text);
+    }
+    free(pool->entries);
+    free(pool->buckets);
+}
+
+static bool flush_trace(TraceWriter* trace) {
+    size_t written = 0;
+    while (written < trace->used) {
+        ssize_t result = write(trace->fd, trace->buffer + written, trace->used - written);
+        if (result < 0 && errno == EINTR) {
+            continue;
+        }
+        if (result <= 0) {
+            trace->failed = true;
+            trace->used = 0;
+            return false;
+        }
+        written += (size_t)result;
+    }
+    trace->bytes_written += trace->used;
+    trace->used = 0;
+    return true;
+}
+
+static uint8_t* reserve_record(TraceWriter* trace, size_t size) {
+    if (trace->failed) {
+        return NULL;
+    }
+    if (trace->used + size > TRACE_BUFFER_SIZE && !flush_trace(trace)) {
+        return NULL;
+    }
+    return trace->buffer + trace->used;
+}
+
+static size_t put_varint(uint8_t* out, uint64_t value) {
+    size_t length = 0;
+    while (value >= 0x80) {
+        out[length++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[length++] = (uint8_t)value;
+    return length;
+}
+
+/*
+ * Maps small negative numbers to small varints: 0, -1, 1, -2 ... become
+ * 0, 1, 2, 3 ...
+ */
+static uint64_t zigzag_encode(int64_t value) {
+    return ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+}
+
+static int64_t zigzag_decode(uint64_t value) {
+    return (int64_t)((value >> 1) ^ (~(value & 1) + 1));
+}
+
+static bool write_pool_record(TraceWriter* trace, uint8_t tag, const char* text, size_t length) {
+    uint8_t* out = reserve_record(trace, TRACE_MAX_RECORD + length);
+    if (!out) {
+        return false;
+    }
+    size_t size = 0;
+    out[size++] = tag;
+    size += put_varint(out + size, length);
+    memcpy(out + size, text, length);
+    trace->used += size + length;
+    return true;
+}
+
+static bool intern_reference(TraceWriter* trace, TracePool* pool, uint8_t tag, const char* text, uint32_t* id) {
+    const char* content = text ? text : "";
+    size_t length = strlen(content);
+    bool added = false;
+    if (!pool_intern(pool, content, length, id, &added)) {
+        trace->failed = true;
+        return false;
+    }
+    return !added || write_pool_record(trace, tag, content, length);
+}
+
+TraceWriter* open_trace(const char* path) {
+    if (!path) {
+        return NULL;
+    }
+    TraceWriter* trace = calloc(1, sizeof(TraceWriter));
+    if (!trace) {
+        return NULL;
+    }
+    trace->buffer = malloc(TRACE_BUFFER_SIZE);
+    trace->fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (!trace->buffer || trace->fd < 0) {
+        if (trace->fd >= 0) {
+            close(trace->fd);
+        }
+        free(trace->buffer);
+        free(trace);
+        return NULL;
+    }
+    memcpy(trace->buffer, TRACE_MAGIC, 4);
+    trace->buffer[4] = TRACE_VERSION;
+    memset(trace->buffer + 5, 0, TRACE_HEADER_SIZE - 5);
+    trace->used = TRACE_HEADER_SIZE;
+    return trace;
+}
+
+void trace_statement(TraceWriter* trace, TraceEventKind kind, int index, size_t offset,
+                     const char* name, int depth, const Value* value) {
+    if (!trace || !value || trace->failed) {
+        return;
+    }
+    uint32_t name_id;
+    uint32_t literal_id = 0;
+    if (!intern_reference(trace, &trace->names, TRACE_TAG_NAME, name, &name_id)) {
+        return;
+    }
+    if (value->type == TYPE_STRING &&
+        !intern_reference(trace, &trace->literals, TRACE_TAG_LITERAL, value->data.string_val, &literal_id)) {
+        return;
+    }
+    uint8_t* out = reserve_record(trace, TRACE_MAX_RECORD + 2 * 10);
+    if (!out) {
+        return;
+    }
+    uint64_t position = index < 0 ? 0 : (uint64_t)index;
+    uint64_t skipped = position >= trace->next_index ? position - trace->next_index : 0;
+    int64_t delta = (int64_t)offset - (int64_t)trace->last_offset;
+    size_t size = 0;
+    uint8_t tag = kind == TRACE_DECLARE ? TRACE_TAG_DECLARE
+                : kind == TRACE_APPEND ? TRACE_TAG_APPEND : TRACE_TAG_ASSIGN;
+    out[size++] = (uint8_t)(tag | value->type);
+    size += put_varint(out + size, skipped);
+    size += put_varint(out + size, zigzag_encode(delta));
+    size += put_varint(out + size, name_id);
+    size += put_varint(out + size, depth < 0 ? 0 : (uint64_t)depth);
+    switch (value->type) {
+        case TYPE_INT:
+            size += put_varint(out + size, zigzag_encode(value->data.int_val));
+            break;
+        case TYPE_CHAR:
+            size += put_varint(out + size, value->data.char_val);
+            break;
+        case TYPE_STRING:
+            size += put_varint(out + size, literal_id);
+            break;
+        case TYPE_INT_ARRAY:
+            size += put_varint(out + size, value->data.array_val ? value->data.array_val->length : 0);
+            break;
+    }
+    trace->used += size;
+    trace->next_index = position + 1;
+    trace->last_offset = offset;
+}
+
+void trace_end(TraceWriter* trace, int executed, bool failed) {
+    if (!trace) {
+        return;
+    }
+    uint8_t* out = reserve_record(trace, TRACE_MAX_RECORD);
+    if (!out) {
+        return;
+    }
+    size_t size = 0;
+    out[size++] = TRACE_TAG_END;
+    size += put_varint(out + size, executed < 0 ? 0 : (uint64_t)executed);
+    out[size++] = failed ? 1 : 0;
+    trace->used += size;
+}
+
+void trace_rollback(TraceWriter* trace, size_t undone) {
+    if (!trace) {
+        return;
+    }
+    uint8_t* out = reserve_record(trace, TRACE_MAX_RECORD);
+    if (!out) {
+        return;
+    }
+    size_t size = 0;
+    out[size++] = TRACE_TAG_ROLLBACK;
+    size += put_varint(out + size, undone);
+    trace->used += size;
+}
+
+bool close_trace(TraceWriter* trace) {
+    if (!trace) {
+        return false;
+    }
+    bool ok = !trace->failed && flush_trace(trace);
+    if (close(trace->fd) != 0) {
+        ok = false;
+    }
+    free_pool(&trace->names);
+    free_pool(&trace->literals);
+    free(trace->buffer);
+    free(trace);
+    return ok;
+}
+
+static bool fail_read(TraceReader* reader, const char* message) {
+    snprintf(reader->error_message, sizeof(reader->error_message),
+             "%s at byte %zu", message, reader->position);
+    reader->position = reader->size;
+    return false;
+}
+
+static bool read_varint(TraceReader* reader, uint64_t* value) {
+    uint64_t result = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (reader->position >= reader->size) {
+            return false;
+        }
+        uint8_t byte = reader->data[reader->position++];
+        result |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool read_pool_record(TraceReader* reader, TracePool* pool) {
+    uint64_t length;
+    if (!read_varint(reader, &length) || length > reader->size - reader->position) {
+        return fail_read(reader, "Truncated pool record");
+    }
+    if (!pool_append(pool, (const char*)reader->data + reader->position, (size_t)length)) {
+        return fail_read(reader, "Out of memory");
+    }
+    reader->position += (size_t)length;
+    return true;
+}
+
+static bool read_statement(TraceReader* reader, uint8_t tag, TraceEvent* event) {
+    uint64_t skipped;
+    uint64_t delta;
+    uint64_t name_id;
+    uint64_t payload = 0;
+    if (!read_varint(reader, &skipped) || !read_varint(reader, &delta) ||
+        !read_varint(reader, &name_id) || !read_varint(reader, &event->depth)) {
+        return fail_read(reader, "Truncated statement record");
+    }
+    if (name_id >= reader->names.count) {
+        return fail_read(reader, "Unknown name id");
+    }
+    int64_t offset_delta = zigzag_decode(delta);
+    if (offset_delta < 0 && (uint64_t)-offset_delta > reader->last_offset) {
+        return fail_read(reader, "Offset before the start of the source");
+    }
+    event->kind = (tag & 0xf0) == TRACE_TAG_DECLARE ? TRACE_DECLARE
+                : (tag & 0xf0) == TRACE_TAG_APPEND ? TRACE_APPEND : TRACE_ASSIGN;
+    event->index = reader->next_index + skipped;
+    event->offset = reader->last_offset + (uint64_t)offset_delta;
+    event->name = reader->names.entries[name_id].text;
+    event->name_id = (size_t)name_id;
+    event->value.pooled = false;
+    switch (tag & 0x0f) {
+        case TYPE_INT:
+            if (!read_varint(reader, &payload)) {
+                return fail_read(reader, "Truncated int value");
+            }
+            event->value.type = TYPE_INT;
+            event->value.data.int_val = (int)zigzag_decode(payload);
+            break;
+        case TYPE_CHAR:
+            if (!read_varint(reader, &payload) || payload > 0x10FFFF) {
+                return fail_read(reader, "Truncated char value");
+            }
+            event->value.type = TYPE_CHAR;
+            event->value.data.char_val = (uint32_t)payload;
+            break;
+        case TYPE_STRING:
+            if (!read_varint(reader, &payload) || payload >= reader->literals.count) {
+                return fail_read(reader, "Unknown literal id");
+            }
+            event->value.type = TYPE_STRING;
+            event->value.data.string_val = reader->literals.entries[payload].text;
+            break;
+        case TYPE_INT_ARRAY:
+            if (!read_varint(reader, &payload)) {
+                return fail_read(reader, "Truncated array length");
+            }
+            event->value.type = TYPE_INT_ARRAY;
+            event->value.data.array_val = NULL;
+            event->count = payload;
+            break;
+        default:
+            return fail_read(reader, "Unknown value type");
+    }
+    reader->next_index = event->index + 1;
+    reader->last_offset = event->offset;
+    return true;
+}
+
+TraceReader* open_trace_reader(const char* path) {
+    if (!path) {
+        return NULL;
+    }
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return NULL;
+    }
+    TraceReader* reader = calloc(1, sizeof(TraceReader));
+    if (!reader) {
+        fclose(file);
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    reader->data = size > 0 ? malloc((size_t)size) : NULL;
+    if (size < TRACE_HEADER_SIZE || !reader->data ||
+        fread(reader->data, 1, (size_t)size, file) != (size_t)size ||
+        memcmp(reader->data, TRACE_MAGIC, 4) != 0 || reader->data[4] != TRACE_VERSION) {
+        fclose(file);
+        free_trace_reader(reader);
+        return NULL;
+    }
+    fclose(file);
+    reader->size = (size_t)size;
+    reader->position = TRACE_HEADER_SIZE;
+    return reader;
+}
+
+bool trace_next(TraceReader* reader, TraceEvent* event) {
+    if (!reader || !event) {
+        return false;
+    }
+    while (reader->position < reader->size) {
+        uint8_t tag = reader->data[reader->position++];
+        switch (tag) {
+            case TRACE_TAG_NAME:
+                if (!read_pool_record(reader, &reader->names)) {
+                    return false;
+                }
+                break;
+            case TRACE_TAG_LITERAL:
+                if (!read_pool_record(reader, &reader->literals)) {
+                    return false;
+                }
+                break;
+            case TRACE_TAG_END: {
+                if (!read_varint(reader, &event->count) || reader->position >= reader->size) {
+                    return fail_read(reader, "Truncated end record");
+                }
+                event->kind = TRACE_END;
+                event->failed = reader->data[reader->position++] != 0;
+                reader->ended = true;
+                return true;
+            }
+            case TRACE_TAG_ROLLBACK:
+                if (!read_varint(reader, &event->count)) {
+                    return fail_read(reader, "Truncated rollback record");
+                }
+                event->kind = TRACE_ROLLBACK;
+                return true;
+            default:
+                if ((tag & 0xf0) != TRACE_TAG_DECLARE && (tag & 0xf0) != TRACE_TAG_ASSIGN &&
+                    (tag & 0xf0) != TRACE_TAG_APPEND) {
+                    reader->position--;
+                    return fail_read(reader, "Unknown record tag");
+                }
+                return read_statement(reader, tag, event);
+        }
+    }
+    if (!reader->ended && reader->error_message[0] == '\0') {
+        return fail_read(reader, "Missing end record (truncated trace)");
+    }
+    return false;
+}
+
+void free_trace_reader(TraceReader* reader) {
+    if (!reader) {
+        return;
+    }
+    free_pool(&reader->names);
+    free_pool(&reader->literals);
+    free(reader->data);
+    free(reader);
+}
@@ -11,7 +11,7 @@
  * - Initialization with type-specific default values
  * - Deep copying with proper string duplication
  * - Safe memory deallocation
- * - Debug-friendly value printing
+ * - Debug-friendly value printing to stdout or any caller-owned stream
  * 
  * ============================================================================
  */
@@ -21,13 +21,22 @@
 #include <stdlib.h>
 #include <string.h>
 #include "types.h"
+#include "allocator.h"
+#include "string_heap.h"
+#include "utf8.h"
+#include "int_array.h"
+
+#define PRINTED_ARRAY_ITEMS 8
+
+static void fprint_int_array(FILE* stream, const IntArray* array);
 
 Value* init_value(ValueType type) {
-    Value* val = malloc(sizeof(Value));
+    Value* val = mem_alloc(sizeof(Value));
     if (!val) {
         return NULL;
     }
     val->type = type;
+    val->pooled = false;
     switch (type) {
         case TYPE_INT:
             val->data.int_val = 0;
@@ -38,6 +47,9 @@ Value* init_value(ValueType type) {
         case TYPE_STRING:
             val->data.string_val = NULL;
             break;
+        case TYPE_INT_ARRAY:
+            val->data.array_val = NULL;
+            break;
     }
     return val;
 }
@@ -47,20 +59,27 @@ void free_value(Value* val) {
         return;
     }
     if (val->type == TYPE_STRING && val->data.string_val) {
-        free(val->data.string_val);
+        if (val->pooled) {
+            string_heap_release(val->data.string_val);
+        } else {
+            mem_free(val->data.string_val);
+        }
+    } else if (val->type == TYPE_INT_ARRAY) {
+        free_int_array(val->data.array_val);
     }
-    free(val);
+    mem_free(val);
 }
 
 Value* copy_value(Value* src) {
     if (!src) {
         return NULL;
     }
-    Value* copy = malloc(sizeof(Value));
+    Value* copy = mem_alloc(sizeof(Value));
     if (!copy) {
         return NULL;
     }
     copy->type = src->type;
+    copy->pooled = false;
     switch (src->type) {
         case TYPE_INT:
             copy->data.int_val = src->data.int_val;
@@ -70,37 +89,78 @@ Value* copy_value(Value* src) {
             break;
         case TYPE_STRING:
             if (src->data.string_val) {
-                copy->data.string_val = strdup(src->data.string_val);
+                copy->data.string_val = mem_strdup(src->data.string_val);
                 if (!copy->data.string_val) {
-                    free(copy);
+                    mem_free(copy);
                     return NULL;
                 }
             } else {
                 copy->data.string_val = NULL;
             }
             break;
+        case TYPE_INT_ARRAY:
+            copy->data.array_val = NULL;
+            if (src->data.array_val) {
+                copy->data.array_val = copy_int_array(src->data.array_val);
+                if (!copy->data.array_val) {
+                    mem_free(copy);
+                    return NULL;
+                }
+            }
+            break;
     }
     return copy;
 }
 
 void print_value(Value* val) {
+    fprint_value(stdout, val);
+}
+
+void print_code_point(FILE* stream, uint32_t code_point) {
+    if (code_point < 0x80) {
+        fputc((int)code_point, stream);
+        return;
+    }
+    char bytes[UTF8_MAX_SEQUENCE];
+    fwrite(bytes, 1, utf8_encode(code_point, bytes), stream);
+}
+
+/*
+ * Prints an array as `int[N] {a, b, ...}`, showing at most its first
+ * PRINTED_ARRAY_ITEMS elements so that echo lines stay short.
+ */
+static void fprint_int_array(FILE* stream, const IntArray* array) {
+    size_t length = array ? array->length : 0;
+    fprintf(stream, "int[%zu] {", length);
+    for (size_t i = 0; i < length && i < PRINTED_ARRAY_ITEMS; i++) {
+        fprintf(stream, i ? ", %d" : "%d", array->items[i]);
+    }
+    fprintf(stream, length > PRINTED_ARRAY_ITEMS ? ", ...}" : "}");
+}
+
+void fprint_value(FILE* stream, Value* val) {
     if (!val) {
-        printf("NULL");
+        fprintf(stream, "NULL");
         return;
     }
     switch (val->type) {
         case TYPE_INT:
-            printf("%d", val->data.int_val);
+            fprintf(stream, "%d", val->data.int_val);
             break;
         case TYPE_CHAR:
-            printf("'%c'", val->data.char_val);
+            fputc('\'', stream);
+            print_code_point(stream, val->data.char_val);
+            fputc('\'', stream);
             break;
         case TYPE_STRING:
             if (val->data.string_val) {
-                printf("\"%s\"", val->data.string_val);
+                fprintf(stream, "\"%s\"", val->data.string_val);
             } else {
-                printf("\"\"");
+                fprintf(stream, "\"\"");
             }
             break;
+        case TYPE_INT_ARRAY:
+            fprint_int_array(stream, val->data.array_val);
+            break;
     }
 }
@@ -0,0 +1,98 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Undo Log Implementation
+ * ============================================================================
+ * 
+ * Implementation of the undo log used for transactional execution. Entries
+ * are appended in write order and replayed backwards on rollback, which
+ * restores retained Value pointers and unlinks created variables.
+ * 
+ * Because variables are always prepended to the environment list and the
+ * log is replayed in reverse, every created variable being undone is the
+ * current head of the list, so unlinking it is O(1).
+ * 
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "undo_log.h"
+#include "allocator.h"
+
+UndoLog* create_undo_log(void) {
+    UndoLog* log = mem_alloc(sizeof(UndoLog));
+    if (!log) {
+        return NULL;
+    }
+    log->entries = NULL;
+    log->count = 0;
+    log->capacity = 0;
+    return log;
+}
+
+bool undo_log_record(UndoLog* log, UndoKind kind, Variable* variable, Value* old_value) {
+    if (!log || !variable) {
+        return false;
+    }
+    if (log->count == log->capacity) {
+        size_t capacity = log->capacity ? log->capacity * 2 : 64;
+        UndoEntry* entries = mem_realloc(log->entries, capacity * sizeof(UndoEntry));
+        if (!entries) {
+            return false;
+        }
+        log->entries = entries;
+        log->capacity = capacity;
+    }
+    UndoEntry* entry = &log->entries[log->count++];
+    entry->kind = kind;
+    entry->variable = variable;
+    entry->old_value = old_value;
+    return true;
+}
+
+size_t undo_log_rollback(UndoLog* log, Environment* env) {
+    if (!log || !env) {
+        return 0;
+    }
+    size_t undone = log->count;
+    while (log->count > 0) {
+        UndoEntry* entry = &log->entries[--log->count];
+        if (entry->kind == UNDO_OVERWRITTEN) {
+            free_value(entry->variable->value);
+            entry->variable->value = entry->old_value;
+            continue;
+        }
+        VariableNode* head = env->variables;
+        if (!head || head->variable != entry->variable) {
+            continue;
+        }
+        env->variables = head->next;
+        env->count--;
+        free_value(head->variable->value);
+        mem_free(head->variable);
+        mem_free(head);
+    }
+    return undone;
+}
+
+void undo_log_commit(UndoLog* log) {
+    if (!log) {
+        return;
+    }
+    for (size_t i = 0; i < log->count; i++) {
+        if (log->entries[i].kind == UNDO_OVERWRITTEN) {
+            free_value(log->entries[i].old_value);
+        }
+    }
+    log->count = 0;
+}
+
+void free_undo_log(UndoLog* log) {
+    if (!log) {
+        return;
+    }
+    undo_log_commit(log);
+    mem_free(log->entries);
+    mem_free(log);
+}
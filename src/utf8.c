@@ -0,0 +1,133 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - UTF-8 Implementation
+ * ============================================================================
+ * 
+ * Implementation of UTF-8 validation, decoding and encoding.
+ * 
+ * utf8_validate() alternates between skipping ASCII and decoding one
+ * multi-byte sequence: the SSE2 movemask of 16 bytes both tells whether
+ * they are all ASCII and, when not, where the first non-ASCII byte is, so
+ * a non-ASCII character only slows down its own neighbourhood.
+ * 
+ * ============================================================================
+ */
+
+#include <string.h>
+#include "utf8.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+static size_t skip_ascii(const unsigned char* bytes, size_t position, size_t length);
+
+/*
+ * Returns the first position at or after `position` that holds a byte
+ * with the high bit set, or `length`.
+ */
+static size_t skip_ascii(const unsigned char* bytes, size_t position, size_t length) {
+#if defined(__SSE2__)
+    for (; position + 16 <= length; position += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(bytes + position));
+        unsigned mask = (unsigned)_mm_movemask_epi8(chunk);
+        if (mask) {
+            return position + (size_t)__builtin_ctz(mask);
+        }
+    }
+#else
+    for (; position + 8 <= length; position += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + position, sizeof(word));
+        if (word & 0x8080808080808080ULL) {
+            break;
+        }
+    }
+#endif
+    while (position < length && bytes[position] < 0x80) {
+        position++;
+    }
+    return position;
+}
+
+size_t utf8_validate(const char* text, size_t length) {
+    const unsigned char* bytes = (const unsigned char*)text;
+    size_t position = skip_ascii(bytes, 0, length);
+    while (position < length) {
+        size_t size = utf8_decode(text + position, length - position, NULL);
+        if (size == 0) {
+            return position;
+        }
+        position = skip_ascii(bytes, position + size, length);
+    }
+    return length;
+}
+
+size_t utf8_decode(const char* text, size_t length, uint32_t* code_point) {
+    const unsigned char* bytes = (const unsigned char*)text;
+    if (length == 0) {
+        return 0;
+    }
+    unsigned char lead = bytes[0];
+    size_t size;
+    uint32_t value;
+    uint32_t minimum;
+    if (lead < 0x80) {
+        size = 1;
+        value = lead;
+        minimum = 0;
+    } else if (lead >= 0xC2 && lead <= 0xDF) {
+        size = 2;
+        value = lead & 0x1F;
+        minimum = 0x80;
+    } else if (lead >= 0xE0 && lead <= 0xEF) {
+        size = 3;
+        value = lead & 0x0F;
+        minimum = 0x800;
+    } else if (lead >= 0xF0 && lead <= 0xF4) {
+        size = 4;
+        value = lead & 0x07;
+        minimum = 0x10000;
+    } else {
+        return 0;
+    }
+    if (size > length) {
+        return 0;
+    }
+    for (size_t i = 1; i < size; i++) {
+        if ((bytes[i] & 0xC0) != 0x80) {
+            return 0;
+        }
+        value = (value << 6) | (bytes[i] & 0x3F);
+    }
+    if (value < minimum || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+        return 0;
+    }
+    if (code_point) {
+        *code_point = value;
+    }
+    return size;
+}
+
+size_t utf8_encode(uint32_t code_point, char* out) {
+    if (code_point < 0x80) {
+        out[0] = (char)code_point;
+        return 1;
+    }
+    if (code_point < 0x800) {
+        out[0] = (char)(0xC0 | (code_point >> 6));
+        out[1] = (char)(0x80 | (code_point & 0x3F));
+        return 2;
+    }
+    if (code_point < 0x10000) {
+        out[0] = (char)(0xE0 | (code_point >> 12));
+        out[1] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+        out[2] = (char)(0x80 | (code_point & 0x3F));
+        return 3;
+    }
+    out[0] = (char)(0xF0 | (code_point >> 18));
+    out[1] = (char)(0x80 | ((code_point >> 12) & 0x3F));
+    out[2] = (char)(0x80 | ((code_point >> 6) & 0x3F));
+    out[3] = (char)(0x80 | (code_point & 0x3F));
+    return 4;
+}
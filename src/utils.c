@@ -9,7 +9,8 @@
  * 
  * File operations support complete source file reading with proper memory
  * management. Error reporting provides formatted output with position
- * information for debugging and user feedback.
+ * information for debugging and user feedback; each report is emitted with
+ * a single stdio call so concurrent interpreters never interleave a line.
  * 
  * ============================================================================
  */
@@ -17,6 +18,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "utils.h"
 
 char* read_file(char* filename) {
@@ -53,15 +55,19 @@ char* read_file(char* filename) {
 }
 
 void error(char* message, int line, int col) {
-    if (!message) {
+    report_error(stderr, message, line, col);
+}
+
+void report_error(FILE* stream, char* message, int line, int col) {
+    if (!message || !stream) {
         return;
     }
     if (line > 0 && col > 0) {
-        fprintf(stderr, "Error at line %d, column %d: %s\n", line, col, message);
+        fprintf(stream, "Error at line %d, column %d: %s\n", line, col, message);
     } else if (line > 0) {
-        fprintf(stderr, "Error at line %d: %s\n", line, message);
+        fprintf(stream, "Error at line %d: %s\n", line, message);
     } else {
-        fprintf(stderr, "Error: %s\n", message);
+        fprintf(stream, "Error: %s\n", message);
     }
 }
 
@@ -91,20 +97,62 @@ void print_usage(char* program_name) {
     if (!program_name) {
         program_name = "pong-interpreter";
     }
-    printf("Usage: %s <filename.pong>\n", program_name);
+    printf("Usage: %s [options] <filename.pong>\n", program_name);
     printf("\n");
     printf("Pong Language Interpreter - Execute .pong source files\n");
     printf("\n");
     printf("Arguments:\n");
-    printf("  filename.pong    Path to the .pong source file to execute\n");
+    printf("  filename.pong    Path to the .pong source file to execute; .pong.gz and\n");
+    printf("                   .pong.zst files are decompressed while they execute\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --transactional  Roll the environment back if the run fails\n");
+    printf("  --token-buffer   Tokenize the whole file into a packed buffer first\n");
+    printf("  --watch          Re-execute incrementally whenever the file changes\n");
+    printf("  --pipeline       Read, lex, parse and execute on separate threads\n");
+    printf("  --profile-lines  Report lex/parse/execute time and bytes per source line\n");
+    printf("  --heap-stats     Report string heap fragmentation and RSS, before and after compaction\n");
+    printf("  --trace=FILE     Write a binary trace of every executed statement (read with pong-trace)\n");
+    printf("  --emit-c[=FILE]  Translate the script to a standalone C program (stdout by default)\n");
+    printf("  --compile[=FILE] Compile the script to a native executable with cc ($CC)\n");
+    printf("  --parallel[=N]   Execute on N threads partitioned by variable (default: one per CPU)\n");
+    printf("  --engine=ENGINE  Execute with 'interp' (default) or the experimental x86-64 'jit'\n");
+    printf("  --query=NAMES    Print the final values of the comma-separated variables without\n");
+    printf("                   executing the script when its statements allow it\n");
+    printf("  --perf-counters[=FILE]\n");
+    printf("                   Report CPU counters for the read, lex, parse and execute\n");
+    printf("                   phases as JSON (stderr by default)\n");
+    printf("  --link           Run several files in order as one program, parsing them in parallel\n");
     printf("\n");
     printf("Examples:\n");
     printf("  %s hello.pong\n", program_name);
     printf("  %s examples/variables.pong\n", program_name);
+    printf("  %s generated.pong.gz\n", program_name);
+    printf("  %s --query=total,label generated.pong\n", program_name);
+    printf("  %s defs.pong main.pong --link\n", program_name);
     printf("\n");
     printf("Supported language features:\n");
     printf("  - Variable declarations: int x = 5;\n");
     printf("  - Variable assignments: x = 10;\n");
     printf("  - Data types: int, char, string\n");
+    printf("  - Block scopes: { int y = 1; y = 2; }\n");
+    printf("  - Counted loops: repeat 3 { x = 1; }\n");
+    printf("  - Int arrays: int[4] v = 0; v[1] = 5; fill(v, 7); copy(w, v); x = sum(v);\n");
+    printf("  - String concatenation: s = s + \"!\"; line = a + \" \" + b;\n");
     printf("\n");
 }
+
+size_t resident_set_bytes(void) {
+    FILE* statm = fopen("/proc/self/statm", "r");
+    if (!statm) {
+        return 0;
+    }
+    unsigned long size = 0;
+    unsigned long resident = 0;
+    int fields = fscanf(statm, "%lu %lu", &size, &resident);
+    fclose(statm);
+    if (fields != 2) {
+        return 0;
+    }
+    return (size_t)resident * (size_t)sysconf(_SC_PAGESIZE);
+}
@@ -0,0 +1,260 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Watch Mode Implementation
+ * ============================================================================
+ * 
+ * Implementation of incremental re-execution for `--watch`. A statement is
+ * unaffected by an edit when the next statement starts at or before the
+ * first changed byte, since statements always end with `;` or `}` and
+ * cannot merge with what follows. The boundary list therefore gives the
+ * resumption point directly; an extra boundary recorded at end of input
+ * makes appends at the end of the file resume there.
+ * 
+ * Checkpoints are full clones of the global environment, taken before the
+ * statement they are indexed by. Block frames never outlive their top-level
+ * statement, so the global environment is the whole state at a boundary.
+ * 
+ * ============================================================================
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "watch.h"
+#include "utils.h"
+
+typedef struct {
+    size_t statement;
+    int executed;
+    Environment* env;
+} Checkpoint;
+
+typedef struct {
+    Interpreter* interp;
+    FILE* output;
+    FILE* silent;
+    size_t* boundaries;
+    size_t boundary_count;
+    size_t boundary_capacity;
+    Checkpoint checkpoints[WATCH_MAX_CHECKPOINTS];
+    size_t checkpoint_count;
+    size_t checkpoint_interval;
+} WatchSession;
+
+static bool record_boundary(WatchSession* session, size_t index, Token* token);
+static bool take_checkpoint(WatchSession* session, size_t statement);
+static void thin_checkpoints(WatchSession* session);
+static void execute_from(WatchSession* session, char* source, size_t checkpoint, size_t resume);
+static size_t find_resume_statement(WatchSession* session, size_t first_change);
+static size_t common_prefix(const char* a, const char* b);
+static bool file_changed(char* filename, struct stat* last);
+static double now_ms(void);
+
+static bool record_boundary(WatchSession* session, size_t index, Token* token) {
+    if (index >= session->boundary_capacity) {
+        size_t capacity = session->boundary_capacity ? session->boundary_capacity * 2 : 1024;
+        size_t* boundaries = realloc(session->boundaries, capacity * sizeof(size_t));
+        if (!boundaries) {
+            return false;
+        }
+        session->boundaries = boundaries;
+        session->boundary_capacity = capacity;
+    }
+    session->boundaries[index] = token->offset;
+    session->boundary_count = index + 1;
+    return true;
+}
+
+static bool take_checkpoint(WatchSession* session, size_t statement) {
+    if (session->checkpoint_count == WATCH_MAX_CHECKPOINTS) {
+        thin_checkpoints(session);
+        if (statement % session->checkpoint_interval != 0) {
+            return true;
+        }
+    }
+    Environment* env = clone_env(session->interp->global_env);
+    if (!env) {
+        return false;
+    }
+    Checkpoint* checkpoint = &session->checkpoints[session->checkpoint_count++];
+    checkpoint->statement = statement;
+    checkpoint->executed = session->interp->executed_statements;
+    checkpoint->env = env;
+    return true;
+}
+
+static void thin_checkpoints(WatchSession* session) {
+    size_t kept = 0;
+    session->checkpoint_interval *= 2;
+    for (size_t i = 0; i < session->checkpoint_count; i++) {
+        Checkpoint* checkpoint = &session->checkpoints[i];
+        if (checkpoint->statement % session->checkpoint_interval == 0) {
+            session->checkpoints[kept++] = *checkpoint;
+        } else {
+            free_env(checkpoint->env);
+        }
+    }
+    session->checkpoint_count = kept;
+}
+
+static void execute_from(WatchSession* session, char* source, size_t checkpoint, size_t resume) {
+    Interpreter* interp = session->interp;
+    Checkpoint* start = &session->checkpoints[checkpoint];
+    size_t origin = start->statement > 0 ? session->boundaries[start->statement] : 0;
+    for (size_t i = checkpoint + 1; i < session->checkpoint_count; i++) {
+        free_env(session->checkpoints[i].env);
+    }
+    session->checkpoint_count = checkpoint + 1;
+    session->boundary_count = start->statement;
+
+    Environment* restored = clone_env(start->env);
+    if (!restored) {
+        fprintf(session->output, "Watch error: failed to restore checkpoint\n");
+        return;
+    }
+    free_env(interp->global_env);
+    interp->global_env = restored;
+    interp->executed_statements = start->executed;
+    interp->has_error = false;
+    interp->error_message[0] = '\0';
+
+    Execution exec;
+    size_t index = start->statement;
+    interp->output = index < resume ? session->silent : session->output;
+    if (!begin_execution(interp, &exec, source, origin)) {
+        interp->output = session->output;
+        fprintf(session->output, "Watch error: %s\n", interp->error_message);
+        return;
+    }
+    while (true) {
+        if (index == resume) {
+            interp->output = session->output;
+        }
+        if (!record_boundary(session, index, exec.parser->current_token)) {
+            break;
+        }
+        if (index > start->statement && index % session->checkpoint_interval == 0 &&
+            !take_checkpoint(session, index)) {
+            break;
+        }
+        if (!execute_next(interp, &exec)) {
+            break;
+        }
+        index++;
+    }
+    interp->output = session->output;
+    end_execution(interp, &exec);
+}
+
+static size_t find_resume_statement(WatchSession* session, size_t first_change) {
+    size_t low = 0;
+    size_t high = session->boundary_count;
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (session->boundaries[mid] <= first_change) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low > 0 ? low - 1 : 0;
+}
+
+static size_t common_prefix(const char* a, const char* b) {
+    size_t length = 0;
+    while (a[length] && a[length] == b[length]) {
+        length++;
+    }
+    return length;
+}
+
+static bool file_changed(char* filename, struct stat* last) {
+    struct stat current;
+    if (stat(filename, &current) != 0) {
+        return false;
+    }
+    bool changed = current.st_size != last->st_size ||
+                   current.st_mtim.tv_sec != last->st_mtim.tv_sec ||
+                   current.st_mtim.tv_nsec != last->st_mtim.tv_nsec;
+    *last = current;
+    return changed;
+}
+
+static double now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec / 1e6;
+}
+
+int run_watch(Interpreter* interp, char* filename, char** source) {
+    if (!interp || !filename || !source || !*source) {
+        return EXIT_FAILURE;
+    }
+    const Allocator* previous = use_allocator(interp->allocator);
+    WatchSession session;
+    memset(&session, 0, sizeof(session));
+    session.interp = interp;
+    session.output = interp->output;
+    session.silent = fopen("/dev/null", "w");
+    session.checkpoint_interval = WATCH_INITIAL_INTERVAL;
+    interp->transactional = false;
+    if (!session.silent || !take_checkpoint(&session, 0)) {
+        fprintf(stderr, "Error: Failed to initialize watch mode\n");
+        if (session.silent) {
+            fclose(session.silent);
+        }
+        use_allocator(previous);
+        return EXIT_FAILURE;
+    }
+    struct stat last;
+    stat(filename, &last);
+
+    fprintf(session.output, "=== PONG INTERPRETER EXECUTION ===\n");
+    execute_from(&session, *source, 0, 0);
+    fprintf(session.output, "=== EXECUTION COMPLETE ===\n");
+    fprintf(session.output, "Executed %d statements\n", interp->executed_statements);
+    fprintf(session.output, "\nWatching %s for changes (Ctrl+C to stop)\n", filename);
+    fflush(session.output);
+
+    struct timespec pause = {0, WATCH_POLL_INTERVAL_MS * 1000000L};
+    while (true) {
+        nanosleep(&pause, NULL);
+        if (!file_changed(filename, &last)) {
+            continue;
+        }
+        char* updated = read_file(filename);
+        if (!updated) {
+            continue;
+        }
+        size_t first_change = common_prefix(*source, updated);
+        if ((*source)[first_change] == '\0' && updated[first_change] == '\0') {
+            free(updated);
+            continue;
+        }
+        free(*source);
+        *source = updated;
+        double started = now_ms();
+        size_t resume = find_resume_statement(&session, first_change);
+        size_t checkpoint = session.checkpoint_count - 1;
+        while (checkpoint > 0 && session.checkpoints[checkpoint].statement > resume) {
+            checkpoint--;
+        }
+        size_t offset = resume < session.boundary_count ? session.boundaries[resume] : 0;
+        LineIndex* lines = create_line_index(*source);
+        int line = line_index_line(lines, offset);
+        free_line_index(lines);
+        fprintf(session.output, "\n=== WATCH: %s changed, resuming at statement %zu (line %d) ===\n",
+                filename, resume + 1, line);
+        execute_from(&session, *source, checkpoint, resume);
+        fprintf(session.output, "=== EXECUTION COMPLETE ===\n");
+        fprintf(session.output, "Executed %d statements\n", interp->executed_statements);
+        fprintf(session.output, "Re-executed in %.2f ms (replayed from statement %zu)\n",
+                now_ms() - started, session.checkpoints[checkpoint].statement + 1);
+        fflush(session.output);
+    }
+    use_allocator(previous);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,260 @@
+/**
+ * ============================================================================
+ * PONG LANGUAGE INTERPRETER - Trace Decoder Tool
+ * ============================================================================
+ *
+ * pong-trace decodes the binary journal written by `--trace=file.ptrace`.
+ *
+ * Usage:
+ *   pong-trace [options] file.ptrace
+ *
+ * Options:
+ *   --var=NAME     Only show records for the variable NAME
+ *   --from=N       Only show statements with index >= N
+ *   --to=N         Only show statements with index <= N
+ *   --declarations Only show declarations
+ *   --assignments  Only show assignments
+ *   --summary      Print totals and the most written variables instead
+ *
+ * Each listed record is one line: statement index, source offset, kind,
+ * scope depth and the value written, printed like the interpreter's own
+ * output. End and rollback records are always listed.
+ *
+ * ============================================================================
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "trace.h"
+
+#define TOP_VARIABLES 10
+
+typedef struct {
+    const char* path;
+    const char* variable;
+    unsigned long long from;
+    unsigned long long to;
+    bool declarations;
+    bool assignments;
+    bool summary;
+} TraceOptions;
+
+typedef struct {
+    unsigned long long statements;
+    unsigned long long declarations;
+    unsigned long long assignments;
+    unsigned long long by_type[TYPE_INT_ARRAY + 1];
+    unsigned long long* writes;
+    size_t variable_count;
+    size_t variable_capacity;
+    const char** names;
+} TraceSummary;
+
+static bool parse_trace_options(int argc, char** argv, TraceOptions* options);
+static void print_trace_usage(const char* program_name);
+static bool event_selected(const TraceOptions* options, const TraceEvent* event);
+static void print_event(const TraceEvent* event);
+static bool count_event(TraceSummary* summary, const TraceEvent* event);
+static void print_summary(const TraceSummary* summary, const TraceReader* reader);
+
+static bool parse_trace_options(int argc, char** argv, TraceOptions* options) {
+    memset(options, 0, sizeof(*options));
+    options->to = ~0ULL;
+    for (int i = 1; i < argc; i++) {
+        if (strncmp(argv[i], "--var=", 6) == 0) {
+            options->variable = argv[i] + 6;
+        } else if (strncmp(argv[i], "--from=", 7) == 0) {
+            options->from = strtoull(argv[i] + 7, NULL, 10);
+        } else if (strncmp(argv[i], "--to=", 5) == 0) {
+            options->to = strtoull(argv[i] + 5, NULL, 10);
+        } else if (strcmp(argv[i], "--declarations") == 0) {
+            options->declarations = true;
+        } else if (strcmp(argv[i], "--assignments") == 0) {
+            options->assignments = true;
+        } else if (strcmp(argv[i], "--summary") == 0) {
+            options->summary = true;
+        } else if (strncmp(argv[i], "--", 2) == 0 || options->path) {
+            return false;
+        } else {
+            options->path = argv[i];
+        }
+    }
+    return options->path != NULL;
+}
+
+static void print_trace_usage(const char* program_name) {
+    printf("Usage: %s [options] <file.ptrace>\n", program_name);
+    printf("\n");
+    printf("Decode a binary execution trace written by pong-interpreter --trace=FILE\n");
+    printf("\n");
+    printf("Options:\n");
+    printf("  --var=NAME       Only show records for the variable NAME\n");
+    printf("  --from=N         Only show statements with index >= N\n");
+    printf("  --to=N           Only show statements with index <= N\n");
+    printf("  --declarations   Only show declarations\n");
+    printf("  --assignments    Only show assignments\n");
+    printf("  --summary        Print totals and the most written variables\n");
+}
+
+static bool event_selected(const TraceOptions* options, const TraceEvent* event) {
+    if (event->kind == TRACE_END || event->kind == TRACE_ROLLBACK) {
+        return true;
+    }
+    if (event->index < options->from || event->index > options->to) {
+        return false;
+    }
+    if (options->declarations != options->assignments &&
+        (event->kind == TRACE_DECLARE) != options->declarations) {
+        return false;
+    }
+    return !options->variable || strcmp(options->variable, event->name) == 0;
+}
+
+static void print_event(const TraceEvent* event) {
+    switch (event->kind) {
+        case TRACE_DECLARE:
+        case TRACE_ASSIGN:
+        case TRACE_APPEND: {
+            Value value = event->value;
+            printf("#%-8llu @%-8llu %-7s %s %s ", (unsigned long long)event->index,
+                   (unsigned long long)event->offset,
+                   event->kind == TRACE_DECLARE ? "declare"
+                       : event->kind == TRACE_APPEND ? "append" : "assign",
+                   event->name, event->kind == TRACE_APPEND ? "+=" : "=");
+            if (value.type == TYPE_INT_ARRAY) {
+                printf("int[%llu]", (unsigned long long)event->count);
+            } else {
+                fprint_value(stdout, &value);
+            }
+            if (event->depth > 0) {
+                printf("  (depth %llu)", (unsigned long long)event->depth);
+            }
+            putchar('\n');
+            break;
+        }
+        case TRACE_ROLLBACK:
+            printf("rollback: %llu changes undone\n", (unsigned long long)event->count);
+            break;
+        case TRACE_END:
+            printf("end: %llu statements executed, %s\n", (unsigned long long)event->count,
+                   event->failed ? "failed" : "completed");
+            break;
+    }
+}
+
+static bool count_event(TraceSummary* summary, const TraceEvent* event) {
+    if (event->kind != TRACE_DECLARE && event->kind != TRACE_ASSIGN &&
+        event->kind != TRACE_APPEND) {
+        return true;
+    }
+    summary->statements++;
+    if (event->kind == TRACE_DECLARE) {
+        summary->declarations++;
+    } else {
+        summary->assignments++;
+    }
+    if (event->value.type <= TYPE_INT_ARRAY) {
+        summary->by_type[event->value.type]++;
+    }
+    if (event->name_id >= summary->variable_capacity) {
+        size_t capacity = summary->variable_capacity ? summary->variable_capacity : 64;
+        while (capacity <= event->name_id) {
+            capacity *= 2;
+        }
+        unsigned long long* writes = realloc(summary->writes, capacity * sizeof(*writes));
+        if (!writes) {
+            return false;
+        }
+        summary->writes = writes;
+        const char** names = realloc(summary->names, capacity * sizeof(*names));
+        if (!names) {
+            return false;
+        }
+        summary->names = names;
+        memset(writes + summary->variable_capacity, 0,
+               (capacity - summary->variable_capacity) * sizeof(*writes));
+        summary->variable_capacity = capacity;
+    }
+    if (event->name_id >= summary->variable_count) {
+        summary->variable_count = event->name_id + 1;
+    }
+    summary->writes[event->name_id]++;
+    summary->names[event->name_id] = event->name;
+    return true;
+}
+
+static void print_summary(const TraceSummary* summary, const TraceReader* reader) {
+    printf("Trace: %zu bytes, %llu statements", reader->size, summary->statements);
+    if (summary->statements > 0) {
+        printf(" (%.2f bytes/statement)", (double)reader->size / (double)summary->statements);
+    }
+    printf("\n");
+    printf("  declarations: %llu\n", summary->declarations);
+    printf("  assignments:  %llu\n", summary->assignments);
+    printf("  int: %llu  char: %llu  string: %llu  int[]: %llu\n",
+           summary->by_type[TYPE_INT], summary->by_type[TYPE_CHAR], summary->by_type[TYPE_STRING],
+           summary->by_type[TYPE_INT_ARRAY]);
+    printf("  variables: %zu  string literals: %zu\n", reader->names.count, reader->literals.count);
+    if (summary->statements == 0) {
+        return;
+    }
+    printf("\nMost written variables:\n");
+    bool* shown = calloc(summary->variable_count, sizeof(bool));
+    if (!shown) {
+        return;
+    }
+    for (int rank = 0; rank < TOP_VARIABLES; rank++) {
+        size_t best = summary->variable_count;
+        for (size_t id = 0; id < summary->variable_count; id++) {
+            if (!shown[id] && summary->writes[id] > 0 &&
+                (best == summary->variable_count || summary->writes[id] > summary->writes[best])) {
+                best = id;
+            }
+        }
+        if (best == summary->variable_count) {
+            break;
+        }
+        shown[best] = true;
+        printf("  %-24s %llu\n", summary->names[best], summary->writes[best]);
+    }
+    free(shown);
+}
+
+int main(int argc, char** argv) {
+    TraceOptions options;
+    if (!parse_trace_options(argc, argv, &options)) {
+        print_trace_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+    TraceReader* reader = open_trace_reader(options.path);
+    if (!reader) {
+        fprintf(stderr, "Error: Cannot read trace file '%s'\n", options.path);
+        return EXIT_FAILURE;
+    }
+    TraceSummary summary;
+    memset(&summary, 0, sizeof(summary));
+    TraceEvent event;
+    bool ok = true;
+    while (ok && trace_next(reader, &event)) {
+        if (!event_selected(&options, &event)) {
+            continue;
+        }
+        if (options.summary) {
+            ok = count_event(&summary, &event);
+        } else {
+            print_event(&event);
+        }
+    }
+    if (reader->error_message[0] != '\0') {
+        fprintf(stderr, "Error: %s in '%s'\n", reader->error_message, options.path);
+        ok = false;
+    }
+    if (options.summary) {
+        print_summary(&summary, reader);
+    }
+    free(summary.writes);
+    free(summary.names);
+    free_trace_reader(reader);
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}